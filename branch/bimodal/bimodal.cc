@@ -12,7 +12,7 @@ constexpr std::size_t COUNTER_BITS = 2;
 std::map<O3_CPU*, std::array<champsim::msl::fwcounter<COUNTER_BITS>, BIMODAL_TABLE_SIZE>> bimodal_table;
 } // namespace
 
-void O3_CPU::initialize_branch_predictor() {}
+void O3_CPU::initialize_branch_predictor() { ::bimodal_table[this] = {}; }
 
 uint8_t O3_CPU::predict_branch(uint64_t ip)
 {
@@ -26,7 +26,11 @@ std::size_t gs_table_hash(uint64_t ip, std::bitset<GLOBAL_HISTORY_LENGTH> bh_vec
 }
 } // namespace
 
-void O3_CPU::initialize_branch_predictor() {}
+void O3_CPU::initialize_branch_predictor()
+{
+  ::branch_history_vector[this] = {};
+  ::gs_history_table[this] = {};
+}
 
 uint8_t O3_CPU::predict_branch(uint64_t ip)
 {
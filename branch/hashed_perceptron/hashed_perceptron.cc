@@ -45,6 +45,7 @@ sources for you to plagiarize.
 
 */
 
+#include <map>
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -83,50 +84,46 @@ namespace
 
 inline constexpr int history_lengths[NTABLES] = {0, 3, 4, 6, 8, 10, 14, 19, 26, 36, 49, 67, 91, 125, 170, MAXHIST};
 
-// tables of 8-bit weights
+struct predictor_state {
+  // tables of 8-bit weights
 
-int tables[NUM_CPUS][NTABLES][TABLE_SIZE];
+  int tables[NTABLES][TABLE_SIZE] = {};
 
-// words that store the global history
+  // words that store the global history
 
-unsigned int ghist_words[NUM_CPUS][NGHIST_WORDS];
+  unsigned int ghist_words[NGHIST_WORDS] = {};
 
-// remember the indices into the tables from prediction to update
+  // remember the indices into the tables from prediction to update
 
-uint64_t indices[NUM_CPUS][NTABLES];
+  uint64_t indices[NTABLES] = {};
 
-// initialize theta to something reasonable,
-int theta[NUM_CPUS],
+  // initialize theta to something reasonable,
+  int theta = 10,
 
-    // initialize counter for threshold setting algorithm
-    tc[NUM_CPUS],
+      // initialize counter for threshold setting algorithm
+      tc = 0,
 
-    // perceptron sum
-    yout[NUM_CPUS];
+      // perceptron sum
+      yout = 0;
+};
+
+std::map<O3_CPU*, predictor_state> predictors;
 } // namespace
 
 void O3_CPU::initialize_branch_predictor()
 {
-  // zero out the weights tables
-
-  memset(::tables, 0, sizeof(::tables));
-
-  // zero out the global history
-
-  memset(::ghist_words, 0, sizeof(::ghist_words));
-
-  // make a reasonable theta
+  // zero out the weights tables and the global history, and make a reasonable theta
 
-  for (unsigned i = 0; i < NUM_CPUS; i++)
-    ::theta[i] = 10;
+  ::predictors[this] = {};
 }
 
 uint8_t O3_CPU::predict_branch(uint64_t pc)
 {
+  auto& state = ::predictors.at(this);
 
   // initialize perceptron sum
 
-  ::yout[cpu] = 0;
+  state.yout = 0;
 
   // for each table...
 
@@ -153,11 +150,11 @@ uint8_t O3_CPU::predict_branch(uint64_t pc)
 
     int j;
     for (j = 0; j < most_words; j++)
-      x ^= ::ghist_words[cpu][j];
+      x ^= state.ghist_words[j];
 
     // XOR in the last word
 
-    x ^= ::ghist_words[cpu][j] & ((1 << last_word) - 1);
+    x ^= state.ghist_words[j] & ((1 << last_word) - 1);
 
     // XOR in the PC to spread accesses around (like gshare)
 
@@ -169,21 +166,22 @@ uint8_t O3_CPU::predict_branch(uint64_t pc)
 
     // remember this index for update
 
-    ::indices[cpu][i] = x;
+    state.indices[i] = x;
 
     // add the selected weight to the perceptron sum
 
-    ::yout[cpu] += ::tables[cpu][i][x];
+    state.yout += state.tables[i][x];
   }
-  return ::yout[cpu] >= 1;
+  return state.yout >= 1;
 }
 
 void O3_CPU::last_branch_result(uint64_t pc, uint64_t branch_target, uint8_t taken, uint8_t branch_type)
 {
+  auto& state = ::predictors.at(this);
 
   // was this prediction correct?
 
-  bool correct = taken == (::yout[cpu] >= 1);
+  bool correct = taken == (state.yout >= 1);
 
   // insert this branch outcome into the global history
 
@@ -192,27 +190,27 @@ void O3_CPU::last_branch_result(uint64_t pc, uint64_t branch_target, uint8_t tak
 
     // shift b into the lsb of the current word
 
-    ::ghist_words[cpu][i] <<= 1;
-    ::ghist_words[cpu][i] |= b;
+    state.ghist_words[i] <<= 1;
+    state.ghist_words[i] |= b;
 
     // get b as the previous msb of the current word
 
-    b = !!(::ghist_words[cpu][i] & TABLE_SIZE);
-    ::ghist_words[cpu][i] &= TABLE_SIZE - 1;
+    b = !!(state.ghist_words[i] & TABLE_SIZE);
+    state.ghist_words[i] &= TABLE_SIZE - 1;
   }
 
   // get the magnitude of yout
 
-  int a = (::yout[cpu] < 0) ? -::yout[cpu] : ::yout[cpu];
+  int a = (state.yout < 0) ? -state.yout : state.yout;
 
   // perceptron learning rule: train if misprediction or weak correct prediction
 
-  if (!correct || a < ::theta[cpu]) {
+  if (!correct || a < state.theta) {
     // update weights
     for (int i = 0; i < NTABLES; i++) {
       // which weight did we use to compute yout?
 
-      int* c = &::tables[cpu][i][::indices[cpu][i]];
+      int* c = &state.tables[i][state.indices[i]];
 
       // increment if taken, decrement if not, saturating at 127/-128
 
@@ -231,19 +229,19 @@ void O3_CPU::last_branch_result(uint64_t pc, uint64_t branch_target, uint8_t tak
 
       // increase theta after enough mispredictions
 
-      ::tc[cpu]++;
-      if (::tc[cpu] >= SPEED) {
-        ::theta[cpu]++;
-        ::tc[cpu] = 0;
+      state.tc++;
+      if (state.tc >= SPEED) {
+        state.theta++;
+        state.tc = 0;
       }
-    } else if (a < ::theta[cpu]) {
+    } else if (a < state.theta) {
 
       // decrease theta after enough weak but correct predictions
 
-      ::tc[cpu]--;
-      if (::tc[cpu] <= -SPEED) {
-        ::theta[cpu]--;
-        ::tc[cpu] = 0;
+      state.tc--;
+      if (state.tc <= -SPEED) {
+        state.theta--;
+        state.tc = 0;
       }
     }
   }
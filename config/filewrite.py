@@ -32,6 +32,8 @@ core_module_declaration_file_name = 'ooo_cpu_module_decl.inc'
 core_module_definition_file_name = 'ooo_cpu_module_def.inc'
 cache_module_declaration_file_name = 'cache_module_decl.inc'
 cache_module_definition_file_name = 'cache_module_def.inc'
+dram_module_declaration_file_name = 'dram_module_decl.inc'
+dram_module_definition_file_name = 'dram_module_def.inc'
 makefile_file_name = os.path.join(os.path.dirname(os.path.dirname(os.path.abspath(__file__))), '_configuration.mk')
 
 cxx_generated_warning = ('/***', ' * THIS FILE IS AUTOMATICALLY GENERATED', ' * Do not edit this file. It will be overwritten when the configure script is run.', ' ***/', '')
@@ -95,6 +97,14 @@ class FileWriter:
             (os.path.join(inc_dir, cache_module_definition_file_name), cache_definitions)
         ))
 
+        # DRAM modules file
+        dram_declarations, dram_definitions = modules.get_dram_module_lines(module_info['dram_scheduler'])
+
+        self.fileparts.extend((
+            (os.path.join(inc_dir, dram_module_declaration_file_name), dram_declarations),
+            (os.path.join(inc_dir, dram_module_definition_file_name), dram_definitions)
+        ))
+
         joined_module_info = util.subdict(util.chain(*module_info.values()), modules_to_compile) # remove module type tag
         self.fileparts.extend((os.path.join(inc_dir, m['name'] + '.inc'), get_map_lines(util.chain(m['func_map'], m.get('deprecated_func_map', {})))) for m in joined_module_info.values())
         self.fileparts.append((makefile_file_name, makefile.get_makefile_lines(local_objdir_name, build_id, os.path.normpath(os.path.join(local_bindir_name, executable)), local_srcdir_names, joined_module_info, env)))
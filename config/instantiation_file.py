@@ -18,9 +18,25 @@ import operator
 
 from . import util
 
-pmem_fmtstr = 'MEMORY_CONTROLLER {name}{{{frequency}, {io_freq}, {tRP}, {tRCD}, {tCAS}, {turn_around_time}, {{{_ulptr}}}}};'
 vmem_fmtstr = 'VirtualMemory vmem{{{pte_page_size}, {num_levels}, {minor_fault_penalty}, {dram_name}}};'
 
+pmem_builder_parts = {
+    'bank_groups': '.bank_groups({bank_groups})',
+    'tRRD_S': '.tRRD_S({tRRD_S})',
+    'tRRD_L': '.tRRD_L({tRRD_L})',
+    'tFAW': '.tFAW({tFAW})',
+    'tCCD_S': '.tCCD_S({tCCD_S})',
+    'tCCD_L': '.tCCD_L({tCCD_L})',
+    'tWR': '.tWR({tWR})',
+    'tWTR_S': '.tWTR_S({tWTR_S})',
+    'tWTR_L': '.tWTR_L({tWTR_L})',
+    'tREFI': '.tREFI({tREFI})',
+    'tRFC': '.tRFC({tRFC})',
+    'tRFCsb': '.tRFCsb({tRFCsb})',
+    'tXP': '.tXP({tXP})',
+    'power_down_threshold': '.power_down_threshold({power_down_threshold})'
+}
+
 queue_fmtstr = 'champsim::channel {name}{{{rq_size}, {pq_size}, {wq_size}, {_offset_bits}, {_queue_check_full_addr:b}}};'
 
 core_builder_parts = {
@@ -118,9 +134,23 @@ def get_instantiation_lines(cores, caches, ptws, pmem, vmem):
             yield queue_fmtstr.format(name='{}_to_{}_queues'.format(ul, ll), **v)
     yield ''
 
-    yield pmem_fmtstr.format(
-            _ulptr=vector_string('&{}_to_{}_queues'.format(ul, pmem['name']) for ul in upper_levels[pmem['name']]['uppers']),
-            **pmem)
+    yield 'MEMORY_CONTROLLER {name}{{MEMORY_CONTROLLER::Builder{{}}'.format(**pmem)
+    yield '.frequency({frequency})'.format(**pmem)
+    yield '.io_frequency({io_freq})'.format(**pmem)
+    yield '.tRP({tRP})'.format(**pmem)
+    yield '.tRCD({tRCD})'.format(**pmem)
+    yield '.tCAS({tCAS})'.format(**pmem)
+    yield '.turn_around_time({turn_around_time})'.format(**pmem)
+    yield from (v.format(**pmem) for k,v in pmem_builder_parts.items() if k in pmem)
+
+    if pmem.get('refresh') == 'same_bank':
+        yield '.set_same_bank_refresh()'
+
+    if pmem.get('_scheduler_data'):
+        yield '.scheduler<{}>()'.format(' | '.join('MEMORY_CONTROLLER::s{}'.format(k['name']) for k in pmem['_scheduler_data']))
+
+    yield '.upper_levels({{{}}})'.format(vector_string('&{}_to_{}_queues'.format(ul, pmem['name']) for ul in upper_levels[pmem['name']]['uppers']))
+    yield '};'
     yield vmem_fmtstr.format(dram_name=pmem['name'], **vmem)
 
     for ptw in ptws:
@@ -44,7 +44,7 @@ class ModuleSearchContext:
         files = itertools.starmap(os.path.join, itertools.chain(*(zip(itertools.repeat(b), d) for b,d,_ in base_dirs)))
         return [self.data_from_path(f) for f in files]
 
-# A unifying function for the four module types to return their information
+# A unifying function for the module types to return their information
 def data_getter(prefix, module_name, funcs):
     return {
         'name': module_name,
@@ -88,6 +88,9 @@ def get_pref_data(module_name, is_instruction_cache=False):
 def get_repl_data(module_name):
     return data_getter('repl', module_name, ('initialize_replacement', 'find_victim', 'update_replacement_state', 'replacement_final_stats'))
 
+def get_dram_scheduler_data(module_name):
+    return data_getter('dsched', module_name, ('initialize_dram_scheduler', 'dram_scheduler_select', 'dram_scheduler_final_stats'))
+
 # Generate C++ code giving the mangled module specialization functions
 def mangled_declarations(rtype, names, args, attrs=[]):
     if rtype != 'void':
@@ -109,7 +112,7 @@ def mangled_prohibited_definitions(fname, names, args=tuple(), rtype='void', *ta
 
 # Generate C++ code giving the declaration for a discriminator function. If the class name is given, the declaration is assumed to be outside the class declaration
 def discriminator_function_declaration(fname, rtype, args, varname, secondary_varname, classname):
-    yield 'template <unsigned long long {}, unsigned long long {}>'.format(*sorted([varname, secondary_varname]))
+    yield 'template <{}>'.format(', '.join('unsigned long long ' + v for v in sorted(filter(None, [varname, secondary_varname]))))
     argstring = ', '.join((a[0]+' '+a[1]) for a in args)
     yield '{} {}::impl_{}({})'.format(rtype, classname, fname, argstring)
 
@@ -243,3 +246,29 @@ def get_cache_module_lines(pref_data, repl_data):
             *(get_discriminator(fname, repl_varname, pref_varname, [(repl_prefix + v['name'], v['func_map'][fname]) for v in repl_data.values()], *finfo, classname=classname) for fname, *finfo in repl_variant_data)
         )
        )
+
+# Return a pair containing two generators: The first generates C++ code declaring all functions for the DRAM scheduler modules, and the second generates C++ code defining the functions
+def get_dram_module_lines(sched_data):
+    sched_prefix = 's'
+    sched_varname = 'S_FLAG'
+
+    sched_variant_data = [
+        ('initialize_dram_scheduler',),
+        ('dram_scheduler_select', (('DRAM_CHANNEL&', 'channel'), ('DRAM_CHANNEL::queue_type&', 'queue')), 'DRAM_CHANNEL::queue_type::iterator', 'champsim::detail::take_last'),
+        ('dram_scheduler_final_stats',)
+    ]
+
+    classname = 'MEMORY_CONTROLLER::module_model<' + sched_varname + '>'
+
+    return (
+        itertools.chain(
+            constants_for_modules(sched_prefix, sched_data.values()), ('',),
+
+            # Declare name-mangled functions
+            *(get_module_variant_declarations(fname, [v['func_map'][fname] for v in sched_data.values()], *finfo) for fname, *finfo in sched_variant_data)
+        ),
+
+        itertools.chain(
+            *(get_discriminator(fname, sched_varname, None, [(sched_prefix + v['name'], v['func_map'][fname]) for v in sched_data.values()], *finfo, classname=classname) for fname, *finfo in sched_variant_data)
+        )
+       )
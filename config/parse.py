@@ -24,6 +24,29 @@ from . import util
 default_root = { 'block_size': 64, 'page_size': 4096, 'heartbeat_frequency': 10000000, 'num_cores': 1 }
 default_core = { 'frequency' : 4000 }
 default_pmem = { 'name': 'DRAM', 'frequency': 3200, 'channels': 1, 'ranks': 1, 'banks': 8, 'rows': 65536, 'columns': 128, 'lines_per_column': 8, 'channel_width': 8, 'wq_size': 64, 'rq_size': 64, 'tRP': 12.5, 'tRCD': 12.5, 'tCAS': 12.5, 'turn_around_time': 7.5 }
+
+# Device presets for the physical memory, from the JEDEC speed bins for x8 devices. Timings are in nanoseconds.
+pmem_presets = {
+    'DDR4-3200': {
+        'frequency': 3200, 'channel_width': 8, 'banks': 16, 'bank_groups': 4,
+        'tRP': 13.75, 'tRCD': 13.75, 'tCAS': 13.75,
+        'tRRD_S': 2.5, 'tRRD_L': 4.9, 'tFAW': 21, 'tCCD_S': 2.5, 'tCCD_L': 5, 'tWR': 15, 'tWTR_S': 2.5, 'tWTR_L': 7.5,
+        'tREFI': 7800, 'tRFC': 350, 'refresh': 'all_bank', 'tXP': 6
+    },
+    'DDR5-4800': {
+        'frequency': 4800, 'channel_width': 4, 'banks': 32, 'bank_groups': 8,
+        'tRP': 16, 'tRCD': 16, 'tCAS': 16.67,
+        'tRRD_S': 3.33, 'tRRD_L': 5, 'tFAW': 13.33, 'tCCD_S': 3.33, 'tCCD_L': 5, 'tWR': 30, 'tWTR_S': 2.5, 'tWTR_L': 10,
+        'tREFI': 3900, 'tRFC': 295, 'tRFCsb': 130, 'refresh': 'same_bank', 'tXP': 7.5
+    },
+    'DDR5-6400': {
+        'frequency': 6400, 'channel_width': 4, 'banks': 32, 'bank_groups': 8,
+        'tRP': 16.25, 'tRCD': 16.25, 'tCAS': 16.25,
+        'tRRD_S': 2.5, 'tRRD_L': 5, 'tFAW': 10, 'tCCD_S': 2.5, 'tCCD_L': 5, 'tWR': 30, 'tWTR_S': 2.5, 'tWTR_L': 10,
+        'tREFI': 3900, 'tRFC': 295, 'tRFCsb': 130, 'refresh': 'same_bank', 'tXP': 7.5
+    }
+}
+
 default_vmem = { 'pte_page_size': (1 << 12), 'num_levels': 5, 'minor_fault_penalty': 200 }
 
 cache_deprecation_keys = {
@@ -114,10 +137,12 @@ def normalize_config(config_file):
 
     return cores, caches, ptws, config_file.get('physical_memory', {}), config_file.get('virtual_memory', {})
 
-def parse_normalized(cores, caches, ptws, pmem, vmem, merged_configs, branch_context, btb_context, prefetcher_context, replacement_context, compile_all_modules):
+def parse_normalized(cores, caches, ptws, pmem, vmem, merged_configs, branch_context, btb_context, prefetcher_context, replacement_context, compile_all_modules, *, dram_scheduler_context=modules.ModuleSearchContext([])):
     config_file = util.chain(merged_configs, default_root)
 
-    pmem = util.chain(pmem, default_pmem)
+    if 'preset' in pmem and pmem['preset'] not in pmem_presets:
+        raise ValueError('Unknown physical memory preset "{}". The presets are: {}'.format(pmem['preset'], ', '.join(pmem_presets)))
+    pmem = util.chain(pmem, pmem_presets.get(pmem.get('preset'), {}), default_pmem)
     vmem = util.chain(vmem, default_vmem)
 
     cores = [util.chain(cpu, {'DIB': dict()}, default_core) for cpu in cores]
@@ -204,12 +229,16 @@ def parse_normalized(cores, caches, ptws, pmem, vmem, merged_configs, branch_con
             ({'name': c['name'], '_btb_data': [btb_context.find(f) for f in util.wrap_list(c.get('btb',[]))]} for c in cores)
             ).values())
 
+    # The memory controller schedules the oldest request first, unless a scheduler is given
+    pmem['_scheduler_data'] = [dram_scheduler_context.find(f) for f in util.wrap_list(pmem.get('scheduler',[]))]
+
     elements = {'cores': cores, 'caches': tuple(caches.values()), 'ptws': tuple(ptws.values()), 'pmem': pmem, 'vmem': vmem}
     module_info = {
             'repl': util.combine_named(*(c['_replacement_data'] for c in caches.values()), replacement_context.find_all()),
             'pref': util.combine_named(*(c['_prefetcher_data'] for c in caches.values()), prefetcher_context.find_all()),
             'branch': util.combine_named(*(c['_branch_predictor_data'] for c in cores), branch_context.find_all()),
-            'btb': util.combine_named(*(c['_btb_data'] for c in cores), btb_context.find_all())
+            'btb': util.combine_named(*(c['_btb_data'] for c in cores), btb_context.find_all()),
+            'dram_scheduler': util.combine_named(pmem['_scheduler_data'], dram_scheduler_context.find_all())
             }
 
     if compile_all_modules:
@@ -219,7 +248,8 @@ def parse_normalized(cores, caches, ptws, pmem, vmem, merged_configs, branch_con
             *(c['_replacement_data'] for c in caches.values()),
             *(c['_prefetcher_data'] for c in caches.values()),
             *(c['_branch_predictor_data'] for c in cores),
-            *(c['_btb_data'] for c in cores)
+            *(c['_btb_data'] for c in cores),
+            pmem['_scheduler_data']
         ))]
 
     env_vars = ('CC', 'CXX', 'CPPFLAGS', 'CXXFLAGS', 'LDFLAGS', 'LDLIBS')
@@ -227,7 +257,7 @@ def parse_normalized(cores, caches, ptws, pmem, vmem, merged_configs, branch_con
 
     return elements, modules_to_compile, module_info, util.subdict(config_file, extern_config_file_keys), util.subdict(config_file, env_vars)
 
-def parse_config(*configs, module_dir=[], branch_dir=[], btb_dir=[], pref_dir=[], repl_dir=[], compile_all_modules=False):
+def parse_config(*configs, module_dir=[], branch_dir=[], btb_dir=[], pref_dir=[], repl_dir=[], dram_scheduler_dir=[], compile_all_modules=False):
     champsim_root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
 
     name = executable_name(*configs)
@@ -238,6 +268,7 @@ def parse_config(*configs, module_dir=[], branch_dir=[], btb_dir=[], pref_dir=[]
         btb_context = modules.ModuleSearchContext([*(os.path.join(m, 'btb') for m in module_dir), *btb_dir, os.path.join(champsim_root, 'btb')]),
         replacement_context = modules.ModuleSearchContext([*(os.path.join(m, 'replacement') for m in module_dir), *repl_dir, os.path.join(champsim_root, 'replacement')]),
         prefetcher_context = modules.ModuleSearchContext([*(os.path.join(m, 'prefetcher') for m in module_dir), *pref_dir, os.path.join(champsim_root, 'prefetcher')]),
+        dram_scheduler_context = modules.ModuleSearchContext([*(os.path.join(m, 'dram_scheduler') for m in module_dir), *dram_scheduler_dir, os.path.join(champsim_root, 'dram_scheduler')]),
         compile_all_modules = compile_all_modules
     )
 
@@ -246,6 +277,7 @@ def parse_config(*configs, module_dir=[], branch_dir=[], btb_dir=[], pref_dir=[]
             'pref': {k: util.chain(v, modules.get_pref_data(v['name'], v['_is_instruction_prefetcher'])) for k,v in module_info['pref'].items()},
             'branch': {k: util.chain(v, modules.get_branch_data(v['name'])) for k,v in module_info['branch'].items()},
             'btb': {k: util.chain(v, modules.get_btb_data(v['name'])) for k,v in module_info['btb'].items()},
+            'dram_scheduler': {k: util.chain(v, modules.get_dram_scheduler_data(v['name'])) for k,v in module_info['dram_scheduler'].items()},
             }
 
     return name, elements, modules_to_compile, module_info, config_file, env
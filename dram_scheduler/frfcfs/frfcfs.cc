@@ -0,0 +1,44 @@
+#include <iterator>
+#include <optional>
+#include <utility>
+
+#include "dram_controller.h"
+
+void MEMORY_CONTROLLER::initialize_dram_scheduler() {}
+
+// First-ready, first-come-first-served: the oldest request that hits in the open row of an available bank, or else the oldest request to an
+// available bank
+DRAM_CHANNEL::queue_type::iterator MEMORY_CONTROLLER::dram_scheduler_select(DRAM_CHANNEL& channel, DRAM_CHANNEL::queue_type& queue)
+{
+  std::optional<std::pair<uint64_t, std::size_t>> oldest_hit;
+  std::optional<std::pair<uint64_t, std::size_t>> oldest;
+
+  const auto& lists = channel.ready_lists(queue);
+  for (std::size_t bank = 0; bank < std::size(lists); ++bank) {
+    if (!channel.bank_available(bank, current_cycle))
+      continue;
+
+    // Each list is ordered by the cycle that its requests became ready
+    for (auto entry : lists[bank]) {
+      if (entry.first > current_cycle)
+        break;
+
+      if (!oldest.has_value() || entry < *oldest)
+        oldest = entry;
+
+      auto row = dram_get_row(std::next(std::begin(queue), static_cast<std::ptrdiff_t>(entry.second))->value().address);
+      if (row == channel.bank_request[bank].open_row) {
+        if (!oldest_hit.has_value() || entry < *oldest_hit)
+          oldest_hit = entry;
+        break;
+      }
+    }
+  }
+
+  auto selected = oldest_hit.has_value() ? oldest_hit : oldest;
+  if (!selected.has_value())
+    return std::end(queue);
+  return std::next(std::begin(queue), static_cast<std::ptrdiff_t>(selected->second));
+}
+
+void MEMORY_CONTROLLER::dram_scheduler_final_stats() {}
@@ -0,0 +1,158 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ASYNC_READER_H
+#define ASYNC_READER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "instruction.h"
+#include "util/spsc_queue.h"
+
+namespace champsim
+{
+/**
+ * Wraps a trace reader so that it runs ahead on a background thread.
+ *
+ * The wrapped reader decompresses and decodes instructions in batches on the producer thread, and passes them to the simulation through a
+ * lock-free queue. The instructions are delivered in the same order, and a bulk read is filled completely unless the trace ends, so the
+ * simulation is unchanged. The simulation thread waits only if the producer has fallen behind, and the producer sleeps while the queue is full.
+ */
+template <typename T>
+class async_reader
+{
+  constexpr static std::size_t batch_size = 256;
+  constexpr static std::size_t queue_size = 16 * batch_size;
+
+  struct state_type {
+    T intern_;
+    champsim::spsc_queue<ooo_model_instr> queue_{queue_size};
+    std::atomic<bool> stop_{false};
+    std::atomic<bool> done_{false};
+    std::exception_ptr error_{};
+
+    // The producer waits on this while the queue is full, and the simulation signals it when it takes instructions
+    std::mutex mutex_;
+    std::condition_variable room_;
+
+    void notify_room()
+    {
+      { std::lock_guard lock{mutex_}; } // Order the notification after a producer that is about to wait
+      room_.notify_one();
+    }
+
+    template <typename... Args>
+    explicit state_type(Args&&... args) : intern_{std::forward<Args>(args)...}
+    {
+    }
+
+    void produce();
+  };
+
+  // The state is shared with the producer thread, so it must not move
+  std::unique_ptr<state_type> state_;
+  std::thread producer_;
+
+  void join()
+  {
+    if (producer_.joinable()) {
+      state_->stop_.store(true, std::memory_order_release);
+      state_->notify_room();
+      producer_.join();
+    }
+  }
+
+public:
+  template <typename... Args>
+  explicit async_reader(Args&&... args)
+      : state_(std::make_unique<state_type>(std::forward<Args>(args)...)), producer_([state = state_.get()]() { state->produce(); })
+  {
+  }
+
+  async_reader(async_reader&&) = default;
+  async_reader& operator=(async_reader&& other)
+  {
+    join();
+    state_ = std::move(other.state_);
+    producer_ = std::move(other.producer_);
+    return *this;
+  }
+  ~async_reader() { join(); }
+
+  ooo_model_instr operator()()
+  {
+    ooo_model_instr retval{0, input_instr{}};
+    (*this)(&retval, std::next(&retval));
+    return retval;
+  }
+
+  ooo_model_instr* operator()(ooo_model_instr* first, ooo_model_instr* last);
+
+  bool eof() const { return state_->done_.load(std::memory_order_acquire) && std::empty(state_->queue_); }
+};
+
+template <typename T>
+void async_reader<T>::state_type::produce()
+{
+  std::vector<ooo_model_instr> batch(batch_size, ooo_model_instr{0, input_instr{}});
+  try {
+    while (!stop_.load(std::memory_order_acquire) && !intern_.eof()) {
+      auto batch_end = intern_(std::data(batch), std::data(batch) + std::size(batch));
+      for (auto it = std::data(batch); it != batch_end && !stop_.load(std::memory_order_acquire);) {
+        it = queue_.push(it, batch_end);
+        if (it != batch_end) {
+          // The simulation is behind, so sleep until it makes room
+          std::unique_lock lock{mutex_};
+          room_.wait(lock, [this]() { return stop_.load(std::memory_order_acquire) || std::size(queue_) < queue_.capacity(); });
+        }
+      }
+    }
+  } catch (...) {
+    error_ = std::current_exception();
+  }
+  done_.store(true, std::memory_order_release);
+}
+
+template <typename T>
+ooo_model_instr* async_reader<T>::operator()(ooo_model_instr* first, ooo_model_instr* last)
+{
+  while (first != last) {
+    auto popped = state_->queue_.pop(first, static_cast<std::size_t>(std::distance(first, last)));
+    if (popped != first)
+      state_->notify_room();
+    first = popped;
+
+    if (first != last) {
+      if (eof())
+        break;
+      std::this_thread::yield(); // The producer is behind, wait for more instructions
+    }
+  }
+
+  if (eof() && state_->error_)
+    std::rethrow_exception(state_->error_);
+
+  return first;
+}
+} // namespace champsim
+
+#endif
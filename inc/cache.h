@@ -35,6 +35,7 @@
 #include "channel.h"
 #include "module_impl.h"
 #include "operable.h"
+#include "util/mshr_queue.h"
 #include <type_traits>
 
 struct cache_stats {
@@ -143,6 +144,7 @@ class CACHE : public champsim::operable
   std::pair<set_type::iterator, set_type::iterator> get_set_span(uint64_t address);
   std::pair<set_type::const_iterator, set_type::const_iterator> get_set_span(uint64_t address) const;
   std::size_t get_set_index(uint64_t address) const;
+  std::size_t find_way(uint64_t address) const;
 
   template <typename T>
   bool should_activate_prefetcher(const T& pkt) const;
@@ -166,6 +168,7 @@ public:
   const uint64_t HIT_LATENCY, FILL_LATENCY;
   const unsigned OFFSET_BITS;
   set_type block{NUM_SET * NUM_WAY};
+  std::vector<uint64_t> block_tags = std::vector<uint64_t>(NUM_SET * NUM_WAY); // address >> OFFSET_BITS of each block, packed for the tag match
   const long int MAX_TAG, MAX_FILL;
   const bool prefetch_as_load;
   const bool match_offset_bits;
@@ -177,10 +180,12 @@ public:
 
   stats_type sim_stats, roi_stats;
 
-  std::deque<mshr_type> MSHR;
+  champsim::mshr_queue<mshr_type> MSHR;
   std::deque<mshr_type> inflight_writes;
 
   long operate() override final;
+  uint64_t next_event_cycle() const override final;
+  bool operate_idle() override final;
 
   void initialize() override final;
   void begin_phase() override final;
@@ -460,7 +465,7 @@ public:
         NUM_WAY(b.m_ways), MSHR_SIZE(b.m_mshr_size), PQ_SIZE(b.m_pq_size), HIT_LATENCY((b.m_hit_lat > 0) ? b.m_hit_lat : b.m_latency - b.m_fill_lat),
         FILL_LATENCY(b.m_fill_lat), OFFSET_BITS(b.m_offset_bits), MAX_TAG(b.m_max_tag), MAX_FILL(b.m_max_fill), prefetch_as_load(b.m_pref_load),
         match_offset_bits(b.m_wq_full_addr), virtual_prefetch(b.m_va_pref), pref_activate_mask(b.m_pref_act_mask),
-        module_pimpl(std::make_unique<module_model<P_FLAG, R_FLAG>>(this))
+        MSHR(b.m_offset_bits), module_pimpl(std::make_unique<module_model<P_FLAG, R_FLAG>>(this))
   {
   }
 };
@@ -0,0 +1,88 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CLOCK_SCHEDULE_H
+#define CLOCK_SCHEDULE_H
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#include "operable.h"
+
+namespace champsim
+{
+/**
+ * A fixed set of operables, grouped by clock period when they are added.
+ *
+ * Each call to operate() advances the fastest clock by one cycle. Operables that share a clock are operated in the order they were added.
+ * Clock domains are operated in order of how far they lag the fastest clock, keeping their previous order when they lag equally.
+ */
+class clock_schedule
+{
+  struct domain {
+    uint64_t period_num, period_den;
+    std::vector<std::reference_wrapper<operable>> members;
+
+    // All members of a domain are stepped together, so they share a lag
+    uint64_t leap() const { return members.front().get().leap_operation; }
+  };
+
+  std::vector<domain> domains;
+
+public:
+  clock_schedule() = default;
+
+  template <typename It>
+  clock_schedule(It begin, It end)
+  {
+    std::for_each(begin, end, [this](operable& op) { this->add(op); });
+  }
+
+  void add(operable& op)
+  {
+    auto found = std::find_if(std::begin(domains), std::end(domains),
+                              [&op](const auto& d) { return d.period_num == op.CLOCK_PERIOD_NUM && d.period_den == op.CLOCK_PERIOD_DEN; });
+    if (found == std::end(domains))
+      found = domains.insert(found, domain{op.CLOCK_PERIOD_NUM, op.CLOCK_PERIOD_DEN, {}});
+    found->members.push_back(op);
+  }
+
+  long operate()
+  {
+    // Insertion sort by lag, which is stable and performs no allocation. There are only a handful of domains.
+    auto lags_less = [](const domain& lhs, const domain& rhs) { return lhs.leap() * rhs.period_den < rhs.leap() * lhs.period_den; };
+    for (auto it = std::begin(domains); it != std::end(domains); ++it)
+      std::rotate(std::upper_bound(std::begin(domains), it, *it, lags_less), it, std::next(it));
+
+    long progress{0};
+    for (auto& d : domains) {
+      for (operable& op : d.members)
+        progress += op._operate();
+    }
+    return progress;
+  }
+
+  template <typename F>
+  void for_each(F&& func)
+  {
+    for (auto& d : domains)
+      std::for_each(std::begin(d.members), std::end(d.members), func);
+  }
+};
+} // namespace champsim
+
+#endif
@@ -0,0 +1,347 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef COMPACT_TRACE_H
+#define COMPACT_TRACE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <ios>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "trace_instruction.h"
+
+namespace champsim
+{
+/**
+ * A compact trace holds the same instructions as a trace of fixed-size records, encoded as the difference from the instruction before.
+ * After a header of the magic number and the size of the record type, each instruction is encoded as
+ *
+ *     flags | register mask | memory mask | IP delta | registers | memory deltas [| ASID]
+ *
+ * The flags hold the branch bits, the masks mark which register and memory operands are nonzero (destinations in the low bits, then
+ * sources), and only those operands follow. The IP delta is from the previous IP, and each memory delta from the previous memory operand;
+ * both are zigzag-encoded varints. An instruction that cannot be encoded this way is stored whole after a flags byte with the raw bit set.
+ *
+ * A compact trace may itself be compressed, and its name ends in .cst before any compression suffix.
+ * This header does not depend on the rest of ChampSim, so that tracers can include it.
+ */
+namespace compact_trace
+{
+constexpr uint64_t magic = 0x3130504d43545343ull; // "CSTCMP01" in little-endian order
+
+constexpr unsigned char flag_branch = 0x1;
+constexpr unsigned char flag_taken = 0x2;
+constexpr unsigned char flag_raw = 0x80;
+
+template <typename T>
+struct operand_counts {
+  constexpr static std::size_t dest_regs = sizeof(T::destination_registers) / sizeof(T::destination_registers[0]);
+  constexpr static std::size_t src_regs = sizeof(T::source_registers) / sizeof(T::source_registers[0]);
+  constexpr static std::size_t dest_mem = sizeof(T::destination_memory) / sizeof(T::destination_memory[0]);
+  constexpr static std::size_t src_mem = sizeof(T::source_memory) / sizeof(T::source_memory[0]);
+  static_assert(dest_regs + src_regs <= 8 && dest_mem + src_mem <= 8, "Operand masks must fit in a byte");
+};
+
+// The largest encoding of a record, which is the raw form
+template <typename T>
+constexpr std::size_t max_record_size()
+{
+  return 1 + sizeof(T) > 3 + 10 + 8 + 8 * 10 + 2 ? 1 + sizeof(T) : 3 + 10 + 8 + 8 * 10 + 2;
+}
+
+inline uint64_t zigzag(uint64_t delta) { return (delta << 1) ^ (0 - (delta >> 63)); }
+inline uint64_t unzigzag(uint64_t x) { return (x >> 1) ^ (0 - (x & 1)); }
+
+inline void put_varint(std::vector<unsigned char>& out, uint64_t x)
+{
+  for (; x >= 0x80; x >>= 7)
+    out.push_back(static_cast<unsigned char>(x | 0x80));
+  out.push_back(static_cast<unsigned char>(x));
+}
+
+inline uint64_t get_varint(const unsigned char*& in)
+{
+  uint64_t x = 0;
+  for (unsigned shift = 0;; shift += 7) {
+    auto byte = *in++;
+    x |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0 || shift >= 63)
+      return x;
+  }
+}
+
+// Only cloudsuite records carry an address space identifier
+inline void put_asid(std::vector<unsigned char>&, const input_instr&) {}
+inline void put_asid(std::vector<unsigned char>& out, const cloudsuite_instr& instr) { out.insert(out.end(), instr.asid, instr.asid + 2); }
+inline void get_asid(const unsigned char*&, input_instr&) {}
+inline void get_asid(const unsigned char*& in, cloudsuite_instr& instr)
+{
+  std::copy(in, in + 2, instr.asid);
+  in += 2;
+}
+
+// The state shared by the encoder and decoder, which both update it after every record
+struct delta_state {
+  uint64_t ip = 0;
+  uint64_t address = 0;
+
+  template <typename T>
+  void advance(const T& instr)
+  {
+    ip = instr.ip;
+    for (auto addr : instr.destination_memory)
+      address = (addr != 0) ? addr : address;
+    for (auto addr : instr.source_memory)
+      address = (addr != 0) ? addr : address;
+  }
+};
+
+template <typename T>
+void encode(std::vector<unsigned char>& out, delta_state& state, const T& instr)
+{
+  using counts = operand_counts<T>;
+  if (instr.is_branch > 1 || instr.branch_taken > 1) {
+    out.push_back(flag_raw);
+    auto bytes = reinterpret_cast<const unsigned char*>(&instr);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+    state.advance(instr);
+    return;
+  }
+
+  unsigned char flags = static_cast<unsigned char>((instr.is_branch ? flag_branch : 0) | (instr.branch_taken ? flag_taken : 0));
+  unsigned char reg_mask = 0;
+  unsigned char mem_mask = 0;
+  for (std::size_t i = 0; i < counts::dest_regs; ++i)
+    reg_mask = static_cast<unsigned char>(reg_mask | ((instr.destination_registers[i] != 0) << i));
+  for (std::size_t i = 0; i < counts::src_regs; ++i)
+    reg_mask = static_cast<unsigned char>(reg_mask | ((instr.source_registers[i] != 0) << (counts::dest_regs + i)));
+  for (std::size_t i = 0; i < counts::dest_mem; ++i)
+    mem_mask = static_cast<unsigned char>(mem_mask | ((instr.destination_memory[i] != 0) << i));
+  for (std::size_t i = 0; i < counts::src_mem; ++i)
+    mem_mask = static_cast<unsigned char>(mem_mask | ((instr.source_memory[i] != 0) << (counts::dest_mem + i)));
+
+  out.push_back(flags);
+  out.push_back(reg_mask);
+  out.push_back(mem_mask);
+  put_varint(out, zigzag(instr.ip - state.ip));
+  for (auto reg : instr.destination_registers)
+    if (reg != 0)
+      out.push_back(reg);
+  for (auto reg : instr.source_registers)
+    if (reg != 0)
+      out.push_back(reg);
+
+  auto address = state.address;
+  for (auto addr : instr.destination_memory) {
+    if (addr != 0) {
+      put_varint(out, zigzag(addr - address));
+      address = addr;
+    }
+  }
+  for (auto addr : instr.source_memory) {
+    if (addr != 0) {
+      put_varint(out, zigzag(addr - address));
+      address = addr;
+    }
+  }
+  put_asid(out, instr);
+  state.advance(instr);
+}
+
+template <typename T>
+T decode(const unsigned char*& in, delta_state& state)
+{
+  using counts = operand_counts<T>;
+  T instr{};
+  auto flags = *in++;
+  if (flags & flag_raw) {
+    std::memcpy(&instr, in, sizeof(T));
+    in += sizeof(T);
+    state.advance(instr);
+    return instr;
+  }
+
+  unsigned reg_mask = *in++;
+  unsigned mem_mask = *in++;
+  instr.is_branch = (flags & flag_branch) ? 1 : 0;
+  instr.branch_taken = (flags & flag_taken) ? 1 : 0;
+  instr.ip = state.ip + unzigzag(get_varint(in));
+  for (std::size_t i = 0; i < counts::dest_regs; ++i)
+    instr.destination_registers[i] = ((reg_mask >> i) & 1) ? *in++ : 0;
+  for (std::size_t i = 0; i < counts::src_regs; ++i)
+    instr.source_registers[i] = ((reg_mask >> (counts::dest_regs + i)) & 1) ? *in++ : 0;
+
+  auto address = state.address;
+  for (std::size_t i = 0; i < counts::dest_mem; ++i) {
+    if ((mem_mask >> i) & 1)
+      address = instr.destination_memory[i] = address + unzigzag(get_varint(in));
+  }
+  for (std::size_t i = 0; i < counts::src_mem; ++i) {
+    if ((mem_mask >> (counts::dest_mem + i)) & 1)
+      address = instr.source_memory[i] = address + unzigzag(get_varint(in));
+  }
+  get_asid(in, instr);
+  state.advance(instr);
+  return instr;
+}
+
+inline void put_header(std::vector<unsigned char>& out, uint64_t record_size)
+{
+  for (auto word : {magic, record_size})
+    for (unsigned i = 0; i < 8; ++i)
+      out.push_back(static_cast<unsigned char>(word >> (8 * i)));
+}
+
+// The size of the records in the compact trace that begins with the given bytes, or nothing if they are not a compact trace header
+inline std::optional<uint64_t> get_header(std::string_view header)
+{
+  if (std::size(header) < 16)
+    return std::nullopt;
+
+  uint64_t words[2] = {};
+  for (std::size_t i = 0; i < 16; ++i)
+    words[i / 8] |= static_cast<uint64_t>(static_cast<unsigned char>(header[i])) << (8 * (i % 8));
+  if (words[0] != magic)
+    return std::nullopt;
+  return words[1];
+}
+} // namespace compact_trace
+
+/**
+ * Writes records of type T to a stream as a compact trace.
+ */
+template <typename T>
+class compact_trace_writer
+{
+  std::ostream& out_;
+  compact_trace::delta_state state_;
+  std::vector<unsigned char> buffer_;
+
+  void flush_buffer()
+  {
+    out_.write(reinterpret_cast<const char*>(buffer_.data()), static_cast<std::streamsize>(buffer_.size()));
+    buffer_.clear();
+  }
+
+public:
+  explicit compact_trace_writer(std::ostream& out) : out_(out) { compact_trace::put_header(buffer_, sizeof(T)); }
+  compact_trace_writer(const compact_trace_writer&) = delete;
+  compact_trace_writer& operator=(const compact_trace_writer&) = delete;
+  ~compact_trace_writer() { flush(); }
+
+  void write(const T& instr)
+  {
+    compact_trace::encode(buffer_, state_, instr);
+    if (buffer_.size() >= (1u << 16))
+      flush_buffer();
+  }
+
+  void flush()
+  {
+    flush_buffer();
+    out_.flush();
+  }
+};
+
+/**
+ * Reads a compact trace of records of type T from the stream S, which may itself decompress the file.
+ * It provides the subset of std::istream used by the trace readers, and produces the records in their fixed-size form.
+ */
+template <typename T, typename S>
+class compact_trace_reader
+{
+  constexpr static std::size_t chunk_size = 1 << 16;
+
+  S in_;
+  std::vector<unsigned char> encoded_; // Followed by zeros, so that a truncated record is not decoded past the end
+  std::size_t encoded_pos_ = 0;
+  std::size_t encoded_end_ = 0;
+  compact_trace::delta_state state_;
+
+  std::streamsize gcount_ = 0;
+  bool eof_ = false;
+
+  // Read more of the encoded stream, keeping the bytes that have not been decoded yet
+  void refill()
+  {
+    auto remaining = available();
+    std::copy(encoded_.begin() + static_cast<long>(encoded_pos_), encoded_.begin() + static_cast<long>(encoded_end_), encoded_.begin());
+    encoded_.resize(remaining + chunk_size + compact_trace::max_record_size<T>());
+    in_.read(reinterpret_cast<char*>(encoded_.data() + remaining), static_cast<std::streamsize>(chunk_size));
+    encoded_pos_ = 0;
+    encoded_end_ = remaining + static_cast<std::size_t>(in_.gcount());
+    std::fill(encoded_.begin() + static_cast<long>(encoded_end_), encoded_.end(), 0);
+  }
+
+  std::size_t available() const { return encoded_end_ - encoded_pos_; }
+
+public:
+  explicit compact_trace_reader(std::string fname) : in_(fname)
+  {
+    refill();
+    auto record_size = compact_trace::get_header({reinterpret_cast<const char*>(encoded_.data()), available()});
+    if (record_size != sizeof(T))
+      throw std::runtime_error{"Not a compact trace of this record type: " + fname};
+    encoded_pos_ = 16;
+  }
+
+  compact_trace_reader& read(char* s, std::streamsize count)
+  {
+    auto first = s;
+    for (auto last = s + count; last - first >= static_cast<long>(sizeof(T));) {
+      if (available() < compact_trace::max_record_size<T>() && !in_.eof())
+        refill();
+      if (available() == 0)
+        break;
+
+      const unsigned char* pos = encoded_.data() + encoded_pos_;
+      auto instr = compact_trace::decode<T>(pos, state_);
+      encoded_pos_ = static_cast<std::size_t>(pos - encoded_.data());
+      if (encoded_pos_ > encoded_end_) {
+        encoded_pos_ = encoded_end_; // The trace ends partway through this record
+        break;
+      }
+      std::memcpy(first, &instr, sizeof(T));
+      first += sizeof(T);
+    }
+
+    // A read may end short of the count only because the count is not a multiple of the record size
+    gcount_ = first - s;
+    eof_ = (gcount_ < count) && in_.eof() && available() == 0;
+    return *this;
+  }
+
+  std::streamsize gcount() const { return gcount_; }
+  bool eof() const { return eof_; }
+
+  // The encoded trace is smaller than the records it holds, so its size is a lower bound on theirs
+  template <typename U = S, typename = decltype(std::declval<const U&>().size_hint())>
+  std::optional<uint64_t> size_hint() const
+  {
+    return in_.size_hint();
+  }
+};
+} // namespace champsim
+
+#endif
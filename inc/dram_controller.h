@@ -14,17 +14,28 @@
  * limitations under the License.
  */
 
+#ifdef CHAMPSIM_MODULE
+#define SET_ASIDE_CHAMPSIM_MODULE
+#undef CHAMPSIM_MODULE
+#endif
+
 #ifndef DRAM_H
 #define DRAM_H
 
 #include <array>
 #include <cmath>
+#include <deque>
+#include <functional>
 #include <limits>
+#include <memory>
 #include <optional>
+#include <set>
 #include <string>
+#include <utility>
 
 #include "champsim_constants.h"
 #include "channel.h"
+#include "module_impl.h"
 #include "operable.h"
 
 struct dram_stats {
@@ -32,6 +43,28 @@ struct dram_stats {
   uint64_t dbus_cycle_congested = 0, dbus_count_congested = 0;
 
   unsigned WQ_ROW_BUFFER_HIT = 0, WQ_ROW_BUFFER_MISS = 0, RQ_ROW_BUFFER_HIT = 0, RQ_ROW_BUFFER_MISS = 0, WQ_FULL = 0;
+
+  uint64_t REFRESHES = 0, POWER_DOWN_CYCLES = 0;
+};
+
+/**
+ * Timing parameters of the DRAM device beyond tRP, tRCD, and tCAS, in nanoseconds. A parameter that is zero is not enforced.
+ */
+struct dram_timing_parameters {
+  std::size_t bank_groups = 1;
+
+  double tRRD_S = 0, tRRD_L = 0; // between activations to different and to the same bank group
+  double tFAW = 0;               // the window in which a rank may have four activations
+  double tCCD_S = 0, tCCD_L = 0; // between column accesses to different and to the same bank group
+  double tWR = 0;                // from the end of a write to the precharge of its bank
+  double tWTR_S = 0, tWTR_L = 0; // from the end of a write to a read of a different and of the same bank group
+
+  double tREFI = 0;                // between refreshes of a rank
+  double tRFC = 0, tRFCsb = 0;     // the duration of an all-bank and of a same-bank refresh
+  bool same_bank_refresh = false;  // refresh one bank of each bank group at a time, rather than the whole rank
+
+  double tXP = 0;                  // to exit power-down
+  double power_down_threshold = 0; // how long a rank must be idle before it is powered down
 };
 
 struct DRAM_CHANNEL {
@@ -48,6 +81,7 @@ struct DRAM_CHANNEL {
     uint64_t v_address = 0;
     uint64_t data = 0;
     uint64_t event_cycle = std::numeric_limits<uint64_t>::max();
+    std::size_t bank_index = 0; // rank * DRAM_BANKS + bank
 
     std::vector<std::reference_wrapper<ooo_model_instr>> instr_depend_on_me{};
     std::vector<std::deque<response_type>*> to_return{};
@@ -58,6 +92,16 @@ struct DRAM_CHANNEL {
   using queue_type = std::vector<std::optional<value_type>>;
   queue_type WQ{DRAM_WQ_SIZE}, RQ{DRAM_RQ_SIZE};
 
+  // The requests of a queue that are waiting for each bank and have not been scheduled, as (event_cycle, position in the queue).
+  // The first request of each bank is the oldest, so the next request to schedule is found without searching the queue.
+  using ready_list_type = std::set<std::pair<uint64_t, std::size_t>>;
+  using bank_ready_lists = std::array<ready_list_type, DRAM_RANKS * DRAM_BANKS>;
+  bank_ready_lists WQ_ready{}, RQ_ready{};
+
+  // Kept as requests are added and removed, so that the queues are not counted every cycle
+  std::size_t WQ_occupancy = 0, RQ_occupancy = 0;
+  std::size_t unchecked_requests = 0; // requests that have not been checked for forwarding
+
   struct BANK_REQUEST {
     bool valid = false, row_buffer_hit = false;
 
@@ -66,18 +110,63 @@ struct DRAM_CHANNEL {
     uint64_t event_cycle = 0;
 
     queue_type::iterator pkt;
+    bool is_write = false; // whether pkt is in the WQ
   };
 
   using request_array_type = std::array<BANK_REQUEST, DRAM_RANKS * DRAM_BANKS>;
   request_array_type bank_request = {};
   request_array_type::iterator active_request = std::end(bank_request);
 
+  // The cycle until which each bank may not begin an access, because it is waiting for or performing a refresh
+  std::array<uint64_t, DRAM_RANKS * DRAM_BANKS> bank_blocked_until = {};
+
+  // The cycle at which each bank may be precharged, after the recovery from a write
+  std::array<uint64_t, DRAM_RANKS * DRAM_BANKS> precharge_available = {};
+
+  // The commands to a rank that constrain later commands to its other banks
+  struct rank_timing_type {
+    std::deque<std::pair<uint64_t, std::size_t>> activations{}; // the recent and the scheduled activations, in order, with their banks
+
+    uint64_t write_end = 0;
+    std::array<uint64_t, DRAM_BANKS> group_write_end = {};
+
+    uint64_t refresh_due = 0;
+    uint64_t refresh_end = 0;
+    std::size_t refresh_set = 0; // the bank of each bank group that the next same-bank refresh targets
+
+    uint64_t last_active = 0;
+  };
+  std::array<rank_timing_type, DRAM_RANKS> rank_timing = {};
+
+  // The last column access on the data bus
+  uint64_t last_cas_cycle = 0;
+  std::size_t last_cas_bank = 0;
+
   bool write_mode = false;
   uint64_t dbus_cycle_available = 0;
 
   using stats_type = dram_stats;
   stats_type roi_stats, sim_stats;
 
+  void add_request(queue_type& queue, queue_type::iterator slot, value_type request);
+  void remove_request(queue_type& queue, queue_type::iterator it);
+
+  // Mark a request as waiting for its bank since the given cycle, or as given to its bank
+  void make_ready(queue_type& queue, queue_type::iterator it, uint64_t cycle);
+  void schedule(queue_type& queue, queue_type::iterator it);
+
+  // The unscheduled request of the queue with the lowest event_cycle, the first in the queue among equals, or the end of the queue if there
+  // is none
+  queue_type::iterator next_ready(queue_type& queue);
+  queue_type::const_iterator next_ready(const queue_type& queue) const;
+
+  bank_ready_lists& ready_lists(const queue_type& queue) { return &queue == &WQ ? WQ_ready : RQ_ready; }
+  const bank_ready_lists& ready_lists(const queue_type& queue) const { return &queue == &WQ ? WQ_ready : RQ_ready; }
+  std::size_t& occupancy(const queue_type& queue) { return &queue == &WQ ? WQ_occupancy : RQ_occupancy; }
+
+  // Whether the bank may begin an access: it is not busy with a request, and is not waiting for or performing a refresh
+  bool bank_available(std::size_t bank, uint64_t cycle) const { return !bank_request[bank].valid && bank_blocked_until[bank] <= cycle; }
+
   void check_collision();
   void print_deadlock();
 };
@@ -92,6 +181,12 @@ class MEMORY_CONTROLLER : public champsim::operable
   // Latencies
   const uint64_t tRP, tRCD, tCAS, DRAM_DBUS_TURN_AROUND_TIME, DRAM_DBUS_RETURN_TIME;
 
+  // Constraints between commands, which are not enforced when they are zero
+  const std::size_t DRAM_BANK_GROUPS;
+  const uint64_t tRRD_S, tRRD_L, tFAW, tCCD_S, tCCD_L, tWR, tWTR_S, tWTR_L;
+  const uint64_t tREFI, tRFC, tRFCsb, tXP, POWER_DOWN_THRESHOLD;
+  const bool SAME_BANK_REFRESH;
+
   // these values control when to send out a burst of writes
   constexpr static std::size_t DRAM_WRITE_HIGH_WM = ((DRAM_WQ_SIZE * 7) >> 3);         // 7/8th
   constexpr static std::size_t DRAM_WRITE_LOW_WM = ((DRAM_WQ_SIZE * 6) >> 3);          // 6/8th
@@ -101,24 +196,248 @@ class MEMORY_CONTROLLER : public champsim::operable
   bool add_rq(const request_type& pkt, champsim::channel* ul);
   bool add_wq(const request_type& pkt);
 
+  // The request of the queue to give to its bank next, or the end of the queue if there is none
+  DRAM_CHANNEL::queue_type::iterator select_request(DRAM_CHANNEL& channel, DRAM_CHANNEL::queue_type& queue);
+
+  std::size_t bank_group(std::size_t bank_index) const { return (bank_index % DRAM_BANKS) % DRAM_BANK_GROUPS; }
+
+  // The cycle at which a request to the bank may put its data on the bus, given the column accesses and writes before it
+  uint64_t data_bus_ready(const DRAM_CHANNEL& channel, DRAM_CHANNEL::request_array_type::const_iterator bank) const;
+
+  // The cycle at which an access to the bank that misses in its row buffer, and that begins at the given cycle, may activate its row
+  uint64_t activation_ready(const DRAM_CHANNEL& channel, std::size_t bank_index, uint64_t begin) const;
+  void record_activation(DRAM_CHANNEL& channel, std::size_t bank_index, uint64_t cycle) const;
+
+  // Withdraw the activation of a bank that has not happened yet, when its request is returned to the queue
+  void cancel_activation(DRAM_CHANNEL& channel, std::size_t bank_index) const;
+
+  // The delay to exit power-down, if the rank is powered down, and record the cycles that it spent powered down
+  uint64_t wake_rank(DRAM_CHANNEL& channel, std::size_t rank);
+
+  // Begin the refresh of a rank if it is due, blocking the banks that it targets until they are idle and then until it is finished
+  long refresh(DRAM_CHANNEL& channel, std::size_t rank);
+  std::size_t refresh_set_size() const { return SAME_BANK_REFRESH ? DRAM_BANK_GROUPS : DRAM_BANKS; }
+  uint64_t refresh_interval() const { return SAME_BANK_REFRESH ? tREFI / (DRAM_BANKS / DRAM_BANK_GROUPS) : tREFI; }
+  std::size_t refresh_target(const DRAM_CHANNEL& channel, std::size_t rank, std::size_t i) const;
+
 public:
   std::array<DRAM_CHANNEL, DRAM_CHANNELS> channels;
 
-  MEMORY_CONTROLLER(double freq_scale, int io_freq, double t_rp, double t_rcd, double t_cas, double turnaround, std::vector<channel_type*>&& ul);
+#include "dram_module_decl.inc"
+
+  struct module_concept {
+    virtual ~module_concept() = default;
+
+    virtual void impl_initialize_dram_scheduler() = 0;
+    virtual DRAM_CHANNEL::queue_type::iterator impl_dram_scheduler_select(DRAM_CHANNEL& channel, DRAM_CHANNEL::queue_type& queue) = 0;
+    virtual void impl_dram_scheduler_final_stats() = 0;
+  };
+
+  template <unsigned long long S_FLAG>
+  struct module_model final : module_concept {
+    MEMORY_CONTROLLER* intern_;
+    explicit module_model(MEMORY_CONTROLLER* controller) : intern_(controller) {}
+
+    void impl_initialize_dram_scheduler();
+    DRAM_CHANNEL::queue_type::iterator impl_dram_scheduler_select(DRAM_CHANNEL& channel, DRAM_CHANNEL::queue_type& queue);
+    void impl_dram_scheduler_final_stats();
+  };
+
+  std::unique_ptr<module_concept> module_pimpl;
+
+  // Without a scheduler module, the oldest request is scheduled when its bank is available
+  bool has_scheduler_module = false;
+
+  void impl_initialize_dram_scheduler() { module_pimpl->impl_initialize_dram_scheduler(); }
+  DRAM_CHANNEL::queue_type::iterator impl_dram_scheduler_select(DRAM_CHANNEL& channel, DRAM_CHANNEL::queue_type& queue)
+  {
+    return module_pimpl->impl_dram_scheduler_select(channel, queue);
+  }
+  void impl_dram_scheduler_final_stats() { module_pimpl->impl_dram_scheduler_final_stats(); }
+
+  class builder_conversion_tag
+  {
+  };
+  template <unsigned long long S_FLAG = 0>
+  class Builder
+  {
+    using self_type = Builder<S_FLAG>;
+
+    double m_freq_scale{1};
+    int m_io_freq{};
+    double m_t_rp{};
+    double m_t_rcd{};
+    double m_t_cas{};
+    double m_turnaround{};
+    dram_timing_parameters m_timing{};
+    std::vector<channel_type*> m_uls{};
+
+    friend class MEMORY_CONTROLLER;
+
+    template <unsigned long long OTHER_S>
+    Builder(builder_conversion_tag, const Builder<OTHER_S>& other)
+        : m_freq_scale(other.m_freq_scale), m_io_freq(other.m_io_freq), m_t_rp(other.m_t_rp), m_t_rcd(other.m_t_rcd), m_t_cas(other.m_t_cas),
+          m_turnaround(other.m_turnaround), m_timing(other.m_timing), m_uls(other.m_uls)
+    {
+    }
+
+  public:
+    Builder() = default;
+
+    self_type& frequency(double freq_scale_)
+    {
+      m_freq_scale = freq_scale_;
+      return *this;
+    }
+    self_type& io_frequency(int io_freq_)
+    {
+      m_io_freq = io_freq_;
+      return *this;
+    }
+    self_type& tRP(double t_rp_)
+    {
+      m_t_rp = t_rp_;
+      return *this;
+    }
+    self_type& tRCD(double t_rcd_)
+    {
+      m_t_rcd = t_rcd_;
+      return *this;
+    }
+    self_type& tCAS(double t_cas_)
+    {
+      m_t_cas = t_cas_;
+      return *this;
+    }
+    self_type& turn_around_time(double turnaround_)
+    {
+      m_turnaround = turnaround_;
+      return *this;
+    }
+    self_type& bank_groups(std::size_t bank_groups_)
+    {
+      m_timing.bank_groups = bank_groups_;
+      return *this;
+    }
+    self_type& tRRD_S(double t_rrd_s_)
+    {
+      m_timing.tRRD_S = t_rrd_s_;
+      return *this;
+    }
+    self_type& tRRD_L(double t_rrd_l_)
+    {
+      m_timing.tRRD_L = t_rrd_l_;
+      return *this;
+    }
+    self_type& tFAW(double t_faw_)
+    {
+      m_timing.tFAW = t_faw_;
+      return *this;
+    }
+    self_type& tCCD_S(double t_ccd_s_)
+    {
+      m_timing.tCCD_S = t_ccd_s_;
+      return *this;
+    }
+    self_type& tCCD_L(double t_ccd_l_)
+    {
+      m_timing.tCCD_L = t_ccd_l_;
+      return *this;
+    }
+    self_type& tWR(double t_wr_)
+    {
+      m_timing.tWR = t_wr_;
+      return *this;
+    }
+    self_type& tWTR_S(double t_wtr_s_)
+    {
+      m_timing.tWTR_S = t_wtr_s_;
+      return *this;
+    }
+    self_type& tWTR_L(double t_wtr_l_)
+    {
+      m_timing.tWTR_L = t_wtr_l_;
+      return *this;
+    }
+    self_type& tREFI(double t_refi_)
+    {
+      m_timing.tREFI = t_refi_;
+      return *this;
+    }
+    self_type& tRFC(double t_rfc_)
+    {
+      m_timing.tRFC = t_rfc_;
+      return *this;
+    }
+    self_type& tRFCsb(double t_rfcsb_)
+    {
+      m_timing.tRFCsb = t_rfcsb_;
+      return *this;
+    }
+    self_type& set_same_bank_refresh()
+    {
+      m_timing.same_bank_refresh = true;
+      return *this;
+    }
+    self_type& reset_same_bank_refresh()
+    {
+      m_timing.same_bank_refresh = false;
+      return *this;
+    }
+    self_type& tXP(double t_xp_)
+    {
+      m_timing.tXP = t_xp_;
+      return *this;
+    }
+    self_type& power_down_threshold(double threshold_)
+    {
+      m_timing.power_down_threshold = threshold_;
+      return *this;
+    }
+    self_type& upper_levels(std::vector<channel_type*>&& uls_)
+    {
+      m_uls = std::move(uls_);
+      return *this;
+    }
+    template <unsigned long long S>
+    Builder<S> scheduler()
+    {
+      return Builder<S>{builder_conversion_tag{}, *this};
+    }
+  };
+
+  MEMORY_CONTROLLER(double freq_scale, int io_freq, double t_rp, double t_rcd, double t_cas, double turnaround, std::vector<channel_type*>&& ul,
+                    const dram_timing_parameters& timing = {});
+
+  template <unsigned long long S_FLAG>
+  explicit MEMORY_CONTROLLER(Builder<S_FLAG> b)
+      : MEMORY_CONTROLLER(b.m_freq_scale, b.m_io_freq, b.m_t_rp, b.m_t_rcd, b.m_t_cas, b.m_turnaround, std::move(b.m_uls), b.m_timing)
+  {
+    module_pimpl = std::make_unique<module_model<S_FLAG>>(this);
+    has_scheduler_module = (S_FLAG != 0);
+  }
 
   void initialize() override final;
   long operate() override final;
+  uint64_t next_event_cycle() const override final;
   void begin_phase() override final;
   void end_phase(unsigned cpu) override final;
   void print_deadlock() override final;
 
   std::size_t size() const;
 
-  uint32_t dram_get_channel(uint64_t address);
-  uint32_t dram_get_rank(uint64_t address);
-  uint32_t dram_get_bank(uint64_t address);
-  uint32_t dram_get_row(uint64_t address);
-  uint32_t dram_get_column(uint64_t address);
+  uint32_t dram_get_channel(uint64_t address) const;
+  uint32_t dram_get_rank(uint64_t address) const;
+  uint32_t dram_get_bank(uint64_t address) const;
+  uint32_t dram_get_row(uint64_t address) const;
+  uint32_t dram_get_column(uint64_t address) const;
 };
 
+#include "dram_module_def.inc"
+
+#endif
+
+#ifdef SET_ASIDE_CHAMPSIM_MODULE
+#undef SET_ASIDE_CHAMPSIM_MODULE
+#define CHAMPSIM_MODULE
 #endif
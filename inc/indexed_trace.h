@@ -0,0 +1,112 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INDEXED_TRACE_H
+#define INDEXED_TRACE_H
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <ios>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace champsim
+{
+/**
+ * An indexed trace is a trace whose bytes are split into blocks of a fixed size, each compressed as an independent xz stream.
+ * It ends with an index of where each block begins, followed by a footer:
+ *
+ *     block 0 | block 1 | ... | block N-1 | offset of block 0 | ... | offset of block N-1 | end of block N-1 | footer
+ *
+ * The offsets and the footer are 64-bit integers in the same byte order as the trace records. The footer holds the uncompressed size of a
+ * block, the number of blocks, the total uncompressed size, and a magic number.
+ * Any byte of the trace can be reached by decompressing at most one block.
+ */
+namespace indexed_trace
+{
+constexpr uint64_t magic = 0x3130584449545343ull; // "CSTIDX01" in little-endian order
+constexpr std::size_t default_block_size = std::size_t{1} << 22;
+
+struct footer_type {
+  uint64_t block_size;
+  uint64_t num_blocks;
+  uint64_t total_size;
+  uint64_t magic;
+};
+
+// Whether the file ends with the footer of an indexed trace
+bool has_footer(const std::string& fname);
+} // namespace indexed_trace
+
+/**
+ * Reads an indexed trace. It provides the subset of std::istream used by the trace readers, and seek(), which moves to any byte of the
+ * uncompressed trace in constant time.
+ */
+class indexed_trace_reader
+{
+  std::ifstream file_;
+  indexed_trace::footer_type footer_{};
+  std::vector<uint64_t> block_offsets_;
+
+  std::vector<char> compressed_;
+  std::vector<char> block_;
+  uint64_t block_idx_ = 0; // the block held in block_
+  std::size_t block_pos_ = 0;
+
+  std::streamsize gcount_ = 0;
+  bool eof_ = false;
+
+  void load_block(uint64_t idx);
+
+public:
+  explicit indexed_trace_reader(std::string fname);
+
+  indexed_trace_reader& read(char* s, std::streamsize count);
+  std::streamsize gcount() const { return gcount_; }
+  bool eof() const { return eof_; }
+
+  // Move to the given byte of the uncompressed trace
+  void seek(uint64_t pos);
+};
+
+/**
+ * Writes an indexed trace. The index and footer are written by finish(), or when the writer is destroyed.
+ */
+class indexed_trace_writer
+{
+  std::ostream& out_;
+  std::size_t block_size_;
+  std::vector<char> block_;
+  std::vector<uint64_t> block_offsets_ = {0};
+  uint64_t total_size_ = 0;
+  bool finished_ = false;
+
+  void flush_block();
+
+public:
+  explicit indexed_trace_writer(std::ostream& out, std::size_t block_size = indexed_trace::default_block_size);
+  indexed_trace_writer(const indexed_trace_writer&) = delete;
+  indexed_trace_writer& operator=(const indexed_trace_writer&) = delete;
+  ~indexed_trace_writer();
+
+  indexed_trace_writer& write(const char* s, std::streamsize count);
+  void finish();
+};
+} // namespace champsim
+
+#endif
@@ -17,17 +17,26 @@
 #ifndef INF_STREAM_H
 #define INF_STREAM_H
 
+#include <algorithm>
+#include <array>
 #include <bzlib.h>
 #include <cassert>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <limits>
 #include <lzma.h>
 #include <memory>
+#include <optional>
+#include <vector>
 #include <zlib.h>
+#include <zstd.h>
 
 namespace champsim
 {
 namespace decomp_tags
 {
+// Each tag's deflate() finishes the compressed stream when flush is set, and returns END once it is finished
 enum class status_t { CAN_CONTINUE, END, ERROR };
 
 namespace detail
@@ -40,6 +49,34 @@ struct end_deleter {
     delete s;
   }
 };
+// zstd streams are driven through buffer descriptors, so the position in each buffer is kept here in the form used by the other libraries
+struct zstd_state {
+  const unsigned char* next_in = nullptr;
+  std::size_t avail_in = 0;
+  unsigned char* next_out = nullptr;
+  std::size_t avail_out = 0;
+  uint64_t total_out = 0;
+
+  ZSTD_CCtx* cctx = nullptr;
+  ZSTD_DCtx* dctx = nullptr;
+
+  template <typename F>
+  std::size_t code(F&& func)
+  {
+    ZSTD_inBuffer in{next_in, avail_in, 0};
+    ZSTD_outBuffer out{next_out, avail_out, 0};
+    auto ret = func(&out, &in);
+    next_in += in.pos;
+    avail_in -= in.pos;
+    next_out += out.pos;
+    avail_out -= out.pos;
+    total_out += out.pos;
+    return ret;
+  }
+};
+
+inline std::size_t zstd_free_cctx(zstd_state* s) { return ::ZSTD_freeCCtx(s->cctx); }
+inline std::size_t zstd_free_dctx(zstd_state* s) { return ::ZSTD_freeDCtx(s->dctx); }
 } // namespace detail
 
 struct bzip2_tag_t {
@@ -52,10 +89,10 @@ struct bzip2_tag_t {
 
   static status_type deflate(deflate_state_type& x, bool flush)
   {
-    auto ret = ::BZ2_bzCompress(x.get(), flush ? BZ_FLUSH : BZ_RUN);
-    if (ret == BZ_RUN_OK)
+    auto ret = ::BZ2_bzCompress(x.get(), flush ? BZ_FINISH : BZ_RUN);
+    if (ret == BZ_RUN_OK || ret == BZ_FINISH_OK)
       return status_type::CAN_CONTINUE;
-    if (ret == BZ_FLUSH_OK)
+    if (ret == BZ_STREAM_END)
       return status_type::END;
     return status_type::ERROR;
   }
@@ -81,6 +118,9 @@ struct bzip2_tag_t {
     ::BZ2_bzDecompressInit(state.get(), 0, 0);
     return state;
   }
+
+  // A bzip2 file does not record the size of its data
+  static std::optional<uint64_t> inflated_size(std::istream&) { return std::nullopt; }
 };
 
 template <int window = 15 + 16, int compression = Z_DEFAULT_COMPRESSION>
@@ -112,7 +152,7 @@ struct gzip_tag_t {
   {
     deflate_state_type state{new state_type};
     *state = state_type{Z_NULL, 0, 0, Z_NULL, 0, 0, NULL, NULL, Z_NULL, Z_NULL, Z_NULL, 0, 0ul, 0ul};
-    ::deflateInit(state.get(), compression);
+    ::deflateInit2(state.get(), compression, Z_DEFLATED, window, 8, Z_DEFAULT_STRATEGY);
     return state;
   }
 
@@ -123,8 +163,24 @@ struct gzip_tag_t {
     ::inflateInit2(state.get(), window);
     return state;
   }
+
+  // The last four bytes of a gzip file hold the size of its last member modulo 2^32, which cannot exceed the size of the data
+  static std::optional<uint64_t> inflated_size(std::istream& file)
+  {
+    std::array<unsigned char, 4> isize{};
+    if (!file.seekg(-static_cast<std::streamoff>(std::size(isize)), std::ios::end) || !file.read(reinterpret_cast<char*>(std::data(isize)), std::size(isize)))
+      return std::nullopt;
+    return uint64_t{isize[0]} | (uint64_t{isize[1]} << 8) | (uint64_t{isize[2]} << 16) | (uint64_t{isize[3]} << 24);
+  }
 };
 
+/**
+ * The number of threads used to compress or decompress each xz stream. If zero, one thread is used for each processor.
+ * A stream compressed by more than one thread is split into blocks. Only such streams, or those compressed by xz -T0, can be decompressed by
+ * more than one thread.
+ */
+inline uint32_t lzma_threads = 1;
+
 template <uint32_t flags = 0>
 struct lzma_tag_t {
   using state_type = lzma_stream;
@@ -136,7 +192,7 @@ struct lzma_tag_t {
 
   static status_type deflate(deflate_state_type& x, bool flush)
   {
-    auto ret = ::lzma_code(x.get(), flush ? LZMA_FULL_FLUSH : LZMA_RUN);
+    auto ret = ::lzma_code(x.get(), flush ? LZMA_FINISH : LZMA_RUN);
     if (ret == LZMA_OK)
       return status_type::CAN_CONTINUE;
     else if (ret == LZMA_STREAM_END)
@@ -160,7 +216,18 @@ struct lzma_tag_t {
   {
     deflate_state_type state{new state_type};
     *state = LZMA_STREAM_INIT;
-    auto ret = ::lzma_easy_encoder(state.get(), LZMA_PRESET_DEFAULT, LZMA_CHECK_CRC64);
+#if LZMA_VERSION >= 50020002
+    if (lzma_threads != 1) {
+      lzma_mt options{};
+      options.threads = std::max<uint32_t>(1, lzma_threads == 0 ? ::lzma_cputhreads() : lzma_threads);
+      options.preset = LZMA_PRESET_DEFAULT;
+      options.check = LZMA_CHECK_CRC64;
+      [[maybe_unused]] auto ret = ::lzma_stream_encoder_mt(state.get(), &options);
+      assert(ret == LZMA_OK);
+      return state;
+    }
+#endif
+    [[maybe_unused]] auto ret = ::lzma_easy_encoder(state.get(), LZMA_PRESET_DEFAULT, LZMA_CHECK_CRC64);
     assert(ret == LZMA_OK);
     return state;
   }
@@ -169,10 +236,108 @@ struct lzma_tag_t {
   {
     inflate_state_type state{new state_type};
     *state = LZMA_STREAM_INIT;
+#if LZMA_VERSION >= 50040002
+    if (lzma_threads != 1) {
+      // The decoder falls back to a single thread if the stream has one block, or if the blocks would exceed the memory limit
+      lzma_mt options{};
+      options.flags = flags;
+      options.threads = std::max<uint32_t>(1, lzma_threads == 0 ? ::lzma_cputhreads() : lzma_threads);
+      options.memlimit_threading = ::lzma_physmem() / 4;
+      options.memlimit_stop = std::numeric_limits<uint64_t>::max();
+      auto ret = ::lzma_stream_decoder_mt(state.get(), &options);
+      assert(ret == LZMA_OK);
+      return state;
+    }
+#endif
     auto ret = ::lzma_stream_decoder(state.get(), std::numeric_limits<uint64_t>::max(), flags);
     assert(ret == LZMA_OK);
     return state;
   }
+
+  // The index at the end of an xz file holds the size of the data in its last stream
+  static std::optional<uint64_t> inflated_size(std::istream& file)
+  {
+    std::array<uint8_t, LZMA_STREAM_HEADER_SIZE> footer{};
+    lzma_stream_flags footer_flags{};
+    if (!file.seekg(-static_cast<std::streamoff>(std::size(footer)), std::ios::end) || !file.read(reinterpret_cast<char*>(std::data(footer)), std::size(footer))
+        || ::lzma_stream_footer_decode(&footer_flags, std::data(footer)) != LZMA_OK)
+      return std::nullopt;
+
+    std::vector<uint8_t> index_bytes(footer_flags.backward_size);
+    if (!file.seekg(-static_cast<std::streamoff>(std::size(footer) + std::size(index_bytes)), std::ios::end)
+        || !file.read(reinterpret_cast<char*>(std::data(index_bytes)), static_cast<std::streamsize>(std::size(index_bytes))))
+      return std::nullopt;
+
+    lzma_index* index = nullptr;
+    uint64_t memlimit = std::numeric_limits<uint64_t>::max();
+    std::size_t pos = 0;
+    if (::lzma_index_buffer_decode(&index, &memlimit, nullptr, std::data(index_bytes), &pos, std::size(index_bytes)) != LZMA_OK)
+      return std::nullopt;
+    auto size = ::lzma_index_uncompressed_size(index);
+    ::lzma_index_end(index, nullptr);
+    return size;
+  }
+};
+
+template <int level = ZSTD_CLEVEL_DEFAULT>
+struct zstd_tag_t {
+  using state_type = detail::zstd_state;
+  using in_char_type = std::remove_const_t<std::remove_pointer_t<decltype(state_type::next_in)>>;
+  using out_char_type = std::remove_pointer_t<decltype(state_type::next_out)>;
+  using deflate_state_type = std::unique_ptr<state_type, detail::end_deleter<state_type, std::size_t, detail::zstd_free_cctx>>;
+  using inflate_state_type = std::unique_ptr<state_type, detail::end_deleter<state_type, std::size_t, detail::zstd_free_dctx>>;
+  using status_type = status_t;
+
+  static status_type deflate(deflate_state_type& x, bool flush)
+  {
+    auto ret = x->code([cctx = x->cctx, flush](ZSTD_outBuffer* out, ZSTD_inBuffer* in) {
+      return ::ZSTD_compressStream2(cctx, out, in, flush ? ZSTD_e_end : ZSTD_e_continue);
+    });
+    if (::ZSTD_isError(ret))
+      return status_type::ERROR;
+    if (flush && ret == 0)
+      return status_type::END;
+    return status_type::CAN_CONTINUE;
+  }
+
+  static status_type inflate(inflate_state_type& x)
+  {
+    auto ret = x->code([dctx = x->dctx](ZSTD_outBuffer* out, ZSTD_inBuffer* in) { return ::ZSTD_decompressStream(dctx, out, in); });
+    if (::ZSTD_isError(ret))
+      return status_type::ERROR;
+    if (ret == 0)
+      return status_type::END;
+    return status_type::CAN_CONTINUE;
+  }
+
+  static deflate_state_type new_deflate_state()
+  {
+    deflate_state_type state{new state_type};
+    state->cctx = ::ZSTD_createCCtx();
+    assert(state->cctx != nullptr);
+    ::ZSTD_CCtx_setParameter(state->cctx, ZSTD_c_compressionLevel, level);
+    return state;
+  }
+
+  static inflate_state_type new_inflate_state()
+  {
+    inflate_state_type state{new state_type};
+    state->dctx = ::ZSTD_createDCtx();
+    assert(state->dctx != nullptr);
+    return state;
+  }
+
+  // The header of a zstd frame may hold the size of its data, and zstd writes it when compressing a file
+  static std::optional<uint64_t> inflated_size(std::istream& file)
+  {
+    std::array<char, 18> header{}; // The largest frame header
+    file.seekg(0, std::ios::beg);
+    file.read(std::data(header), std::size(header));
+    auto size = ::ZSTD_getFrameContentSize(std::data(header), static_cast<std::size_t>(file.gcount()));
+    if (size == ZSTD_CONTENTSIZE_UNKNOWN || size == ZSTD_CONTENTSIZE_ERROR)
+      return std::nullopt;
+    return size;
+  }
 };
 } // namespace decomp_tags
 
@@ -209,6 +374,19 @@ struct inf_istream {
   std::unique_ptr<inf_streambuf<StreamType>> buffer = std::make_unique<inf_streambuf<StreamType>>(underlying.get());
   std::streamsize gcount_ = 0;
   bool eof_ = false;
+  std::optional<uint64_t> size_hint_;
+
+  // Only a file that can seek is examined, so that nothing is taken from a pipe
+  void find_size_hint()
+  {
+    auto state = underlying->rdstate();
+    if (state == std::ios::goodbit && underlying->seekg(0, std::ios::end)) {
+      size_hint_ = Tag::inflated_size(*underlying);
+      underlying->clear();
+      underlying->seekg(0, std::ios::beg);
+    }
+    underlying->clear(state);
+  }
 
   inf_istream& read(char* s, std::streamsize count)
   {
@@ -222,10 +400,91 @@ struct inf_istream {
   bool eof() const { return eof_; }
   std::streamsize gcount() const { return gcount_; }
 
-  explicit inf_istream(std::string s) : underlying(std::make_unique<StreamType>(s)) {}
-  explicit inf_istream(StreamType&& str) : underlying(std::make_unique<StreamType>(std::move(str))) {}
+  // A lower bound on the number of bytes in the stream, if the compressed file records one
+  std::optional<uint64_t> size_hint() const { return size_hint_; }
+
+  explicit inf_istream(std::string s) : underlying(std::make_unique<StreamType>(s)) { find_size_hint(); }
+  explicit inf_istream(StreamType&& str) : underlying(std::make_unique<StreamType>(std::move(str))) { find_size_hint(); }
 };
 
+/**
+ * Compresses what is written to it into the underlying stream. The compressed stream is finished by finish(), or when this is destroyed.
+ */
+template <typename Tag, typename StreamType = std::ofstream>
+class def_ostream : public std::ostream
+{
+  class def_streambuf : public std::streambuf
+  {
+    constexpr static std::size_t CHUNK = (1 << 16);
+
+    std::array<char, CHUNK> in_buf;
+    std::array<typename Tag::out_char_type, CHUNK> out_buf;
+    typename Tag::deflate_state_type strm = Tag::new_deflate_state();
+    StreamType* dst;
+
+  public:
+    explicit def_streambuf(StreamType* out) : dst(out) { this->setp(in_buf.data(), std::next(in_buf.data(), CHUNK)); }
+
+    // Compress the bytes written so far, and finish the compressed stream if asked
+    bool deflate(bool finish);
+
+  protected:
+    int_type overflow(int_type ch) override
+    {
+      if (!deflate(false))
+        return traits_type::eof();
+      if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+        *this->pptr() = traits_type::to_char_type(ch);
+        this->pbump(1);
+      }
+      return traits_type::not_eof(ch);
+    }
+  };
+
+  std::unique_ptr<StreamType> underlying;
+  std::unique_ptr<def_streambuf> buffer = std::make_unique<def_streambuf>(underlying.get());
+  bool finished = false;
+
+public:
+  explicit def_ostream(std::string s) : std::ostream(nullptr), underlying(std::make_unique<StreamType>(s)) { this->rdbuf(buffer.get()); }
+  explicit def_ostream(StreamType&& str) : std::ostream(nullptr), underlying(std::make_unique<StreamType>(std::move(str)))
+  {
+    this->rdbuf(buffer.get());
+  }
+  ~def_ostream() override { finish(); }
+
+  void finish()
+  {
+    if (!finished && !buffer->deflate(true))
+      this->setstate(std::ios::badbit);
+    underlying->flush();
+    finished = true;
+  }
+
+  const StreamType& get_underlying() const { return *underlying; }
+};
+
+template <typename T, typename S>
+bool def_ostream<T, S>::def_streambuf::deflate(bool finish)
+{
+  strm->next_in = reinterpret_cast<typename T::in_char_type*>(this->pbase());
+  strm->avail_in = static_cast<decltype(strm->avail_in)>(this->pptr() - this->pbase());
+
+  // Compress until all of the input is consumed, and until the stream ends if it is being finished
+  auto status = T::status_type::CAN_CONTINUE;
+  while (strm->avail_in > 0 || (finish && status == T::status_type::CAN_CONTINUE)) {
+    strm->next_out = out_buf.data();
+    strm->avail_out = static_cast<decltype(strm->avail_out)>(out_buf.size());
+    status = T::deflate(strm, finish);
+    if (status == T::status_type::ERROR)
+      return false;
+    dst->write(reinterpret_cast<const char*>(out_buf.data()), static_cast<std::streamsize>(out_buf.size() - strm->avail_out));
+  }
+
+  this->setp(in_buf.data(), std::next(in_buf.data(), CHUNK));
+  return !dst->fail();
+}
+
 template <typename T, typename S>
 template <typename I>
 auto inf_istream<T, S>::inf_streambuf<I>::underflow() -> int_type
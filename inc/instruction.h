@@ -22,9 +22,9 @@
 #include <cstdint>
 #include <functional>
 #include <limits>
-#include <vector>
 
 #include "trace_instruction.h"
+#include "util/inline_vector.h"
 
 // branch types
 enum branch_type {
@@ -62,14 +62,21 @@ struct ooo_model_instr {
   unsigned completed_mem_ops = 0;
   int num_reg_dependent = 0;
 
-  std::vector<uint8_t> destination_registers = {}; // output registers
-  std::vector<uint8_t> source_registers = {};      // input registers
+  // Operands are stored inline, bounded by the largest trace format, so that instructions never allocate
+  champsim::inline_vector<uint8_t, NUM_INSTR_DESTINATIONS_SPARC> destination_registers = {}; // output registers
+  champsim::inline_vector<uint8_t, NUM_INSTR_SOURCES> source_registers = {};                 // input registers
 
-  std::vector<uint64_t> destination_memory = {};
-  std::vector<uint64_t> source_memory = {};
+  champsim::inline_vector<uint64_t, NUM_INSTR_DESTINATIONS_SPARC> destination_memory = {};
+  champsim::inline_vector<uint64_t, NUM_INSTR_SOURCES> source_memory = {};
 
-  // these are indices of instructions in the ROB that depend on me
-  std::vector<std::reference_wrapper<ooo_model_instr>> registers_instrs_depend_on_me;
+  // An instruction depends on at most one producer per source register, so the list of the instructions in the ROB that depend on this one is threaded
+  // through links held by the dependents themselves.
+  struct dependent_link {
+    ooo_model_instr* dependent = nullptr;
+    dependent_link* next = nullptr;
+  };
+  dependent_link* registers_instrs_depend_on_me = nullptr; // most recently added first
+  champsim::inline_vector<dependent_link, NUM_INSTR_SOURCES> dependent_links = {};
 
 private:
   template <typename T>
@@ -136,6 +143,20 @@ public:
 
   std::size_t num_mem_ops() const { return std::size(destination_memory) + std::size(source_memory); }
 
+  // Record that the given instruction reads a register that this instruction writes
+  void add_register_dependent(ooo_model_instr& dependent)
+  {
+    dependent.dependent_links.push_back({&dependent, registers_instrs_depend_on_me});
+    registers_instrs_depend_on_me = &dependent.dependent_links.back();
+  }
+
+  template <typename F>
+  void for_each_register_dependent(F&& func) const
+  {
+    for (auto link = registers_instrs_depend_on_me; link != nullptr; link = link->next)
+      func(*link->dependent);
+  }
+
   static bool program_order(const ooo_model_instr& lhs, const ooo_model_instr& rhs) { return lhs.instr_id < rhs.instr_id; }
 };
 
@@ -0,0 +1,65 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ios>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace champsim
+{
+/**
+ * A read-only, memory-mapped file that is read sequentially.
+ *
+ * It provides the subset of std::istream used by the trace readers, and view(), which returns the next bytes of the file in place rather than
+ * copying them. As with an std::ifstream, eof() becomes true when a read asks for more bytes than remain.
+ * A file that cannot be opened reads as empty, as with an std::ifstream, but one that is not a regular file or cannot be mapped is an error.
+ */
+class mapped_file
+{
+  const char* data_ = nullptr;
+  std::size_t size_ = 0;
+  std::size_t pos_ = 0;
+  std::streamsize gcount_ = 0;
+  bool eof_ = false;
+
+  void unmap();
+
+public:
+  explicit mapped_file(std::string fname);
+  mapped_file(const mapped_file&) = delete;
+  mapped_file& operator=(const mapped_file&) = delete;
+  mapped_file(mapped_file&& other) noexcept;
+  mapped_file& operator=(mapped_file&& other) noexcept;
+  ~mapped_file();
+
+  // Returns the next (up to) count bytes of the file, which remain valid as long as the file is open
+  std::string_view view(std::size_t count);
+
+  mapped_file& read(char* s, std::streamsize count);
+  void seek(uint64_t pos);
+  std::streamsize gcount() const { return gcount_; }
+  bool eof() const { return eof_; }
+  std::optional<uint64_t> size_hint() const { return size_; }
+};
+} // namespace champsim
+
+#endif
@@ -24,12 +24,13 @@
 
 #include <array>
 #include <bitset>
-#include <deque>
 #include <limits>
 #include <memory>
 #include <optional>
 #include <queue>
 #include <stdexcept>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "champsim.h"
@@ -38,7 +39,9 @@
 #include "instruction.h"
 #include "module_impl.h"
 #include "operable.h"
+#include "util/circular_buffer.h"
 #include "util/lru_table.h"
+#include "util/slot_bitmap.h"
 #include <type_traits>
 
 enum STATUS { INFLIGHT = 1, COMPLETED = 2 };
@@ -50,13 +53,14 @@ class CacheBus
   using request_type = typename channel_type::request_type;
   using response_type = typename channel_type::response_type;
 
-  channel_type* lower_level;
   uint32_t cpu;
 
   friend class O3_CPU;
 
 public:
-  CacheBus(uint32_t cpu_idx, champsim::channel* ll) : lower_level(ll), cpu(cpu_idx) {}
+  channel_type* lower_level;
+
+  CacheBus(uint32_t cpu_idx, champsim::channel* ll) : cpu(cpu_idx), lower_level(ll) {}
   bool issue_read(request_type packet);
   bool issue_write(request_type packet);
 };
@@ -87,7 +91,7 @@ struct LSQ_ENTRY {
   std::vector<std::reference_wrapper<std::optional<LSQ_ENTRY>>> lq_depend_on_me{};
 
   LSQ_ENTRY(uint64_t id, uint64_t addr, uint64_t ip, std::array<uint8_t, 2> asid);
-  void finish(std::deque<ooo_model_instr>::iterator begin, std::deque<ooo_model_instr>::iterator end) const;
+  void finish(champsim::circular_buffer<ooo_model_instr>::iterator begin, champsim::circular_buffer<ooo_model_instr>::iterator end) const;
 };
 
 // cpu
@@ -110,6 +114,10 @@ public:
 
   bool show_heartbeat = true;
 
+  // When cores are operated concurrently, console output is held here and printed by the simulation loop in core order
+  bool defer_output = false;
+  std::string deferred_output{};
+
   using stats_type = cpu_stats;
 
   stats_type roi_stats{}, sim_stats{};
@@ -123,16 +131,28 @@ public:
   dib_type DIB;
 
   // reorder buffer, load/store queue, register file
-  std::deque<ooo_model_instr> IFETCH_BUFFER;
-  std::deque<ooo_model_instr> DISPATCH_BUFFER;
-  std::deque<ooo_model_instr> DECODE_BUFFER;
-  std::deque<ooo_model_instr> ROB;
+  champsim::circular_buffer<ooo_model_instr> IFETCH_BUFFER;
+  champsim::circular_buffer<ooo_model_instr> DISPATCH_BUFFER;
+  champsim::circular_buffer<ooo_model_instr> DECODE_BUFFER;
+  champsim::circular_buffer<ooo_model_instr> ROB;
 
   std::vector<std::optional<LSQ_ENTRY>> LQ;
-  std::deque<LSQ_ENTRY> SQ;
+  champsim::circular_buffer<LSQ_ENTRY> SQ;
+
+  // The free entries of the LQ, and the youngest store in the SQ to each address, for store-to-load forwarding
+  champsim::slot_bitmap LQ_free_slots;
+  std::unordered_map<uint64_t, std::reference_wrapper<LSQ_ENTRY>> SQ_youngest_store;
 
   std::array<std::vector<std::reference_wrapper<ooo_model_instr>>, std::numeric_limits<uint8_t>::max() + 1> reg_producers;
 
+  // Instructions are tracked through scheduling and execution so that each stage visits only its candidates, rather than the whole ROB.
+  // The ROB entries before schedule_head have been scheduled, and num_scheduled_unexecuted of them have not yet begun to execute.
+  // Ready and inflight instructions are kept in program order.
+  std::size_t schedule_head = 0;
+  long num_scheduled_unexecuted = 0;
+  std::vector<std::reference_wrapper<ooo_model_instr>> ready_instrs;
+  std::vector<std::reference_wrapper<ooo_model_instr>> inflight_instrs;
+
   // Constants
   const std::size_t IFETCH_BUFFER_SIZE, DISPATCH_BUFFER_SIZE, DECODE_BUFFER_SIZE, ROB_SIZE, SQ_SIZE;
   const long int FETCH_WIDTH, DECODE_WIDTH, DISPATCH_WIDTH, SCHEDULER_SIZE, EXEC_WIDTH;
@@ -145,13 +165,14 @@ public:
   uint64_t fetch_resume_cycle = 0;
 
   const long IN_QUEUE_SIZE = 2 * FETCH_WIDTH;
-  std::deque<ooo_model_instr> input_queue;
+  champsim::circular_buffer<ooo_model_instr> input_queue;
 
   CacheBus L1I_bus, L1D_bus;
   CACHE* l1i;
 
   void initialize() override final;
   long operate() override final;
+  uint64_t next_event_cycle() const override final;
   void begin_phase() override final;
   void end_phase(unsigned cpu) override final;
 
@@ -171,7 +192,7 @@ public:
   bool do_init_instruction(ooo_model_instr& instr);
   bool do_predict_branch(ooo_model_instr& instr);
   void do_check_dib(ooo_model_instr& instr);
-  bool do_fetch_instruction(std::deque<ooo_model_instr>::iterator begin, std::deque<ooo_model_instr>::iterator end);
+  bool do_fetch_instruction(champsim::circular_buffer<ooo_model_instr>::iterator begin, champsim::circular_buffer<ooo_model_instr>::iterator end);
   void do_dib_update(const ooo_model_instr& instr);
   void do_scheduling(ooo_model_instr& instr);
   void do_execution(ooo_model_instr& rob_it);
@@ -180,6 +201,8 @@ public:
   void do_sq_forward_to_lq(LSQ_ENTRY& sq_entry, LSQ_ENTRY& lq_entry);
 
   void do_finish_store(const LSQ_ENTRY& sq_entry);
+  void release_lq_entry(std::optional<LSQ_ENTRY>& lq_entry);
+  void release_sq_entry(champsim::circular_buffer<LSQ_ENTRY>::const_iterator sq_entry);
   bool do_complete_store(const LSQ_ENTRY& sq_entry);
   bool execute_load(const LSQ_ENTRY& lq_entry);
 
@@ -452,13 +475,16 @@ public:
   template <unsigned long long B_FLAG, unsigned long long T_FLAG>
   explicit O3_CPU(Builder<B_FLAG, T_FLAG> b)
       : champsim::operable(b.m_freq_scale), cpu(b.m_cpu), DIB(b.m_dib_set, b.m_dib_way, {champsim::lg2(b.m_dib_window)}, {champsim::lg2(b.m_dib_window)}),
-        LQ(b.m_lq_size), IFETCH_BUFFER_SIZE(b.m_ifetch_buffer_size), DISPATCH_BUFFER_SIZE(b.m_dispatch_buffer_size), DECODE_BUFFER_SIZE(b.m_decode_buffer_size),
+        IFETCH_BUFFER(b.m_ifetch_buffer_size), DISPATCH_BUFFER(b.m_dispatch_buffer_size), DECODE_BUFFER(b.m_decode_buffer_size), ROB(b.m_rob_size),
+        LQ(b.m_lq_size), SQ(b.m_sq_size), LQ_free_slots(b.m_lq_size), IFETCH_BUFFER_SIZE(b.m_ifetch_buffer_size), DISPATCH_BUFFER_SIZE(b.m_dispatch_buffer_size), DECODE_BUFFER_SIZE(b.m_decode_buffer_size),
         ROB_SIZE(b.m_rob_size), SQ_SIZE(b.m_sq_size), FETCH_WIDTH(b.m_fetch_width), DECODE_WIDTH(b.m_decode_width), DISPATCH_WIDTH(b.m_dispatch_width),
         SCHEDULER_SIZE(b.m_schedule_width), EXEC_WIDTH(b.m_execute_width), LQ_WIDTH(b.m_lq_width), SQ_WIDTH(b.m_sq_width), RETIRE_WIDTH(b.m_retire_width),
         BRANCH_MISPREDICT_PENALTY(b.m_mispredict_penalty), DISPATCH_LATENCY(b.m_dispatch_latency), DECODE_LATENCY(b.m_decode_latency),
         SCHEDULING_LATENCY(b.m_schedule_latency), EXEC_LATENCY(b.m_execute_latency), L1I_BANDWIDTH(b.m_l1i_bw), L1D_BANDWIDTH(b.m_l1d_bw),
-        L1I_bus(b.m_cpu, b.m_fetch_queues), L1D_bus(b.m_cpu, b.m_data_queues), l1i(b.m_l1i), module_pimpl(std::make_unique<module_model<B_FLAG, T_FLAG>>(this))
+        input_queue(static_cast<std::size_t>(IN_QUEUE_SIZE)), L1I_bus(b.m_cpu, b.m_fetch_queues), L1D_bus(b.m_cpu, b.m_data_queues), l1i(b.m_l1i), module_pimpl(std::make_unique<module_model<B_FLAG, T_FLAG>>(this))
   {
+    ready_instrs.reserve(ROB_SIZE);
+    inflight_instrs.reserve(ROB_SIZE);
   }
 };
 
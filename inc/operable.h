@@ -17,38 +17,93 @@
 #ifndef OPERABLE_H
 #define OPERABLE_H
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+
 namespace champsim
 {
+// Find the fraction closest to the given value, with a bounded denominator, by its continued fraction expansion
+inline std::pair<uint64_t, uint64_t> rational_approximation(double value, uint64_t max_denominator = (1ull << 20))
+{
+  uint64_t num = static_cast<uint64_t>(std::floor(value)), den = 1;
+  uint64_t prev_num = 1, prev_den = 0;
+  auto remainder = value - std::floor(value);
+  while (std::abs(value - static_cast<double>(num) / static_cast<double>(den)) > value * 1e-12) {
+    auto inverse = 1 / remainder;
+    auto term = static_cast<uint64_t>(std::floor(inverse));
+    remainder = inverse - std::floor(inverse);
+    if (term > max_denominator || term * den + prev_den > max_denominator)
+      break;
+    prev_num = std::exchange(num, term * num + prev_num);
+    prev_den = std::exchange(den, term * den + prev_den);
+  }
+  return {num, den};
+}
 
 class operable
 {
+  static std::pair<uint64_t, uint64_t> clock_period(double scale) { return rational_approximation(std::max(scale, 1.0)); }
+
 public:
-  const double CLOCK_SCALE;
+  // The period of this clock, relative to the fastest clock in the system, as the fraction CLOCK_PERIOD_NUM / CLOCK_PERIOD_DEN
+  const uint64_t CLOCK_PERIOD_NUM, CLOCK_PERIOD_DEN;
 
-  double leap_operation = 0;
+  // The accumulated lag behind the fastest clock, in units of 1/CLOCK_PERIOD_DEN of its cycles
+  uint64_t leap_operation = 0;
   uint64_t current_cycle = 0;
+  uint64_t idle_until_cycle = 0;
   bool warmup = true;
 
-  explicit operable(double scale) : CLOCK_SCALE(scale - 1) {}
+  explicit operable(double scale) : CLOCK_PERIOD_NUM(clock_period(scale).first), CLOCK_PERIOD_DEN(clock_period(scale).second) {}
+
+  // Whether this operable will skip the next cycle of the fastest clock
+  bool leaps() const { return leap_operation >= CLOCK_PERIOD_DEN; }
 
   long _operate()
   {
     // skip periodically
-    if (leap_operation >= 1) {
-      leap_operation -= 1;
+    if (leaps()) {
+      leap_operation -= CLOCK_PERIOD_DEN;
       return 0;
     }
 
     auto result = operate();
 
-    leap_operation += CLOCK_SCALE;
+    leap_operation += CLOCK_PERIOD_NUM - CLOCK_PERIOD_DEN;
     ++current_cycle;
 
     return result;
   }
 
+  // Advance the clock exactly as _operate() would, on a cycle where operate() is known to do no work.
+  // Returns true if the idle hook changed state that may produce work on a later cycle.
+  bool _skip()
+  {
+    if (leaps()) {
+      leap_operation -= CLOCK_PERIOD_DEN;
+      return false;
+    }
+
+    auto woken = operate_idle();
+
+    leap_operation += CLOCK_PERIOD_NUM - CLOCK_PERIOD_DEN;
+    ++current_cycle;
+
+    return woken;
+  }
+
   virtual void initialize() {} // LCOV_EXCL_LINE
   virtual long operate() = 0;
+
+  // The earliest cycle (in this operable's clock) on which operate() might do any work, assuming that no other operable changes its inputs.
+  // The default is conservative: the operable may always have work to do.
+  virtual uint64_t next_event_cycle() const { return current_cycle; }
+
+  // Performed instead of operate() on skipped cycles, for state that advances every cycle regardless of events
+  virtual bool operate_idle() { return false; } // LCOV_EXCL_LINE
+
   virtual void begin_phase() {}       // LCOV_EXCL_LINE
   virtual void end_phase(unsigned) {} // LCOV_EXCL_LINE
   virtual void print_deadlock() {}    // LCOV_EXCL_LINE
@@ -66,9 +66,6 @@ class PageTableWalker : public champsim::operable
   std::deque<mshr_type> finished;
   std::deque<mshr_type> completed;
 
-  std::vector<channel_type*> upper_levels;
-  channel_type* lower_level;
-
   std::optional<mshr_type> handle_read(const request_type& pkt, channel_type* ul);
   std::optional<mshr_type> handle_fill(const mshr_type& pkt);
   std::optional<mshr_type> step_translation(const mshr_type& source);
@@ -76,6 +73,9 @@ class PageTableWalker : public champsim::operable
   void finish_packet(const response_type& packet);
 
 public:
+  std::vector<channel_type*> upper_levels;
+  channel_type* lower_level;
+
   const std::string NAME;
   const uint32_t MSHR_SIZE;
   const long int MAX_READ, MAX_FILL;
@@ -163,6 +163,7 @@ public:
   explicit PageTableWalker(Builder builder);
 
   long operate() override final;
+  uint64_t next_event_cycle() const override final;
 
   void begin_phase() override final;
   void print_deadlock() override final;
@@ -0,0 +1,51 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef REGION_H
+#define REGION_H
+
+#include <cstdint>
+#include <istream>
+#include <vector>
+
+#include "phase_info.h"
+
+namespace champsim
+{
+/**
+ * A region of a trace to be simulated, such as a SimPoint. The warmup phase begins at start - warmup, and the simulation phase at start.
+ */
+struct region_info {
+  uint64_t start;
+  uint64_t warmup;
+  uint64_t length;
+  double weight;
+};
+
+/**
+ * Read a list of regions, one per line, each given as "start warmup length weight".
+ * Blank lines and lines beginning with '#' are ignored. Throws std::invalid_argument if a line cannot be read, or if a warmup would begin before the start of the trace.
+ */
+std::vector<region_info> read_regions(std::istream& in);
+
+/**
+ * Combine the statistics of several simulations of the same configuration, multiplying each counter by the weight of its simulation.
+ * If the weights sum to one, the result describes a simulation of the average length of the regions.
+ */
+phase_stats weighted_sum(const std::vector<phase_stats>& stats, const std::vector<double>& weights);
+} // namespace champsim
+
+#endif
@@ -18,9 +18,11 @@
 #define REPEATABLE_H
 
 #include <memory>
+#include <stdexcept>
 #include <string>
 
 #include "instruction.h"
+#include "util/detect.h"
 #include <fmt/ranges.h>
 
 namespace champsim
@@ -33,17 +35,48 @@ struct repeatable {
   T intern_{std::apply([](auto... x) { return T{x...}; }, args_)};
   explicit repeatable(Args... args) : args_(args...) {}
 
-  auto operator()()
+  template <typename U>
+  using has_rewind = decltype(std::declval<U&>().rewind());
+
+  // Start the trace again, rewinding it in place if it can, and otherwise reopening it
+  void restart()
   {
-    // Reopen trace if we've reached the end of the file
-    if (intern_.eof()) {
-      fmt::print("*** Reached end of trace: {}\n", args_);
-      intern_ = T{std::apply([](auto... x) { return T{x...}; }, args_)};
+    fmt::print("*** Reached end of trace: {}\n", args_);
+    if constexpr (champsim::is_detected_v<has_rewind, T>) {
+      if (intern_.rewind())
+        return;
     }
+    intern_ = T{std::apply([](auto... x) { return T{x...}; }, args_)};
+  }
+
+  auto operator()()
+  {
+    // Restart the trace if we've reached the end of the file
+    if (intern_.eof())
+      restart();
 
     return intern_();
   }
 
+  template <typename It>
+  auto operator()(It first, It last) -> decltype(std::declval<T&>()(first, last))
+  {
+    while (first != last) {
+      // Restart the trace if we've reached the end of the file
+      bool restarted = intern_.eof();
+      if (restarted)
+        restart();
+
+      // A trace that gives nothing once it is restarted is empty, and would be restarted forever
+      auto filled = intern_(first, last);
+      if (restarted && filled == first)
+        throw std::runtime_error{fmt::format("The trace {} has no instructions to repeat", args_)};
+      first = filled;
+    }
+
+    return first;
+  }
+
   bool eof() const { return false; }
 };
 } // namespace champsim
@@ -0,0 +1,80 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SYNTHETIC_TRACE_H
+#define SYNTHETIC_TRACE_H
+
+#include <cstdint>
+#include <random>
+#include <string_view>
+
+#include "instruction.h"
+
+namespace champsim
+{
+namespace synthetic
+{
+enum class workload { stream, stride, chase, random, branch };
+
+struct parameters {
+  workload kind = workload::stream;
+  uint64_t footprint = uint64_t{1} << 30; // bytes of data accessed
+  uint64_t stride = 8;                    // bytes between accesses, or the size of each access in chase and random
+  uint64_t work = 1;                      // non-memory instructions in each iteration
+  double mispredict = 0.1;                // fraction of the branch workload's conditional branches that go against their bias
+  uint64_t seed = 0;
+};
+
+// Parse a size such as 64, 4K, 16M, or 1G, in which the suffixes are powers of 1024
+uint64_t parse_size(std::string_view size);
+
+// Parse a workload of the form gen:KIND[:PARAMETER=VALUE]...
+parameters parse(std::string_view spec);
+} // namespace synthetic
+
+/**
+ * Generates the instructions of a synthetic workload, without reading a file. Each iteration of its loop is a load (except in the branch
+ * workload), a number of non-memory instructions, and a loop branch that is always taken:
+ *
+ *  - stream: loads each stride of the footprint in order, wrapping around at its end
+ *  - stride: the same, with a stride of a page by default
+ *  - chase: each load depends on the previous one, and visits every stride of the footprint once in a scrambled order
+ *  - random: independent loads of uniformly random strides of the footprint
+ *  - branch: no loads, and a conditional branch that is taken except for a random fraction of the iterations
+ *
+ * The workload is reproducible for a given seed.
+ */
+class synthetic_trace
+{
+  uint8_t cpu;
+  synthetic::parameters params;
+  std::mt19937_64 rng;
+
+  uint64_t iteration = 0;
+  uint64_t body_pos = 0;  // the position of the next instruction in the loop body
+  uint64_t num_lines = 0; // the number of strides in the footprint
+
+  uint64_t next_address();
+
+public:
+  synthetic_trace(uint8_t cpu_idx, synthetic::parameters parameters);
+
+  ooo_model_instr operator()();
+  bool eof() const { return false; }
+};
+} // namespace champsim
+
+#endif
@@ -0,0 +1,51 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRACE_CACHE_H
+#define TRACE_CACHE_H
+
+#include <functional>
+#include <optional>
+#include <ostream>
+#include <string>
+
+namespace champsim
+{
+/**
+ * A directory of decompressed traces, shared by every process that uses it.
+ *
+ * Each trace is decompressed by the first process to ask for it, and later readers map the decompressed copy instead. Copies are named for
+ * the path, modification time, and size of the trace, so a trace that changes is decompressed again. Old copies are not removed.
+ */
+class trace_cache
+{
+  std::string directory_;
+
+public:
+  explicit trace_cache(std::string directory);
+
+  // The name that the decompressed copy of the trace would have, or std::nullopt if the trace does not exist
+  std::optional<std::string> cached_name(const std::string& fname) const;
+
+  /**
+   * Return the name of a decompressed copy of the trace, writing it with the given function if no process has done so already.
+   * Returns std::nullopt if the copy could not be written.
+   */
+  std::optional<std::string> get(const std::string& fname, const std::function<void(std::ostream&)>& decompress) const;
+};
+} // namespace champsim
+
+#endif
@@ -0,0 +1,194 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRACE_FORMAT_H
+#define TRACE_FORMAT_H
+
+#include <fstream>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "async_reader.h"
+#include "compact_trace.h"
+#include "mapped_file.h"
+#include "repeatable.h"
+#include "trace_cache.h"
+#include "tracereader.h"
+#include <fmt/core.h>
+
+namespace champsim
+{
+/**
+ * How a trace should be read, independent of its format.
+ */
+struct trace_options {
+  uint8_t cpu = 0;
+  bool repeat = false;
+  bool async = false;
+  uint64_t skip_instructions = 0;
+  std::string cache_directory = {};
+  bool cloudsuite = false; // Whether the records are cloudsuite records, unless the trace is in a format that gives their type
+};
+
+/**
+ * A way of reading traces. A format claims a trace by its name or by the first bytes of the file, which are empty if there is no such file.
+ */
+struct trace_format {
+  std::string name;
+  std::function<bool(const std::string& fname, std::string_view header)> matches;
+  std::function<tracereader(const std::string& fname, const trace_options& options)> make_reader;
+};
+
+/**
+ * Make a format available to get_tracereader(). Formats are tried in the order they are registered, and a trace that no format claims is
+ * read as an uncompressed file.
+ */
+void register_trace_format(trace_format format);
+
+/**
+ * Find the format that claims the given trace. A trace that is not a regular file, such as a pipe, is not opened to find its format. It is
+ * decompressed if its name ends in .xz, .gz, .bz2, or .zst, and is otherwise read as an uncompressed stream.
+ */
+const trace_format& find_trace_format(const std::string& fname);
+
+/**
+ * Whether a registered format claims the trace. A trace that is not a file, such as a generated one, must be claimed by a format.
+ */
+bool is_registered_trace(const std::string& fname);
+
+/**
+ * Registers a format when constructed, so that a format may be added by defining one of these at namespace scope.
+ */
+struct trace_format_registration {
+  explicit trace_format_registration(trace_format format) { register_trace_format(std::move(format)); }
+};
+
+namespace trace_formats
+{
+inline bool has_magic(std::string_view header, std::string_view magic) { return header.substr(0, std::size(magic)) == magic; }
+
+template <typename T, typename S>
+using repeatable_reader_t = champsim::repeatable<champsim::bulk_tracereader<T, S>, uint8_t, std::string, uint64_t>;
+
+template <typename T, typename S>
+using async_reader_t = champsim::async_reader<champsim::bulk_tracereader<T, S>>;
+
+template <typename T, typename S>
+using async_repeatable_reader_t = champsim::async_reader<repeatable_reader_t<T, S>>;
+
+template <typename S>
+void copy_stream(S&& in, std::ostream& out)
+{
+  std::vector<char> buffer(1 << 20);
+  do {
+    in.read(std::data(buffer), static_cast<std::streamsize>(std::size(buffer)));
+    out.write(std::data(buffer), in.gcount());
+  } while (!in.eof() && in.gcount() > 0);
+}
+
+template <template <class, class> typename R, typename T, typename S>
+tracereader make_reader_of_kind(const std::string& fname, const trace_options& options)
+{
+  if constexpr (!std::is_same_v<S, champsim::mapped_file>) {
+    // A compressed trace may be read from a decompressed copy in the cache
+    if (!std::empty(options.cache_directory)) {
+      auto cached = champsim::trace_cache{options.cache_directory}.get(fname, [&fname](std::ostream& out) { copy_stream(S{fname}, out); });
+      if (cached.has_value())
+        return tracereader{R<T, champsim::mapped_file>(options.cpu, *cached, options.skip_instructions)};
+      fmt::print("WARNING: a decompressed copy of {} could not be written to {}\n", fname, options.cache_directory);
+    }
+  }
+  return tracereader{R<T, S>(options.cpu, fname, options.skip_instructions)};
+}
+
+// Read records of type T from the stream S
+template <typename T, typename S>
+tracereader make_record_reader(const std::string& fname, const trace_options& options)
+{
+  if (options.async) {
+    if (options.repeat)
+      return make_reader_of_kind<async_repeatable_reader_t, T, S>(fname, options);
+    else
+      return make_reader_of_kind<async_reader_t, T, S>(fname, options);
+  } else {
+    if (options.repeat)
+      return make_reader_of_kind<repeatable_reader_t, T, S>(fname, options);
+    else
+      return make_reader_of_kind<champsim::bulk_tracereader, T, S>(fname, options);
+  }
+}
+
+// Read the trace through the stream S, detecting whether it is compact. The records of a trace that is not compact are standard unless the
+// options say otherwise.
+template <typename S>
+tracereader make_stream_reader(const std::string& fname, const trace_options& options)
+{
+  std::string header(1 << 14, '\0');
+  {
+    S probe{fname};
+    probe.read(std::data(header), static_cast<std::streamsize>(std::size(header)));
+    header.resize(static_cast<std::size_t>(probe.gcount()));
+  }
+
+  if (auto record_size = compact_trace::get_header(header); record_size.has_value()) {
+    if (*record_size == sizeof(cloudsuite_instr))
+      return make_record_reader<cloudsuite_instr, champsim::compact_trace_reader<cloudsuite_instr, S>>(fname, options);
+    return make_record_reader<input_instr, champsim::compact_trace_reader<input_instr, S>>(fname, options);
+  }
+
+  if (options.cloudsuite)
+    return make_record_reader<cloudsuite_instr, S>(fname, options);
+  return make_record_reader<input_instr, S>(fname, options);
+}
+
+// Read the trace through the stream S without probing it, because it can be read only once. The records are standard unless the options say otherwise.
+// Such a trace has no identity to find a decompressed copy by, so it is never cached.
+template <typename S>
+tracereader make_unprobed_reader(const std::string& fname, const trace_options& options)
+{
+  auto stream_options = options;
+  stream_options.cache_directory.clear();
+  if (options.cloudsuite)
+    return make_record_reader<cloudsuite_instr, S>(fname, stream_options);
+  return make_record_reader<input_instr, S>(fname, stream_options);
+}
+} // namespace trace_formats
+
+/**
+ * A format for traces that are read through the stream S, which may decompress them. Traces in the compact format are recognized from the
+ * bytes that S produces.
+ */
+template <typename S>
+trace_format stream_trace_format(std::string name, std::function<bool(const std::string&, std::string_view)> matches)
+{
+  return trace_format{std::move(name), std::move(matches), &trace_formats::make_stream_reader<S>};
+}
+
+/**
+ * A format for traces that are read through the stream S, and that begin with the given magic bytes.
+ */
+template <typename S>
+trace_format stream_trace_format(std::string name, std::string magic)
+{
+  return stream_trace_format<S>(std::move(name), [magic](const std::string&, std::string_view header) { return trace_formats::has_magic(header, magic); });
+}
+} // namespace champsim
+
+#endif
@@ -17,11 +17,15 @@
 #ifndef TRACEREADER_H
 #define TRACEREADER_H
 
+#include <atomic>
 #include <cstring>
 #include <deque>
+#include <iterator>
 #include <memory>
 #include <numeric>
+#include <optional>
 #include <string>
+#include <vector>
 
 #include "instruction.h"
 #include "util/detect.h"
@@ -30,10 +34,12 @@ namespace champsim
 {
 class tracereader
 {
-  static uint64_t instr_unique_id;
+  // Shared by all readers, which may be used on different threads
+  static std::atomic<uint64_t> instr_unique_id;
   struct reader_concept {
     virtual ~reader_concept() = default;
     virtual ooo_model_instr operator()() = 0;
+    virtual ooo_model_instr* operator()(ooo_model_instr* first, ooo_model_instr* last) = 0;
     virtual bool eof() const = 0;
   };
 
@@ -45,7 +51,22 @@ class tracereader
     template <typename U>
     using has_eof = decltype(std::declval<U>().eof());
 
+    template <typename U>
+    using has_bulk_read = decltype(std::declval<U&>()(std::declval<ooo_model_instr*>(), std::declval<ooo_model_instr*>()));
+
     ooo_model_instr operator()() override { return intern_(); }
+    ooo_model_instr* operator()(ooo_model_instr* first, ooo_model_instr* last) override
+    {
+      if constexpr (champsim::is_detected_v<has_bulk_read, T>) {
+        return intern_(first, last);
+      } else {
+        // If a bulk read is not provided, read one instruction at a time
+        for (; first != last && !eof(); ++first)
+          *first = intern_();
+        return first;
+      }
+    }
+
     bool eof() const override
     {
       if constexpr (champsim::is_detected_v<has_eof, T>)
@@ -65,13 +86,32 @@ public:
   auto operator()()
   {
     auto retval = (*pimpl_)();
-    retval.instr_id = instr_unique_id++;
+    retval.instr_id = instr_unique_id.fetch_add(1, std::memory_order_relaxed);
     return retval;
   }
 
+  /**
+   * Fill the range [first, last) with instructions from the trace, stopping early if the trace ends.
+   * Returns the end of the range that was filled.
+   */
+  ooo_model_instr* operator()(ooo_model_instr* first, ooo_model_instr* last)
+  {
+    auto filled = (*pimpl_)(first, last);
+    auto id = instr_unique_id.fetch_add(static_cast<uint64_t>(std::distance(first, filled)), std::memory_order_relaxed);
+    for (auto it = first; it != filled; ++it)
+      it->instr_id = id++;
+    return filled;
+  }
+
   auto eof() const { return pimpl_->eof(); }
 };
 
+/**
+ * A trace that cannot seek is kept in memory as it is read if it is no larger than this many bytes, so that it can be repeated without
+ * reopening it.
+ */
+inline std::size_t max_buffered_trace_bytes = std::size_t{64} << 20;
+
 template <typename T, typename F>
 class bulk_tracereader
 {
@@ -86,13 +126,59 @@ class bulk_tracereader
   constexpr static std::size_t refresh_thresh = 1;
   std::deque<ooo_model_instr> instr_buffer;
 
+  template <typename U>
+  using has_view = decltype(std::declval<U&>().view(std::size_t{}));
+
+  template <typename U>
+  using has_seek = decltype(std::declval<U&>().seek(uint64_t{}));
+
+  template <typename U>
+  using has_size_hint = decltype(std::declval<const U&>().size_hint());
+
+  uint64_t skip_instructions = 0;
+
+  // The bytes read so far, if the file cannot seek and the trace is small enough to keep in memory
+  std::vector<char> recording;
+  bool recording_valid = !champsim::is_detected_v<has_seek, F>;
+  std::optional<std::size_t> replay_pos; // Set when the trace is read from the recording
+  bool replay_eof = false;
+
+  void refill();
+  void skip(uint64_t count);
+  std::size_t read_bytes(char* s, std::size_t count);
+  bool source_eof() const { return replay_pos.has_value() ? replay_eof : trace_file.eof(); }
+
+  // A trace that is known to be too large is never recorded
+  void check_size_hint()
+  {
+    if constexpr (champsim::is_detected_v<has_size_hint, F>) {
+      auto size = trace_file.size_hint();
+      recording_valid = recording_valid && !(size.has_value() && *size > max_buffered_trace_bytes);
+    }
+  }
+
 public:
   ooo_model_instr operator()();
+  ooo_model_instr* operator()(ooo_model_instr* first, ooo_model_instr* last);
 
-  bulk_tracereader(uint8_t cpu_idx, std::string tf) : cpu(cpu_idx), trace_file(tf) {}
-  bulk_tracereader(uint8_t cpu_idx, F&& file) : cpu(cpu_idx), trace_file(std::move(file)) {}
+  /**
+   * Open the trace, beginning after the first skip_instructions instructions.
+   * If the file can seek, this takes constant time. Otherwise, the skipped instructions are read and discarded.
+   */
+  bulk_tracereader(uint8_t cpu_idx, std::string tf, uint64_t skip_instrs = 0) : cpu(cpu_idx), trace_file(tf), skip_instructions(skip_instrs)
+  {
+    check_size_hint();
+    skip(skip_instructions);
+  }
+  bulk_tracereader(uint8_t cpu_idx, F&& file) : cpu(cpu_idx), trace_file(std::move(file)) { check_size_hint(); }
 
-  bool eof() const { return trace_file.eof() && std::size(instr_buffer) <= refresh_thresh; }
+  /**
+   * Return to the first instruction without reopening the file. This is possible if the file can seek, or if the whole trace has been read
+   * and kept in memory. Returns false if it is not possible.
+   */
+  bool rewind();
+
+  bool eof() const { return source_eof() && std::size(instr_buffer) <= refresh_thresh; }
 };
 
 ooo_model_instr apply_branch_target(ooo_model_instr branch, const ooo_model_instr& target);
@@ -105,39 +191,126 @@ void set_branch_targets(It begin, It end)
 }
 
 template <typename T, typename F>
-ooo_model_instr bulk_tracereader<T, F>::operator()()
+void bulk_tracereader<T, F>::refill()
 {
-  if (std::size(instr_buffer) <= refresh_thresh) {
-    std::array<T, buffer_size - refresh_thresh> trace_read_buf;
-    std::array<char, std::size(trace_read_buf) * sizeof(T)> raw_buf;
-    std::size_t bytes_read;
-
-    // Read from trace file
-    trace_file.read(std::data(raw_buf), std::size(raw_buf));
-    bytes_read = static_cast<std::size_t>(trace_file.gcount());
+  if constexpr (champsim::is_detected_v<has_view, F>) {
+    // The file provides its bytes in place, so inflate directly from them
+    auto bytes = trace_file.view((buffer_size - refresh_thresh) * sizeof(T));
     eof_ = trace_file.eof();
 
-    // Transform bytes into trace format instructions
-    std::memcpy(std::data(trace_read_buf), std::data(raw_buf), bytes_read);
-
-    // Inflate trace format into core model instructions
-    auto begin = std::begin(trace_read_buf);
-    auto end = std::next(begin, bytes_read / sizeof(T));
-    std::transform(begin, end, std::back_inserter(instr_buffer), [cpu = this->cpu](T t) { return ooo_model_instr{cpu, t}; });
+    for (auto it = std::data(bytes); std::distance(it, std::data(bytes) + std::size(bytes)) >= static_cast<long>(sizeof(T)); it += sizeof(T)) {
+      T t;
+      std::memcpy(&t, it, sizeof(T));
+      instr_buffer.emplace_back(cpu, t);
+    }
 
-    // Set branch targets
     set_branch_targets(std::begin(instr_buffer), std::end(instr_buffer));
+    return;
   }
 
-  auto retval = instr_buffer.front();
+  std::array<T, buffer_size - refresh_thresh> trace_read_buf;
+  std::array<char, std::size(trace_read_buf) * sizeof(T)> raw_buf;
+  std::size_t bytes_read;
+
+  // Read from trace file
+  bytes_read = read_bytes(std::data(raw_buf), std::size(raw_buf));
+  eof_ = source_eof();
+
+  // Transform bytes into trace format instructions
+  std::memcpy(std::data(trace_read_buf), std::data(raw_buf), bytes_read);
+
+  // Inflate trace format into core model instructions
+  auto begin = std::begin(trace_read_buf);
+  auto end = std::next(begin, bytes_read / sizeof(T));
+  std::transform(begin, end, std::back_inserter(instr_buffer), [cpu = this->cpu](T t) { return ooo_model_instr{cpu, t}; });
+
+  // Set branch targets
+  set_branch_targets(std::begin(instr_buffer), std::end(instr_buffer));
+}
+
+template <typename T, typename F>
+void bulk_tracereader<T, F>::skip(uint64_t count)
+{
+  if constexpr (champsim::is_detected_v<has_seek, F>) {
+    trace_file.seek(count * sizeof(T));
+  } else {
+    std::array<char, buffer_size * sizeof(T)> discard_buf;
+    for (auto remaining = count * sizeof(T); remaining > 0 && !trace_file.eof(); remaining -= static_cast<uint64_t>(trace_file.gcount()))
+      trace_file.read(std::data(discard_buf), static_cast<std::streamsize>(std::min<uint64_t>(remaining, std::size(discard_buf))));
+  }
+}
+
+template <typename T, typename F>
+std::size_t bulk_tracereader<T, F>::read_bytes(char* s, std::size_t count)
+{
+  if (replay_pos.has_value()) {
+    auto bytes_read = std::min(count, std::size(recording) - *replay_pos);
+    std::memcpy(s, std::next(std::data(recording), static_cast<long>(*replay_pos)), bytes_read);
+    *replay_pos += bytes_read;
+    replay_eof = (bytes_read < count);
+    return bytes_read;
+  }
+
+  trace_file.read(s, static_cast<std::streamsize>(count));
+  auto bytes_read = static_cast<std::size_t>(trace_file.gcount());
+  if (recording_valid) {
+    recording_valid = (std::size(recording) + bytes_read <= max_buffered_trace_bytes);
+    if (recording_valid)
+      recording.insert(std::end(recording), s, std::next(s, static_cast<long>(bytes_read)));
+    else
+      recording = std::vector<char>{};
+  }
+  return bytes_read;
+}
+
+template <typename T, typename F>
+bool bulk_tracereader<T, F>::rewind()
+{
+  if constexpr (champsim::is_detected_v<has_seek, F>) {
+    trace_file.seek(skip_instructions * sizeof(T));
+  } else {
+    if (!recording_valid || !trace_file.eof())
+      return false;
+    replay_pos = 0;
+    replay_eof = false;
+  }
+
+  instr_buffer.clear();
+  eof_ = false;
+  return true;
+}
+
+template <typename T, typename F>
+ooo_model_instr bulk_tracereader<T, F>::operator()()
+{
+  if (std::size(instr_buffer) <= refresh_thresh)
+    refill();
+
+  auto retval = std::move(instr_buffer.front());
   instr_buffer.pop_front();
 
   return retval;
 }
 
+template <typename T, typename F>
+ooo_model_instr* bulk_tracereader<T, F>::operator()(ooo_model_instr* first, ooo_model_instr* last)
+{
+  for (; first != last && !eof(); ++first) {
+    if (std::size(instr_buffer) <= refresh_thresh)
+      refill();
+
+    *first = std::move(instr_buffer.front());
+    instr_buffer.pop_front();
+  }
+
+  return first;
+}
+
 std::string get_fptr_cmd(std::string_view fname);
 } // namespace champsim
 
-champsim::tracereader get_tracereader(std::string fname, uint8_t cpu, bool is_cloudsuite, bool repeat);
+// The format of the trace is found by the formats registered in trace_format.h. Cloudsuite records are detected unless is_cloudsuite forces them.
+champsim::tracereader get_tracereader(std::string fname, uint8_t cpu, bool is_cloudsuite, bool repeat, bool async = false, uint64_t skip_instructions = 0,
+                                      std::string cache_directory = {});
 
 #endif
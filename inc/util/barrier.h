@@ -0,0 +1,60 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UTIL_BARRIER_H
+#define UTIL_BARRIER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+namespace champsim
+{
+/**
+ * A reusable barrier for a fixed number of threads.
+ * Threads synchronize once or twice per simulated cycle, so waiting threads spin briefly before yielding rather than sleeping.
+ */
+class spin_barrier
+{
+  constexpr static unsigned SPIN_LIMIT = 1024;
+
+  const std::ptrdiff_t expected;
+  std::atomic<std::ptrdiff_t> remaining;
+  std::atomic<uint64_t> phase{0};
+
+public:
+  explicit spin_barrier(std::ptrdiff_t count) : expected(count), remaining(count) {}
+
+  void arrive_and_wait()
+  {
+    auto arrival_phase = phase.load(std::memory_order_acquire);
+    if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      // Last to arrive: reset for the next phase, then release the waiters
+      remaining.store(expected, std::memory_order_relaxed);
+      phase.fetch_add(1, std::memory_order_acq_rel);
+      return;
+    }
+
+    for (unsigned spins = 0; phase.load(std::memory_order_acquire) == arrival_phase; ++spins) {
+      if (spins >= SPIN_LIMIT)
+        std::this_thread::yield();
+    }
+  }
+};
+} // namespace champsim
+
+#endif
@@ -0,0 +1,212 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UTIL_CIRCULAR_BUFFER_H
+#define UTIL_CIRCULAR_BUFFER_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace champsim
+{
+/**
+ * A double-ended queue with a capacity fixed at construction.
+ *
+ * Elements are kept in a ring of slots allocated once, so pushing and popping at either end never allocates,
+ * and references to elements remain valid until the element is removed.
+ */
+template <typename T>
+class circular_buffer
+{
+  std::vector<std::optional<T>> slots_;
+  std::size_t head_ = 0;
+  std::size_t size_ = 0;
+
+  std::size_t physical_index(std::size_t logical_index) const
+  {
+    auto idx = head_ + logical_index;
+    return (idx >= std::size(slots_)) ? idx - std::size(slots_) : idx;
+  }
+
+  template <bool IS_CONST>
+  class basic_iterator
+  {
+    using buffer_type = std::conditional_t<IS_CONST, const circular_buffer, circular_buffer>;
+    buffer_type* buffer_ = nullptr;
+    std::ptrdiff_t pos_ = 0;
+
+    friend class circular_buffer;
+    friend class basic_iterator<!IS_CONST>;
+
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<IS_CONST, const T*, T*>;
+    using reference = std::conditional_t<IS_CONST, const T&, T&>;
+
+    basic_iterator() = default;
+    basic_iterator(buffer_type* buf, difference_type pos) : buffer_(buf), pos_(pos) {}
+
+    // Allow conversion from iterator to const_iterator
+    template <bool OTHER_CONST, typename = std::enable_if_t<IS_CONST && !OTHER_CONST>>
+    basic_iterator(const basic_iterator<OTHER_CONST>& other) : buffer_(other.buffer_), pos_(other.pos_)
+    {
+    }
+
+    reference operator*() const { return (*buffer_)[static_cast<std::size_t>(pos_)]; }
+    pointer operator->() const { return &(**this); }
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    basic_iterator& operator+=(difference_type n)
+    {
+      pos_ += n;
+      return *this;
+    }
+    basic_iterator& operator-=(difference_type n) { return *this += -n; }
+    basic_iterator& operator++() { return *this += 1; }
+    basic_iterator& operator--() { return *this -= 1; }
+    basic_iterator operator++(int)
+    {
+      auto retval = *this;
+      ++(*this);
+      return retval;
+    }
+    basic_iterator operator--(int)
+    {
+      auto retval = *this;
+      --(*this);
+      return retval;
+    }
+
+    friend basic_iterator operator+(basic_iterator it, difference_type n) { return it += n; }
+    friend basic_iterator operator+(difference_type n, basic_iterator it) { return it += n; }
+    friend basic_iterator operator-(basic_iterator it, difference_type n) { return it -= n; }
+    friend difference_type operator-(const basic_iterator& lhs, const basic_iterator& rhs) { return lhs.pos_ - rhs.pos_; }
+
+    friend bool operator==(const basic_iterator& lhs, const basic_iterator& rhs) { return lhs.pos_ == rhs.pos_; }
+    friend bool operator!=(const basic_iterator& lhs, const basic_iterator& rhs) { return lhs.pos_ != rhs.pos_; }
+    friend bool operator<(const basic_iterator& lhs, const basic_iterator& rhs) { return lhs.pos_ < rhs.pos_; }
+    friend bool operator>(const basic_iterator& lhs, const basic_iterator& rhs) { return lhs.pos_ > rhs.pos_; }
+    friend bool operator<=(const basic_iterator& lhs, const basic_iterator& rhs) { return lhs.pos_ <= rhs.pos_; }
+    friend bool operator>=(const basic_iterator& lhs, const basic_iterator& rhs) { return lhs.pos_ >= rhs.pos_; }
+  };
+
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = T&;
+  using const_reference = const T&;
+  using iterator = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+
+  explicit circular_buffer(std::size_t capacity) : slots_(capacity) {}
+
+  iterator begin() { return {this, 0}; }
+  iterator end() { return {this, static_cast<difference_type>(size_)}; }
+  const_iterator begin() const { return {this, 0}; }
+  const_iterator end() const { return {this, static_cast<difference_type>(size_)}; }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+
+  reference operator[](size_type pos) { return *slots_[physical_index(pos)]; }
+  const_reference operator[](size_type pos) const { return *slots_[physical_index(pos)]; }
+  reference at(size_type pos)
+  {
+    if (pos >= size_)
+      throw std::out_of_range{"circular_buffer::at"};
+    return (*this)[pos];
+  }
+  const_reference at(size_type pos) const
+  {
+    if (pos >= size_)
+      throw std::out_of_range{"circular_buffer::at"};
+    return (*this)[pos];
+  }
+  reference front() { return (*this)[0]; }
+  const_reference front() const { return (*this)[0]; }
+  reference back() { return (*this)[size_ - 1]; }
+  const_reference back() const { return (*this)[size_ - 1]; }
+
+  bool empty() const { return size_ == 0; }
+  bool full() const { return size_ == std::size(slots_); }
+  size_type size() const { return size_; }
+  size_type capacity() const { return std::size(slots_); }
+
+  template <typename... Args>
+  reference emplace_back(Args&&... args)
+  {
+    assert(!full());
+    auto& slot = slots_[physical_index(size_)];
+    slot.emplace(std::forward<Args>(args)...);
+    ++size_;
+    return *slot;
+  }
+
+  void push_back(const T& value) { emplace_back(value); }
+  void push_back(T&& value) { emplace_back(std::move(value)); }
+
+  void pop_front()
+  {
+    assert(!empty());
+    slots_[head_].reset();
+    head_ = physical_index(1);
+    --size_;
+  }
+
+  void pop_back()
+  {
+    assert(!empty());
+    slots_[physical_index(size_ - 1)].reset();
+    --size_;
+  }
+
+  iterator erase(const_iterator first, const_iterator last)
+  {
+    auto num_erased = last - first;
+    if (first == cbegin()) {
+      // Erasing from the front only moves the head
+      for (auto i = num_erased; i > 0; --i)
+        pop_front();
+      return begin();
+    }
+
+    iterator dest{this, first.pos_};
+    std::move(iterator{this, last.pos_}, end(), dest);
+    for (auto i = num_erased; i > 0; --i)
+      pop_back();
+    return dest;
+  }
+
+  iterator erase(const_iterator pos) { return erase(pos, std::next(pos)); }
+
+  void clear()
+  {
+    while (!empty())
+      pop_back();
+  }
+};
+} // namespace champsim
+
+#endif
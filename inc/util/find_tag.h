@@ -0,0 +1,56 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UTIL_FIND_TAG_H
+#define UTIL_FIND_TAG_H
+
+#include <algorithm>
+#include <cstdint>
+
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
+namespace champsim
+{
+/**
+ * Find the first of a contiguous array of tags that is equal to the given tag, or last if there is none.
+ * If the compiler targets AVX2 or SSE4.1 (for example, with -march=native in CXXFLAGS), several tags are compared in each step.
+ */
+inline const uint64_t* find_tag(const uint64_t* first, const uint64_t* last, uint64_t tag)
+{
+#if defined(__AVX2__)
+  const auto needle = _mm256_set1_epi64x(static_cast<long long>(tag));
+  for (; last - first >= 4; first += 4) {
+    auto eq = _mm256_cmpeq_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(first)), needle);
+    auto mask = _mm256_movemask_pd(_mm256_castsi256_pd(eq));
+    if (mask != 0)
+      return first + __builtin_ctz(static_cast<unsigned>(mask));
+  }
+#elif defined(__SSE4_1__)
+  const auto needle = _mm_set1_epi64x(static_cast<long long>(tag));
+  for (; last - first >= 2; first += 2) {
+    auto eq = _mm_cmpeq_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(first)), needle);
+    auto mask = _mm_movemask_pd(_mm_castsi128_pd(eq));
+    if (mask != 0)
+      return first + __builtin_ctz(static_cast<unsigned>(mask));
+  }
+#endif
+  return std::find(first, last, tag);
+}
+} // namespace champsim
+
+#endif
@@ -0,0 +1,113 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UTIL_INLINE_VECTOR_H
+#define UTIL_INLINE_VECTOR_H
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+
+namespace champsim
+{
+/**
+ * A vector with a fixed capacity, whose elements are stored inline rather than on the heap.
+ * Copying and moving never allocate, so it is suited to small, bounded collections in objects that are moved often.
+ */
+template <typename T, std::size_t N>
+class inline_vector
+{
+  std::array<T, N> elements_{};
+  std::size_t size_ = 0;
+
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = T&;
+  using const_reference = const T&;
+  using pointer = T*;
+  using const_pointer = const T*;
+  using iterator = T*;
+  using const_iterator = const T*;
+
+  inline_vector() = default;
+
+  template <typename It>
+  inline_vector(It first, It last)
+  {
+    std::copy(first, last, std::back_inserter(*this));
+  }
+
+  iterator begin() { return std::data(elements_); }
+  iterator end() { return std::next(begin(), static_cast<difference_type>(size_)); }
+  const_iterator begin() const { return std::data(elements_); }
+  const_iterator end() const { return std::next(begin(), static_cast<difference_type>(size_)); }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+
+  pointer data() { return std::data(elements_); }
+  const_pointer data() const { return std::data(elements_); }
+
+  reference operator[](size_type pos) { return elements_[pos]; }
+  const_reference operator[](size_type pos) const { return elements_[pos]; }
+  reference front() { return elements_.front(); }
+  const_reference front() const { return elements_.front(); }
+  reference back() { return elements_[size_ - 1]; }
+  const_reference back() const { return elements_[size_ - 1]; }
+
+  bool empty() const { return size_ == 0; }
+  size_type size() const { return size_; }
+  constexpr static size_type capacity() { return N; }
+  constexpr static size_type max_size() { return N; }
+
+  void push_back(const T& value)
+  {
+    assert(size_ < N);
+    elements_[size_++] = value;
+  }
+
+  void pop_back()
+  {
+    assert(size_ > 0);
+    --size_;
+  }
+
+  void clear() { size_ = 0; }
+
+  iterator erase(const_iterator first, const_iterator last)
+  {
+    auto first_pos = std::distance(cbegin(), first);
+    auto num_erased = std::distance(first, last);
+    auto dest = std::next(begin(), first_pos);
+    std::move(std::next(dest, num_erased), end(), dest);
+    size_ -= static_cast<size_type>(num_erased);
+    return dest;
+  }
+
+  iterator erase(const_iterator pos) { return erase(pos, std::next(pos)); }
+
+  friend bool operator==(const inline_vector& lhs, const inline_vector& rhs)
+  {
+    return std::equal(std::begin(lhs), std::end(lhs), std::begin(rhs), std::end(rhs));
+  }
+  friend bool operator!=(const inline_vector& lhs, const inline_vector& rhs) { return !(lhs == rhs); }
+};
+} // namespace champsim
+
+#endif
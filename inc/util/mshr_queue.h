@@ -0,0 +1,165 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UTIL_MSHR_QUEUE_H
+#define UTIL_MSHR_QUEUE_H
+
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <unordered_map>
+
+namespace champsim
+{
+/**
+ * A queue of miss status holding registers, indexed by block address.
+ *
+ * Entries that have been returned from the lower level are kept at the front, in the order they were returned, followed by the entries still
+ * waiting for a response. Finding an entry by address, and moving it to the back of the returned entries, take constant time.
+ * At most one entry may exist for each block.
+ */
+template <typename T>
+class mshr_queue
+{
+  std::list<T> entries_;
+  typename std::list<T>::iterator returned_end_ = std::end(entries_);
+  std::size_t num_returned_ = 0;
+
+  struct index_entry {
+    typename std::list<T>::iterator position;
+    bool returned;
+  };
+  std::unordered_map<uint64_t, index_entry> index_;
+  unsigned shamt_;
+
+  uint64_t block_of(uint64_t address) const { return address >> shamt_; }
+
+  // Iterators into the list survive copies and moves only for the elements themselves, so the bookkeeping is rebuilt
+  void rebuild()
+  {
+    index_.clear();
+    returned_end_ = std::next(std::begin(entries_), static_cast<long>(num_returned_));
+    std::size_t pos = 0;
+    for (auto it = std::begin(entries_); it != std::end(entries_); ++it)
+      index_.insert_or_assign(block_of(it->address), index_entry{it, pos++ < num_returned_});
+  }
+
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = T&;
+  using const_reference = const T&;
+  using iterator = typename std::list<T>::iterator;
+  using const_iterator = typename std::list<T>::const_iterator;
+
+  explicit mshr_queue(unsigned offset_bits) : shamt_(offset_bits) {}
+
+  mshr_queue(const mshr_queue& other) : entries_(other.entries_), num_returned_(other.num_returned_), shamt_(other.shamt_) { rebuild(); }
+  mshr_queue(mshr_queue&& other) : entries_(std::move(other.entries_)), num_returned_(other.num_returned_), shamt_(other.shamt_) { rebuild(); }
+  mshr_queue& operator=(const mshr_queue& other)
+  {
+    entries_ = other.entries_;
+    num_returned_ = other.num_returned_;
+    shamt_ = other.shamt_;
+    rebuild();
+    return *this;
+  }
+  mshr_queue& operator=(mshr_queue&& other)
+  {
+    entries_ = std::move(other.entries_);
+    num_returned_ = other.num_returned_;
+    shamt_ = other.shamt_;
+    rebuild();
+    return *this;
+  }
+  ~mshr_queue() = default;
+
+  iterator begin() { return std::begin(entries_); }
+  iterator end() { return std::end(entries_); }
+  const_iterator begin() const { return std::cbegin(entries_); }
+  const_iterator end() const { return std::cend(entries_); }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+
+  // The end of the entries that have been returned
+  iterator returned_end() { return returned_end_; }
+  const_iterator returned_end() const { return returned_end_; }
+
+  reference front() { return entries_.front(); }
+  const_reference front() const { return entries_.front(); }
+  reference back() { return entries_.back(); }
+  const_reference back() const { return entries_.back(); }
+
+  bool empty() const { return entries_.empty(); }
+  size_type size() const { return entries_.size(); }
+
+  iterator find(uint64_t address)
+  {
+    auto found = index_.find(block_of(address));
+    return found == std::end(index_) ? end() : found->second.position;
+  }
+
+  const_iterator find(uint64_t address) const
+  {
+    auto found = index_.find(block_of(address));
+    return found == std::end(index_) ? end() : const_iterator{found->second.position};
+  }
+
+  // Append an entry that is waiting for a response
+  void push_back(const T& value)
+  {
+    auto position = entries_.insert(std::end(entries_), value);
+    if (returned_end_ == std::end(entries_))
+      returned_end_ = position;
+    [[maybe_unused]] auto [found, inserted] = index_.try_emplace(block_of(value.address), index_entry{position, false});
+    assert(inserted);
+  }
+
+  // Order the entry after previously-returned entries, but before non-returned entries
+  void mark_returned(iterator position)
+  {
+    auto& idx = index_.at(block_of(position->address));
+    if (idx.returned)
+      return;
+
+    if (position == returned_end_)
+      ++returned_end_;
+    else
+      entries_.splice(returned_end_, entries_, position);
+    idx.returned = true;
+    ++num_returned_;
+  }
+
+  iterator erase(const_iterator first, const_iterator last)
+  {
+    for (auto it = first; it != last; ++it) {
+      auto found = index_.find(block_of(it->address));
+      if (found->second.returned)
+        --num_returned_;
+      if (found->second.position == returned_end_)
+        returned_end_ = std::next(found->second.position);
+      index_.erase(found);
+    }
+    return entries_.erase(first, last);
+  }
+
+  iterator erase(const_iterator pos) { return erase(pos, std::next(pos)); }
+};
+} // namespace champsim
+
+#endif
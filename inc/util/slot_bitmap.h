@@ -0,0 +1,79 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UTIL_SLOT_BITMAP_H
+#define UTIL_SLOT_BITMAP_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "msl/bits.h"
+
+namespace champsim
+{
+/**
+ * Tracks which of a fixed number of slots are free, one bit per slot.
+ * The number of free slots is available in constant time, and the lowest free slot is found a word at a time.
+ */
+class slot_bitmap
+{
+  constexpr static std::size_t bits_per_word = 64;
+
+  std::vector<uint64_t> free_words; // a set bit marks a free slot
+  std::size_t num_slots;
+  std::size_t num_free_slots;
+
+public:
+  explicit slot_bitmap(std::size_t size) : free_words((size + bits_per_word - 1) / bits_per_word), num_slots(size), num_free_slots(size)
+  {
+    for (std::size_t i = 0; i < std::size(free_words); ++i)
+      free_words[i] = champsim::msl::bitmask(std::min(bits_per_word, size - i * bits_per_word));
+  }
+
+  std::size_t size() const { return num_slots; }
+  std::size_t num_free() const { return num_free_slots; }
+  bool is_free(std::size_t slot) const { return (free_words[slot / bits_per_word] >> (slot % bits_per_word)) & 1; }
+
+  // Returns the lowest free slot, or size() if every slot is occupied
+  std::size_t find_free() const
+  {
+    for (std::size_t i = 0; i < std::size(free_words); ++i) {
+      if (free_words[i] != 0)
+        return i * bits_per_word + static_cast<std::size_t>(__builtin_ctzll(free_words[i]));
+    }
+    return num_slots;
+  }
+
+  void occupy(std::size_t slot)
+  {
+    assert(is_free(slot));
+    free_words[slot / bits_per_word] &= ~(uint64_t{1} << (slot % bits_per_word));
+    --num_free_slots;
+  }
+
+  void release(std::size_t slot)
+  {
+    assert(!is_free(slot));
+    free_words[slot / bits_per_word] |= uint64_t{1} << (slot % bits_per_word);
+    ++num_free_slots;
+  }
+};
+} // namespace champsim
+
+#endif
@@ -0,0 +1,82 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UTIL_SPSC_QUEUE_H
+#define UTIL_SPSC_QUEUE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <vector>
+
+namespace champsim
+{
+/**
+ * A lock-free ring buffer with a fixed capacity, for passing elements from one producer thread to one consumer thread.
+ * Elements are pushed and popped in batches, so that the threads synchronize once per batch rather than once per element.
+ */
+template <typename T>
+class spsc_queue
+{
+  std::vector<std::optional<T>> slots_;
+
+  // Both counters increase monotonically, and are reduced modulo the capacity to index the slots
+  alignas(64) std::atomic<std::size_t> head_{0}; // written only by the consumer
+  alignas(64) std::atomic<std::size_t> tail_{0}; // written only by the producer
+
+public:
+  explicit spsc_queue(std::size_t capacity) : slots_(capacity) {}
+
+  std::size_t capacity() const { return std::size(slots_); }
+  std::size_t size() const { return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire); }
+  bool empty() const { return size() == 0; }
+
+  /**
+   * Move as many elements of [first, last) into the queue as will fit. Called only by the producer.
+   * Returns the first element that was not pushed.
+   */
+  template <typename It>
+  It push(It first, It last)
+  {
+    auto tail = tail_.load(std::memory_order_relaxed);
+    auto free_slots = capacity() - (tail - head_.load(std::memory_order_acquire));
+    auto count = std::min<std::size_t>(free_slots, static_cast<std::size_t>(std::distance(first, last)));
+    for (std::size_t i = 0; i < count; ++i, ++first)
+      slots_[(tail + i) % capacity()] = std::move(*first);
+    tail_.store(tail + count, std::memory_order_release);
+    return first;
+  }
+
+  /**
+   * Move up to n elements out of the queue, in order, into the output. Called only by the consumer.
+   * Returns the end of the output.
+   */
+  template <typename It>
+  It pop(It out, std::size_t n)
+  {
+    auto head = head_.load(std::memory_order_relaxed);
+    auto count = std::min<std::size_t>(n, tail_.load(std::memory_order_acquire) - head);
+    for (std::size_t i = 0; i < count; ++i, ++out)
+      *out = std::move(*slots_[(head + i) % capacity()]);
+    head_.store(head + count, std::memory_order_release);
+    return out;
+  }
+};
+} // namespace champsim
+
+#endif
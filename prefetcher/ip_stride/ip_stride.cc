@@ -86,7 +86,7 @@ public:
 std::map<CACHE*, tracker> trackers;
 } // namespace
 
-void CACHE::prefetcher_initialize() {}
+void CACHE::prefetcher_initialize() { ::trackers[this] = {}; }
 
 void CACHE::prefetcher_cycle_operate() { ::trackers[this].advance_lookahead(this); }
 
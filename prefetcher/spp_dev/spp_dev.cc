@@ -2,19 +2,26 @@
 
 #include <cassert>
 #include <iostream>
+#include <map>
 
 #include "cache.h"
 
 namespace
 {
-spp::SIGNATURE_TABLE ST;
-spp::PATTERN_TABLE PT;
-spp::PREFETCH_FILTER FILTER;
-spp::GLOBAL_REGISTER GHR;
+struct spp_state {
+  spp::SIGNATURE_TABLE ST;
+  spp::PATTERN_TABLE PT;
+  spp::PREFETCH_FILTER FILTER;
+  spp::GLOBAL_REGISTER GHR;
+};
+
+std::map<CACHE*, spp_state> states;
 } // namespace
 
 void CACHE::prefetcher_initialize()
 {
+  ::states[this] = {};
+
   std::cout << "Initialize SIGNATURE TABLE" << std::endl;
   std::cout << "ST_SET: " << spp::ST_SET << std::endl;
   std::cout << "ST_WAY: " << spp::ST_WAY << std::endl;
@@ -36,6 +43,7 @@ void CACHE::prefetcher_cycle_operate() {}
 
 uint32_t CACHE::prefetcher_cache_operate(uint64_t addr, uint64_t ip, uint8_t cache_hit, bool useful_prefetch, uint8_t type, uint32_t metadata_in)
 {
+  auto& state = ::states.at(this);
   uint64_t page = addr >> LOG2_PAGE_SIZE;
   uint32_t page_offset = (addr >> LOG2_BLOCK_SIZE) & (PAGE_SIZE / BLOCK_SIZE - 1), last_sig = 0, curr_sig = 0, depth = 0;
   std::vector<uint32_t> confidence_q(MSHR_SIZE);
@@ -48,7 +56,7 @@ uint32_t CACHE::prefetcher_cache_operate(uint64_t addr, uint64_t ip, uint8_t cac
     delta_q[i] = 0;
   }
   confidence_q[0] = 100;
-  ::GHR.global_accuracy = ::GHR.pf_issued ? ((100 * ::GHR.pf_useful) / ::GHR.pf_issued) : 0;
+  state.GHR.global_accuracy = state.GHR.pf_issued ? ((100 * state.GHR.pf_useful) / state.GHR.pf_issued) : 0;
 
   if constexpr (spp::SPP_DEBUG_PRINT) {
     std::cout << std::endl << "[ChampSim] " << __func__ << " addr: " << std::hex << addr << " cache_line: " << (addr >> LOG2_BLOCK_SIZE);
@@ -58,14 +66,14 @@ uint32_t CACHE::prefetcher_cache_operate(uint64_t addr, uint64_t ip, uint8_t cac
   // Stage 1: Read and update a sig stored in ST
   // last_sig and delta are used to update (sig, delta) correlation in PT
   // curr_sig is used to read prefetch candidates in PT
-  ::ST.read_and_update_sig(page, page_offset, last_sig, curr_sig, delta);
+  state.ST.read_and_update_sig(page, page_offset, last_sig, curr_sig, delta, state.GHR);
 
   // Also check the prefetch filter in parallel to update global accuracy counters
-  ::FILTER.check(addr, spp::L2C_DEMAND);
+  state.FILTER.check(addr, spp::L2C_DEMAND, state.GHR);
 
   // Stage 2: Update delta patterns stored in PT
   if (last_sig)
-    ::PT.update_pattern(last_sig, delta);
+    state.PT.update_pattern(last_sig, delta);
 
   // Stage 3: Start prefetching
   uint64_t base_addr = addr;
@@ -74,7 +82,7 @@ uint32_t CACHE::prefetcher_cache_operate(uint64_t addr, uint64_t ip, uint8_t cac
 
   do {
     uint32_t lookahead_way = spp::PT_WAY;
-    ::PT.read_pattern(curr_sig, delta_q, confidence_q, lookahead_way, lookahead_conf, pf_q_tail, depth);
+    state.PT.read_pattern(curr_sig, delta_q, confidence_q, lookahead_way, lookahead_conf, pf_q_tail, depth, state.GHR);
 
     do_lookahead = 0;
     for (uint32_t i = pf_q_head; i < pf_q_tail; i++) {
@@ -82,17 +90,17 @@ uint32_t CACHE::prefetcher_cache_operate(uint64_t addr, uint64_t ip, uint8_t cac
         uint64_t pf_addr = (base_addr & ~(BLOCK_SIZE - 1)) + (delta_q[i] << LOG2_BLOCK_SIZE);
 
         if ((addr & ~(PAGE_SIZE - 1)) == (pf_addr & ~(PAGE_SIZE - 1))) { // Prefetch request is in the same physical page
-          if (::FILTER.check(pf_addr, ((confidence_q[i] >= spp::FILL_THRESHOLD) ? spp::SPP_L2C_PREFETCH : spp::SPP_LLC_PREFETCH))) {
+          if (state.FILTER.check(pf_addr, ((confidence_q[i] >= spp::FILL_THRESHOLD) ? spp::SPP_L2C_PREFETCH : spp::SPP_LLC_PREFETCH), state.GHR)) {
             prefetch_line(pf_addr, (confidence_q[i] >= spp::FILL_THRESHOLD), 0); // Use addr (not base_addr) to obey the same physical page boundary
 
             if (confidence_q[i] >= spp::FILL_THRESHOLD) {
-              ::GHR.pf_issued++;
-              if (::GHR.pf_issued > spp::GLOBAL_COUNTER_MAX) {
-                ::GHR.pf_issued >>= 1;
-                ::GHR.pf_useful >>= 1;
+              state.GHR.pf_issued++;
+              if (state.GHR.pf_issued > spp::GLOBAL_COUNTER_MAX) {
+                state.GHR.pf_issued >>= 1;
+                state.GHR.pf_useful >>= 1;
               }
               if constexpr (spp::SPP_DEBUG_PRINT) {
-                std::cout << "[ChampSim] SPP L2 prefetch issued GHR.pf_issued: " << ::GHR.pf_issued << " GHR.pf_useful: " << ::GHR.pf_useful << std::endl;
+                std::cout << "[ChampSim] SPP L2 prefetch issued GHR.pf_issued: " << state.GHR.pf_issued << " GHR.pf_useful: " << state.GHR.pf_useful << std::endl;
               }
             }
 
@@ -107,7 +115,7 @@ uint32_t CACHE::prefetcher_cache_operate(uint64_t addr, uint64_t ip, uint8_t cac
           if constexpr (spp::GHR_ON) {
             // Store this prefetch request in GHR to bootstrap SPP learning when
             // we see a ST miss (i.e., accessing a new page)
-            ::GHR.update_entry(curr_sig, confidence_q[i], (pf_addr >> LOG2_BLOCK_SIZE) & 0x3F, delta_q[i]);
+            state.GHR.update_entry(curr_sig, confidence_q[i], (pf_addr >> LOG2_BLOCK_SIZE) & 0x3F, delta_q[i]);
           }
         }
 
@@ -119,7 +127,7 @@ uint32_t CACHE::prefetcher_cache_operate(uint64_t addr, uint64_t ip, uint8_t cac
     // Update base_addr and curr_sig
     if (lookahead_way < spp::PT_WAY) {
       uint32_t set = spp::get_hash(curr_sig) % spp::PT_SET;
-      base_addr += (::PT.delta[set][lookahead_way] << LOG2_BLOCK_SIZE);
+      base_addr += (state.PT.delta[set][lookahead_way] << LOG2_BLOCK_SIZE);
 
       // PT.delta uses a 7-bit sign magnitude representation to generate
       // sig_delta
@@ -127,7 +135,7 @@ uint32_t CACHE::prefetcher_cache_operate(uint64_t addr, uint64_t ip, uint8_t cac
       // PT.delta[set][lookahead_way]) & 0x3F) + 0x40) :
       // PT.delta[set][lookahead_way];
       int sig_delta =
-          (::PT.delta[set][lookahead_way] < 0) ? (((-1) * ::PT.delta[set][lookahead_way]) + (1 << (spp::SIG_DELTA_BIT - 1))) : ::PT.delta[set][lookahead_way];
+          (state.PT.delta[set][lookahead_way] < 0) ? (((-1) * state.PT.delta[set][lookahead_way]) + (1 << (spp::SIG_DELTA_BIT - 1))) : state.PT.delta[set][lookahead_way];
       curr_sig = ((curr_sig << spp::SIG_SHIFT) ^ sig_delta) & spp::SIG_MASK;
     }
 
@@ -142,11 +150,12 @@ uint32_t CACHE::prefetcher_cache_operate(uint64_t addr, uint64_t ip, uint8_t cac
 
 uint32_t CACHE::prefetcher_cache_fill(uint64_t addr, uint32_t set, uint32_t match, uint8_t prefetch, uint64_t evicted_addr, uint32_t metadata_in)
 {
+  auto& state = ::states.at(this);
   if constexpr (spp::FILTER_ON) {
     if constexpr (spp::SPP_DEBUG_PRINT) {
       std::cout << std::endl;
     }
-    ::FILTER.check(evicted_addr, spp::L2C_EVICT);
+    state.FILTER.check(evicted_addr, spp::L2C_EVICT, state.GHR);
   }
 
   return metadata_in;
@@ -176,7 +185,7 @@ uint64_t get_hash(uint64_t key)
 }
 } // namespace spp
 
-void spp::SIGNATURE_TABLE::read_and_update_sig(uint64_t page, uint32_t page_offset, uint32_t& last_sig, uint32_t& curr_sig, int32_t& delta)
+void spp::SIGNATURE_TABLE::read_and_update_sig(uint64_t page, uint32_t page_offset, uint32_t& last_sig, uint32_t& curr_sig, int32_t& delta, GLOBAL_REGISTER& ghr)
 {
   uint32_t set = get_hash(page) % ST_SET, match = ST_WAY, partial_page = page & ST_TAG_MASK;
   uint8_t ST_hit = 0;
@@ -267,10 +276,10 @@ void spp::SIGNATURE_TABLE::read_and_update_sig(uint64_t page, uint32_t page_offs
 
   if constexpr (spp::GHR_ON) {
     if (ST_hit == 0) {
-      uint32_t GHR_found = ::GHR.check_entry(page_offset);
+      uint32_t GHR_found = ghr.check_entry(page_offset);
       if (GHR_found < MAX_GHR_ENTRY) {
-        sig_delta = (::GHR.delta[GHR_found] < 0) ? (((-1) * ::GHR.delta[GHR_found]) + (1 << (spp::SIG_DELTA_BIT - 1))) : ::GHR.delta[GHR_found];
-        sig[set][match] = ((::GHR.sig[GHR_found] << spp::SIG_SHIFT) ^ sig_delta) & spp::SIG_MASK;
+        sig_delta = (ghr.delta[GHR_found] < 0) ? (((-1) * ghr.delta[GHR_found]) + (1 << (spp::SIG_DELTA_BIT - 1))) : ghr.delta[GHR_found];
+        sig[set][match] = ((ghr.sig[GHR_found] << spp::SIG_SHIFT) ^ sig_delta) & spp::SIG_MASK;
         curr_sig = sig[set][match];
       }
     }
@@ -355,7 +364,7 @@ void spp::PATTERN_TABLE::update_pattern(uint32_t last_sig, int curr_delta)
 }
 
 void spp::PATTERN_TABLE::read_pattern(uint32_t curr_sig, std::vector<int>& delta_q, std::vector<uint32_t>& confidence_q, uint32_t& lookahead_way,
-                                      uint32_t& lookahead_conf, uint32_t& pf_q_tail, uint32_t& depth)
+                                      uint32_t& lookahead_conf, uint32_t& pf_q_tail, uint32_t& depth, const GLOBAL_REGISTER& ghr)
 {
   // Update (sig, delta) correlation
   uint32_t set = get_hash(curr_sig) % spp::PT_SET, local_conf = 0, pf_conf = 0, max_conf = 0;
@@ -363,7 +372,7 @@ void spp::PATTERN_TABLE::read_pattern(uint32_t curr_sig, std::vector<int>& delta
   if (c_sig[set]) {
     for (uint32_t way = 0; way < spp::PT_WAY; way++) {
       local_conf = (100 * c_delta[set][way]) / c_sig[set];
-      pf_conf = depth ? (::GHR.global_accuracy * c_delta[set][way] / c_sig[set] * lookahead_conf / 100) : local_conf;
+      pf_conf = depth ? (ghr.global_accuracy * c_delta[set][way] / c_sig[set] * lookahead_conf / 100) : local_conf;
 
       if (pf_conf >= PF_THRESHOLD) {
         confidence_q[pf_q_tail] = pf_conf;
@@ -396,14 +405,14 @@ void spp::PATTERN_TABLE::read_pattern(uint32_t curr_sig, std::vector<int>& delta
       depth++;
 
     if constexpr (spp::SPP_DEBUG_PRINT) {
-      std::cout << "global_accuracy: " << ::GHR.global_accuracy << " lookahead_conf: " << lookahead_conf << std::endl;
+      std::cout << "global_accuracy: " << ghr.global_accuracy << " lookahead_conf: " << lookahead_conf << std::endl;
     }
   } else {
     confidence_q[pf_q_tail] = 0;
   }
 }
 
-bool spp::PREFETCH_FILTER::check(uint64_t check_addr, FILTER_REQUEST filter_request)
+bool spp::PREFETCH_FILTER::check(uint64_t check_addr, FILTER_REQUEST filter_request, GLOBAL_REGISTER& ghr)
 {
   uint64_t cache_line = check_addr >> LOG2_BLOCK_SIZE, hash = get_hash(cache_line), quotient = (hash >> REMAINDER_BIT) & ((1 << QUOTIENT_BIT) - 1),
            remainder = hash % (1 << REMAINDER_BIT);
@@ -466,20 +475,20 @@ bool spp::PREFETCH_FILTER::check(uint64_t check_addr, FILTER_REQUEST filter_requ
     if ((remainder_tag[quotient] == remainder) && (useful[quotient] == 0)) {
       useful[quotient] = 1;
       if (valid[quotient])
-        ::GHR.pf_useful++; // This cache line was prefetched by SPP and actually used in the program
+        ghr.pf_useful++; // This cache line was prefetched by SPP and actually used in the program
 
       if constexpr (spp::SPP_DEBUG_PRINT) {
         std::cout << "[FILTER] " << __func__ << " set useful for check_addr: " << std::hex << check_addr << " cache_line: " << cache_line << std::dec;
         std::cout << " quotient: " << quotient << " valid: " << valid[quotient] << " useful: " << useful[quotient];
-        std::cout << " GHR.pf_issued: " << ::GHR.pf_issued << " GHR.pf_useful: " << ::GHR.pf_useful << std::endl;
+        std::cout << " GHR.pf_issued: " << ghr.pf_issued << " GHR.pf_useful: " << ghr.pf_useful << std::endl;
       }
     }
     break;
 
   case spp::L2C_EVICT:
     // Decrease global pf_useful counter when there is a useless prefetch (prefetched but not used)
-    if (valid[quotient] && !useful[quotient] && ::GHR.pf_useful)
-      ::GHR.pf_useful--;
+    if (valid[quotient] && !useful[quotient] && ghr.pf_useful)
+      ghr.pf_useful--;
 
     // Reset filter entry
     valid[quotient] = 0;
@@ -16,14 +16,12 @@ struct region_type {
   std::bitset<PAGE_SIZE / BLOCK_SIZE> prefetch_map{};
   uint64_t lru;
 
-  static uint64_t region_lru;
-
-  region_type() : region_type(0) {}
-  explicit region_type(uint64_t allocate_vpn) : vpn(allocate_vpn), lru(region_lru++) {}
+  region_type() : region_type(0, 0) {}
+  region_type(uint64_t allocate_vpn, uint64_t allocate_lru) : vpn(allocate_vpn), lru(allocate_lru) {}
 };
-uint64_t region_type::region_lru = 0;
 
 std::map<CACHE*, std::array<region_type, REGION_COUNT>> regions;
+std::map<CACHE*, uint64_t> region_lru; // the age given to the next region that each cache allocates
 
 auto page_and_offset(uint64_t addr)
 {
@@ -50,7 +48,13 @@ bool check_cl_prefetch(CACHE* cache, uint64_t v_addr)
 
 } // anonymous namespace
 
-void CACHE::prefetcher_initialize() { regions.insert_or_assign(this, decltype(regions)::mapped_type{}); }
+void CACHE::prefetcher_initialize()
+{
+  ::region_lru[this] = 0;
+  auto& tracked = ::regions.insert_or_assign(this, decltype(regions)::mapped_type{}).first->second;
+  for (auto& region : tracked)
+    region.lru = ::region_lru.at(this)++;
+}
 
 uint32_t CACHE::prefetcher_cache_operate(uint64_t addr, uint64_t ip, uint8_t cache_hit, bool useful_prefetch, uint8_t type, uint32_t metadata_in)
 {
@@ -60,7 +64,7 @@ uint32_t CACHE::prefetcher_cache_operate(uint64_t addr, uint64_t ip, uint8_t cac
   if (demand_region == std::end(::regions.at(this))) {
     // not tracking this region yet, so replace the LRU region
     demand_region = std::min_element(std::begin(::regions.at(this)), std::end(::regions.at(this)), [](auto x, auto y) { return x.lru < y.lru; });
-    *demand_region = region_type{current_vpn};
+    *demand_region = region_type{current_vpn, ::region_lru.at(this)++};
     return metadata_in;
   }
 
@@ -86,7 +90,7 @@ uint32_t CACHE::prefetcher_cache_operate(uint64_t addr, uint64_t ip, uint8_t cac
             if (pf_region == std::end(::regions.at(this))) {
               // we're not currently tracking this region, so allocate a new region so we can mark it
               pf_region = std::min_element(std::begin(::regions.at(this)), std::end(::regions.at(this)), [](auto x, auto y) { return x.lru < y.lru; });
-              *pf_region = region_type{pf_vpn};
+              *pf_region = region_type{pf_vpn, ::region_lru.at(this)++};
             }
 
             pf_region->prefetch_map.set(pf_page_offset);
@@ -25,6 +25,7 @@ void CACHE::initialize_replacement()
 {
   // randomly selected sampler sets
   std::size_t rand_seed = 1103515245 + 12345;
+  ::rand_sets[this].clear();
   for (std::size_t i = 0; i < ::TOTAL_SDM_SETS; i++) {
     std::size_t val = (rand_seed / 65536) % NUM_SET;
     auto loc = std::lower_bound(std::begin(::rand_sets[this]), std::end(::rand_sets[this]), val);
@@ -38,7 +39,12 @@ void CACHE::initialize_replacement()
     ::rand_sets[this].insert(loc, val);
   }
 
-  ::rrpv.insert({this, std::vector<unsigned>(NUM_SET * NUM_WAY)});
+  ::rrpv[this] = std::vector<unsigned>(NUM_SET * NUM_WAY);
+
+  // Create the counters now, since the cores may be operated in parallel
+  ::bip_counter[this] = 0;
+  for (std::size_t cpu_idx = 0; cpu_idx < NUM_CPUS; ++cpu_idx)
+    ::PSEL[std::make_pair(this, cpu_idx)] = {};
 }
 
 // called on every cache hit and cache fill
@@ -63,29 +69,29 @@ void CACHE::update_replacement_state(uint32_t triggering_cpu, uint32_t set, uint
   auto leader = std::find(begin, end, set);
 
   if (leader == end) { // follower sets
-    auto selector = ::PSEL[std::make_pair(this, triggering_cpu)];
+    auto selector = ::PSEL.at(std::make_pair(this, std::size_t{triggering_cpu}));
     if (selector.value() > (selector.maximum / 2)) { // follow BIP
       ::rrpv[this][set * NUM_WAY + way] = ::maxRRPV;
 
-      ::bip_counter[this]++;
-      if (::bip_counter[this] == ::BIP_MAX) {
-        ::bip_counter[this] = 0;
+      ::bip_counter.at(this)++;
+      if (::bip_counter.at(this) == ::BIP_MAX) {
+        ::bip_counter.at(this) = 0;
         ::rrpv[this][set * NUM_WAY + way] = ::maxRRPV - 1;
       }
     } else { // follow SRRIP
       ::rrpv[this][set * NUM_WAY + way] = ::maxRRPV - 1;
     }
   } else if (leader == begin) { // leader 0: BIP
-    ::PSEL[std::make_pair(this, triggering_cpu)]--;
+    ::PSEL.at(std::make_pair(this, std::size_t{triggering_cpu}))--;
     ::rrpv[this][set * NUM_WAY + way] = ::maxRRPV;
 
-    ::bip_counter[this]++;
-    if (::bip_counter[this] == ::BIP_MAX) {
-      ::bip_counter[this] = 0;
+    ::bip_counter.at(this)++;
+    if (::bip_counter.at(this) == ::BIP_MAX) {
+      ::bip_counter.at(this) = 0;
       ::rrpv[this][set * NUM_WAY + way] = ::maxRRPV - 1;
     }
   } else if (leader == std::next(begin)) { // leader 1: SRRIP
-    ::PSEL[std::make_pair(this, triggering_cpu)]++;
+    ::PSEL.at(std::make_pair(this, std::size_t{triggering_cpu}))++;
     ::rrpv[this][set * NUM_WAY + way] = ::maxRRPV - 1;
   }
 }
@@ -40,6 +40,7 @@ void CACHE::initialize_replacement()
 {
   // randomly selected sampler sets
   std::size_t rand_seed = 1103515245 + 12345;
+  ::rand_sets[this].clear();
   ;
   for (std::size_t i = 0; i < ::SAMPLER_SET; i++) {
     std::size_t val = (rand_seed / 65536) % NUM_SET;
@@ -54,9 +55,13 @@ void CACHE::initialize_replacement()
     ::rand_sets[this].insert(loc, val);
   }
 
-  sampler.emplace(this, ::SAMPLER_SET * NUM_WAY);
+  ::sampler[this] = std::vector<SAMPLER_class>(::SAMPLER_SET * NUM_WAY);
 
   ::rrpv_values[this] = std::vector<int>(NUM_SET * NUM_WAY, ::maxRRPV);
+
+  // Create the prediction table of each CPU now, since the cores may be operated in parallel
+  for (std::size_t cpu_idx = 0; cpu_idx < NUM_CPUS; ++cpu_idx)
+    ::SHCT[std::make_pair(this, cpu_idx)] = {};
 }
 
 // find replacement victim
@@ -100,8 +105,8 @@ void CACHE::update_replacement_state(uint32_t triggering_cpu, uint32_t set, uint
                               [addr = full_addr, shamt = 8 + champsim::lg2(NUM_WAY)](auto x) { return x.valid && (x.address >> shamt) == (addr >> shamt); });
     if (match != s_set_end) {
       auto SHCT_idx = match->ip % ::SHCT_PRIME;
-      if (::SHCT[std::make_pair(this, triggering_cpu)][SHCT_idx] > 0)
-        ::SHCT[std::make_pair(this, triggering_cpu)][SHCT_idx]--;
+      if (::SHCT.at(std::make_pair(this, std::size_t{triggering_cpu}))[SHCT_idx] > 0)
+        ::SHCT.at(std::make_pair(this, std::size_t{triggering_cpu}))[SHCT_idx]--;
 
       match->used = 1;
     } else {
@@ -109,8 +114,8 @@ void CACHE::update_replacement_state(uint32_t triggering_cpu, uint32_t set, uint
 
       if (match->used) {
         auto SHCT_idx = match->ip % ::SHCT_PRIME;
-        if (::SHCT[std::make_pair(this, triggering_cpu)][SHCT_idx] < ::SHCT_MAX)
-          ::SHCT[std::make_pair(this, triggering_cpu)][SHCT_idx]++;
+        if (::SHCT.at(std::make_pair(this, std::size_t{triggering_cpu}))[SHCT_idx] < ::SHCT_MAX)
+          ::SHCT.at(std::make_pair(this, std::size_t{triggering_cpu}))[SHCT_idx]++;
       }
 
       match->valid = 1;
@@ -130,7 +135,7 @@ void CACHE::update_replacement_state(uint32_t triggering_cpu, uint32_t set, uint
     auto SHCT_idx = ip % ::SHCT_PRIME;
 
     ::rrpv_values[this][set * NUM_WAY + way] = ::maxRRPV - 1;
-    if (::SHCT[std::make_pair(this, triggering_cpu)][SHCT_idx] == ::SHCT_MAX)
+    if (::SHCT.at(std::make_pair(this, std::size_t{triggering_cpu}))[SHCT_idx] == ::SHCT_MAX)
       ::rrpv_values[this][set * NUM_WAY + way] = ::maxRRPV;
   }
 }
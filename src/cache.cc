@@ -21,6 +21,7 @@
 #include <cmath>
 #include <iomanip>
 #include <numeric>
+#include <utility>
 #include <fmt/core.h>
 #include <fmt/ranges.h>
 
@@ -29,6 +30,7 @@
 #include "deadlock.h"
 #include "instruction.h"
 #include "util/algorithm.h"
+#include "util/find_tag.h"
 #include "util/span.h"
 #include <fmt/core.h>
 
@@ -134,6 +136,7 @@ bool CACHE::handle_fill(const mshr_type& fill_mshr)
         ++sim_stats.pf_fill;
 
       *way = BLOCK{fill_mshr};
+      block_tags[static_cast<std::size_t>(std::distance(std::begin(block), way))] = fill_mshr.address >> OFFSET_BITS;
 
       metadata_thru = impl_prefetcher_cache_fill(pkt_address, get_set_index(fill_mshr.address), way_idx, fill_mshr.type == access_type::PREFETCH,
                                                  evicting_address, metadata_thru);
@@ -170,8 +173,7 @@ bool CACHE::try_hit(const tag_lookup_type& handle_pkt)
 
   // access cache
   auto [set_begin, set_end] = get_set_span(handle_pkt.address);
-  auto way = std::find_if(set_begin, set_end,
-                          [match = handle_pkt.address >> OFFSET_BITS, shamt = OFFSET_BITS](const auto& entry) { return (entry.address >> shamt) == match; });
+  auto way = std::next(set_begin, static_cast<long>(find_way(handle_pkt.address)));
   const auto hit = (way != set_end);
   const auto useful_prefetch = (hit && way->prefetch && !handle_pkt.prefetch_from_this);
 
@@ -225,9 +227,7 @@ bool CACHE::handle_miss(const tag_lookup_type& handle_pkt)
   cpu = handle_pkt.cpu;
 
   // check mshr
-  auto mshr_entry = std::find_if(std::begin(MSHR), std::end(MSHR), [match = handle_pkt.address >> OFFSET_BITS, shamt = OFFSET_BITS](const auto& entry) {
-    return (entry.address >> shamt) == match;
-  });
+  auto mshr_entry = MSHR.find(handle_pkt.address);
   bool mshr_full = (MSHR.size() == MSHR_SIZE);
 
   if (mshr_entry != MSHR.end()) // miss already inflight
@@ -349,13 +349,14 @@ long CACHE::operate()
 
   // Perform fills
   auto fill_bw = MAX_FILL;
-  for (auto q : {std::ref(MSHR), std::ref(inflight_writes)}) {
-    auto [fill_begin, fill_end] =
-        champsim::get_span_p(std::cbegin(q.get()), std::cend(q.get()), fill_bw, [cycle = current_cycle](const auto& x) { return x.event_cycle <= cycle; });
+  auto perform_fills = [&fill_bw, this](auto& q, auto q_end) {
+    auto [fill_begin, fill_end] = champsim::get_span_p(std::cbegin(q), q_end, fill_bw, [cycle = current_cycle](const auto& x) { return x.event_cycle <= cycle; });
     auto complete_end = std::find_if_not(fill_begin, fill_end, [this](const auto& x) { return this->handle_fill(x); });
     fill_bw -= std::distance(fill_begin, complete_end);
-    q.get().erase(fill_begin, complete_end);
-  }
+    q.erase(fill_begin, complete_end);
+  };
+  perform_fills(MSHR, std::as_const(MSHR).returned_end()); // Entries that have not returned cannot be filled
+  perform_fills(inflight_writes, std::cend(inflight_writes));
   progress += MAX_FILL - fill_bw;
 
   // Initiate tag checks
@@ -419,6 +420,40 @@ long CACHE::operate()
   return progress;
 }
 
+uint64_t CACHE::next_event_cycle() const
+{
+  auto has_requests = [](const channel_type* ul) { return !(std::empty(ul->RQ) && std::empty(ul->WQ) && std::empty(ul->PQ)); };
+  if (std::any_of(std::begin(upper_levels), std::end(upper_levels), has_requests) || !std::empty(internal_PQ) || !std::empty(lower_level->returned)
+      || (lower_translate != nullptr && !std::empty(lower_translate->returned)))
+    return current_cycle;
+
+  // Translations waiting to be issued, and stashed tag checks ready to retry
+  auto needs_issue = [](const auto& x) { return !x.is_translated && !x.translate_issued; };
+  if (std::any_of(std::begin(inflight_tag_check), std::end(inflight_tag_check), needs_issue)
+      || std::any_of(std::begin(translation_stash), std::end(translation_stash), [needs_issue](const auto& x) { return x.is_translated || needs_issue(x); }))
+    return current_cycle;
+
+  uint64_t next = std::numeric_limits<uint64_t>::max();
+  for (auto it = std::cbegin(MSHR); it != MSHR.returned_end(); ++it)
+    next = std::min(next, it->event_cycle);
+  for (const auto& x : inflight_writes)
+    next = std::min(next, x.event_cycle);
+
+  // Untranslated tag checks are moved to the stash on the cycle after they would have completed
+  for (const auto& x : inflight_tag_check)
+    next = std::min(next, x.is_translated ? x.event_cycle : x.event_cycle + 1);
+
+  return next;
+}
+
+bool CACHE::operate_idle()
+{
+  // The prefetcher is operated every cycle, and may produce work by issuing prefetches
+  auto pq_occupancy = std::size(internal_PQ);
+  impl_prefetcher_cycle_operate();
+  return std::size(internal_PQ) != pq_occupancy;
+}
+
 // LCOV_EXCL_START exclude deprecated function
 uint64_t CACHE::get_set(uint64_t address) const { return get_set_index(address); }
 // LCOV_EXCL_STOP
@@ -446,20 +481,24 @@ auto CACHE::get_set_span(uint64_t address) const -> std::pair<std::vector<BLOCK>
   return get_span(std::cbegin(block), static_cast<std::vector<BLOCK>::difference_type>(set_idx), NUM_WAY); // safe cast because of prior assert
 }
 
+// Returns the way in the set of the block with the same tag as the address, or NUM_WAY if there is none
+std::size_t CACHE::find_way(uint64_t address) const
+{
+  auto [begin, end] = get_span(std::data(block_tags), static_cast<std::ptrdiff_t>(get_set_index(address)), NUM_WAY);
+  return static_cast<std::size_t>(std::distance(begin, champsim::find_tag(begin, end, address >> OFFSET_BITS)));
+}
+
 // LCOV_EXCL_START exclude deprecated function
 uint64_t CACHE::get_way(uint64_t address, uint64_t) const
 {
-  auto [begin, end] = get_set_span(address);
-  return std::distance(
-      begin, std::find_if(begin, end, [match = address >> OFFSET_BITS, shamt = OFFSET_BITS](const auto& entry) { return (entry.address >> shamt) == match; }));
+  return find_way(address);
 }
 // LCOV_EXCL_STOP
 
 uint64_t CACHE::invalidate_entry(uint64_t inval_addr)
 {
   auto [begin, end] = get_set_span(inval_addr);
-  auto inv_way =
-      std::find_if(begin, end, [match = inval_addr >> OFFSET_BITS, shamt = OFFSET_BITS](const auto& entry) { return (entry.address >> shamt) == match; });
+  auto inv_way = std::next(begin, static_cast<long>(find_way(inval_addr)));
 
   if (inv_way != end)
     inv_way->valid = 0;
@@ -498,9 +537,7 @@ int CACHE::prefetch_line(uint64_t, uint64_t, uint64_t pf_addr, bool fill_this_le
 void CACHE::finish_packet(const response_type& packet)
 {
   // check MSHR information
-  auto mshr_entry = std::find_if(std::begin(MSHR), std::end(MSHR),
-                                 [match = packet.address >> OFFSET_BITS, shamt = OFFSET_BITS](const auto& entry) { return (entry.address >> shamt) == match; });
-  auto first_unreturned = std::find_if(MSHR.begin(), MSHR.end(), [](auto x) { return x.event_cycle == std::numeric_limits<uint64_t>::max(); });
+  auto mshr_entry = MSHR.find(packet.address);
 
   // sanity check
   if (mshr_entry == MSHR.end()) {
@@ -521,7 +558,7 @@ void CACHE::finish_packet(const response_type& packet)
 
   // Order this entry after previously-returned entries, but before non-returned
   // entries
-  std::iter_swap(mshr_entry, first_unreturned);
+  MSHR.mark_returned(mshr_entry);
 }
 
 void CACHE::finish_translation(const response_type& packet)
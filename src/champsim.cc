@@ -18,14 +18,20 @@
 
 #include <algorithm>
 #include <chrono>
+#include <iterator>
+#include <map>
 #include <numeric>
+#include <set>
+#include <thread>
 #include <vector>
 
+#include "clock_schedule.h"
 #include "environment.h"
 #include "ooo_cpu.h"
 #include "operable.h"
 #include "phase_info.h"
 #include "tracereader.h"
+#include "util/barrier.h"
 #include <fmt/chrono.h>
 #include <fmt/core.h>
 
@@ -35,12 +41,70 @@ auto start_time = std::chrono::steady_clock::now();
 
 std::chrono::seconds elapsed_time() { return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - start_time); }
 
+namespace
+{
+using operable_list = std::vector<std::reference_wrapper<champsim::operable>>;
+
+// The operables of a simulation, divided into groups that are private to a single core, and the remainder
+struct core_partition {
+  std::vector<operable_list> per_core;
+  operable_list shared;
+};
+
+// Components are private to a core if they can only be reached through the channels below that core.
+// Page table walkers share the virtual memory system, so they are always treated as shared.
+core_partition partition_by_core(champsim::environment& env)
+{
+  std::map<const champsim::channel*, std::vector<const champsim::operable*>> below;
+  std::map<const champsim::operable*, std::vector<const champsim::channel*>> lower_channels;
+  for (CACHE& cache : env.cache_view()) {
+    for (auto ul : cache.upper_levels)
+      below[ul].push_back(&cache);
+    lower_channels[&cache] = {cache.lower_level, cache.lower_translate};
+  }
+  for (PageTableWalker& ptw : env.ptw_view()) {
+    for (auto ul : ptw.upper_levels)
+      below[ul].push_back(&ptw);
+    lower_channels[&ptw] = {ptw.lower_level};
+  }
+
+  auto cpus = env.cpu_view();
+  std::map<const champsim::operable*, std::set<std::size_t>> reached_from;
+  for (std::size_t i = 0; i < std::size(cpus); ++i) {
+    reached_from[&cpus[i].get()].insert(i);
+    std::vector<const champsim::channel*> frontier{cpus[i].get().L1I_bus.lower_level, cpus[i].get().L1D_bus.lower_level};
+    while (!std::empty(frontier)) {
+      auto chan = frontier.back();
+      frontier.pop_back();
+      for (auto op : below[chan]) {
+        if (reached_from[op].insert(i).second)
+          frontier.insert(std::end(frontier), std::begin(lower_channels[op]), std::end(lower_channels[op]));
+      }
+    }
+  }
+
+  for (PageTableWalker& ptw : env.ptw_view())
+    reached_from.erase(&ptw);
+
+  core_partition result{std::vector<operable_list>(std::size(cpus)), {}};
+  for (champsim::operable& op : env.operable_view()) {
+    if (auto found = reached_from.find(&op); found != std::end(reached_from) && std::size(found->second) == 1)
+      result.per_core.at(*std::begin(found->second)).push_back(op);
+    else
+      result.shared.push_back(op);
+  }
+
+  return result;
+}
+} // namespace
+
 namespace champsim
 {
-phase_stats do_phase(phase_info phase, environment& env, std::vector<tracereader>& traces)
+phase_stats do_phase(phase_info phase, environment& env, std::vector<tracereader>& traces, std::size_t num_threads)
 {
   auto [phase_name, is_warmup, length, trace_index, trace_names] = phase;
   auto operables = env.operable_view();
+  auto cpus = env.cpu_view();
 
   // Initialize phase
   for (champsim::operable& op : operables) {
@@ -48,16 +112,93 @@ phase_stats do_phase(phase_info phase, environment& env, std::vector<tracereader
     op.begin_phase();
   }
 
+  // With more than one thread, the components private to each core are operated concurrently, followed by the shared components.
+  // The results are deterministic for a fixed number of threads, but they may differ from a single-threaded run, which interleaves the cores
+  // and the shared components.
+  core_partition partition{{}, operables};
+  if (num_threads > 1 && std::size(cpus) > 1)
+    partition = partition_by_core(env);
+
+  // Group the operables by clock domain once, rather than ordering them on every cycle
+  std::vector<champsim::clock_schedule> core_schedules;
+  for (auto& group : partition.per_core)
+    core_schedules.emplace_back(std::begin(group), std::end(group));
+  champsim::clock_schedule shared_schedule{std::begin(partition.shared), std::end(partition.shared)};
+
+  for (O3_CPU& cpu : cpus)
+    cpu.defer_output = !std::empty(core_schedules);
+
+  // Each thread operates every num_threads-th core, and the main thread takes part as the first
+  num_threads = std::max<std::size_t>(1, std::min(num_threads, std::size(core_schedules)));
+  std::vector<long> core_progress(std::size(core_schedules));
+  auto operate_cores = [&core_schedules, &core_progress, num_threads](std::size_t first) {
+    for (auto i = first; i < std::size(core_schedules); i += num_threads)
+      core_progress[i] = core_schedules[i].operate();
+  };
+
+  bool workers_done{false};
+  champsim::spin_barrier cycle_begin{static_cast<std::ptrdiff_t>(num_threads)}, cycle_end{static_cast<std::ptrdiff_t>(num_threads)};
+  std::vector<std::thread> workers;
+  for (std::size_t i = 1; i < num_threads; ++i) {
+    workers.emplace_back([&, i] {
+      while (true) {
+        cycle_begin.arrive_and_wait();
+        if (workers_done)
+          return;
+        operate_cores(i);
+        cycle_end.arrive_and_wait();
+      }
+    });
+  }
+
+  // Instructions are read from the traces in batches into this buffer, then moved into the input queues
+  long max_queue_size{0};
+  for (O3_CPU& cpu : cpus)
+    max_queue_size = std::max(max_queue_size, cpu.IN_QUEUE_SIZE);
+  std::vector<ooo_model_instr> trace_buffer(static_cast<std::size_t>(max_queue_size), ooo_model_instr{0, input_instr{}});
+
   // Perform phase
   int stalled_cycle{0};
-  std::vector<bool> phase_complete(std::size(env.cpu_view()), false);
+  bool idle_valid{false};
+  std::vector<bool> phase_complete(std::size(cpus), false);
+  std::vector<bool> next_phase_complete(std::size(cpus), false);
   while (!std::accumulate(std::begin(phase_complete), std::end(phase_complete), true, std::logical_and{})) {
-    auto next_phase_complete = phase_complete;
+    next_phase_complete = phase_complete;
+
+    // After a cycle with no progress, find when each operable will next have work, stopping at the first that has work now
+    auto is_idle = [](const champsim::operable& op) { return op.leaps() || op.current_cycle < op.idle_until_cycle; };
+    if (stalled_cycle > 0 && !idle_valid) {
+      idle_valid = std::all_of(std::begin(operables), std::end(operables), [is_idle](champsim::operable& op) {
+        op.idle_until_cycle = op.next_event_cycle();
+        return is_idle(op);
+      });
+    }
+
+    // If no operable has work this cycle, advance the clocks without operating
+    bool skip = idle_valid && std::all_of(std::begin(operables), std::end(operables), is_idle);
 
     // Operate
     long progress{0};
-    for (champsim::operable& op : operables) {
-      progress += op._operate();
+    if (skip) {
+      for (champsim::operable& op : operables) {
+        if (op._skip())
+          idle_valid = false;
+      }
+    } else {
+      idle_valid = false;
+      if (!std::empty(core_schedules)) {
+        cycle_begin.arrive_and_wait();
+        operate_cores(0);
+        cycle_end.arrive_and_wait();
+        progress += std::accumulate(std::begin(core_progress), std::end(core_progress), long{0});
+
+        for (O3_CPU& cpu : cpus) {
+          fmt::print("{}", cpu.deferred_output);
+          cpu.deferred_output.clear();
+        }
+      }
+
+      progress += shared_schedule.operate();
     }
 
     if (progress == 0) {
@@ -67,18 +208,21 @@ phase_stats do_phase(phase_info phase, environment& env, std::vector<tracereader
     }
 
     if (stalled_cycle >= DEADLOCK_CYCLE) {
-      std::for_each(std::begin(operables), std::end(operables), [](champsim::operable& c) { c.print_deadlock(); });
+      for (auto& schedule : core_schedules)
+        schedule.for_each([](champsim::operable& c) { c.print_deadlock(); });
+      shared_schedule.for_each([](champsim::operable& c) { c.print_deadlock(); });
       abort();
     }
 
-    std::sort(std::begin(operables), std::end(operables),
-              [](const champsim::operable& lhs, const champsim::operable& rhs) { return lhs.leap_operation < rhs.leap_operation; });
-
     // Read from trace
-    for (O3_CPU& cpu : env.cpu_view()) {
+    for (O3_CPU& cpu : cpus) {
       auto& trace = traces.at(trace_index.at(cpu.cpu));
-      for (auto pkt_count = cpu.IN_QUEUE_SIZE - static_cast<long>(std::size(cpu.input_queue)); !trace.eof() && pkt_count > 0; --pkt_count)
-        cpu.input_queue.push_back(trace());
+      auto pkt_count = cpu.IN_QUEUE_SIZE - static_cast<long>(std::size(cpu.input_queue));
+      if (!trace.eof() && pkt_count > 0) {
+        auto begin = std::data(trace_buffer);
+        auto end = trace(begin, std::next(begin, pkt_count));
+        std::move(begin, end, std::back_inserter(cpu.input_queue));
+      }
 
       // If any trace reaches EOF, terminate all phases
       if (trace.eof())
@@ -86,12 +230,12 @@ phase_stats do_phase(phase_info phase, environment& env, std::vector<tracereader
     }
 
     // Check for phase finish
-    for (O3_CPU& cpu : env.cpu_view()) {
+    for (O3_CPU& cpu : cpus) {
       // Phase complete
       next_phase_complete[cpu.cpu] = next_phase_complete[cpu.cpu] || (cpu.sim_instr() >= length);
     }
 
-    for (O3_CPU& cpu : env.cpu_view()) {
+    for (O3_CPU& cpu : cpus) {
       if (next_phase_complete[cpu.cpu] != phase_complete[cpu.cpu]) {
         for (champsim::operable& op : operables)
           op.end_phase(cpu.cpu);
@@ -104,7 +248,13 @@ phase_stats do_phase(phase_info phase, environment& env, std::vector<tracereader
     phase_complete = next_phase_complete;
   }
 
-  for (O3_CPU& cpu : env.cpu_view()) {
+  workers_done = true;
+  if (!std::empty(workers))
+    cycle_begin.arrive_and_wait();
+  for (auto& worker : workers)
+    worker.join();
+
+  for (O3_CPU& cpu : cpus) {
     fmt::print("{} complete CPU {} instructions: {} cycles: {} cumulative IPC: {:.4g} (Simulation time: {:%H hr %M min %S sec})\n", phase_name, cpu.cpu,
                cpu.sim_instr(), cpu.sim_cycle(), std::ceil(cpu.sim_instr()) / std::ceil(cpu.sim_cycle()), elapsed_time());
   }
@@ -115,7 +265,6 @@ phase_stats do_phase(phase_info phase, environment& env, std::vector<tracereader
   for (std::size_t i = 0; i < std::size(trace_index); ++i)
     stats.trace_names.push_back(trace_names.at(trace_index.at(i)));
 
-  auto cpus = env.cpu_view();
   std::transform(std::begin(cpus), std::end(cpus), std::back_inserter(stats.sim_cpu_stats), [](const O3_CPU& cpu) { return cpu.sim_stats; });
   std::transform(std::begin(cpus), std::end(cpus), std::back_inserter(stats.roi_cpu_stats), [](const O3_CPU& cpu) { return cpu.roi_stats; });
 
@@ -123,7 +272,7 @@ phase_stats do_phase(phase_info phase, environment& env, std::vector<tracereader
   std::transform(std::begin(caches), std::end(caches), std::back_inserter(stats.sim_cache_stats), [](const CACHE& cache) { return cache.sim_stats; });
   std::transform(std::begin(caches), std::end(caches), std::back_inserter(stats.roi_cache_stats), [](const CACHE& cache) { return cache.roi_stats; });
 
-  auto dram = env.dram_view();
+  auto& dram = env.dram_view();
   std::transform(std::begin(dram.channels), std::end(dram.channels), std::back_inserter(stats.sim_dram_stats),
                  [](const DRAM_CHANNEL& chan) { return chan.sim_stats; });
   std::transform(std::begin(dram.channels), std::end(dram.channels), std::back_inserter(stats.roi_dram_stats),
@@ -132,19 +281,25 @@ phase_stats do_phase(phase_info phase, environment& env, std::vector<tracereader
   return stats;
 }
 
-// simulation entry point
-std::vector<phase_stats> main(environment& env, std::vector<phase_info>& phases, std::vector<tracereader>& traces)
+// Run the phases of an environment that has already been initialized
+std::vector<phase_stats> run_phases(environment& env, std::vector<phase_info>& phases, std::vector<tracereader>& traces, std::size_t num_threads)
 {
-  for (champsim::operable& op : env.operable_view())
-    op.initialize();
-
   std::vector<phase_stats> results;
   for (auto phase : phases) {
-    auto stats = do_phase(phase, env, traces);
+    auto stats = do_phase(phase, env, traces, num_threads);
     if (!phase.is_warmup)
       results.push_back(stats);
   }
 
   return results;
 }
+
+// simulation entry point
+std::vector<phase_stats> main(environment& env, std::vector<phase_info>& phases, std::vector<tracereader>& traces, std::size_t num_threads)
+{
+  for (champsim::operable& op : env.operable_view())
+    op.initialize();
+
+  return run_phases(env, phases, traces, num_threads);
+}
 } // namespace champsim
@@ -19,6 +19,7 @@
 #include <algorithm>
 #include <cfenv>
 #include <cmath>
+#include <stdexcept>
 
 #include "champsim_constants.h"
 #include "deadlock.h"
@@ -34,11 +35,25 @@ uint64_t cycles(double time, int io_freq)
 }
 
 MEMORY_CONTROLLER::MEMORY_CONTROLLER(double freq_scale, int io_freq, double t_rp, double t_rcd, double t_cas, double turnaround,
-                                     std::vector<channel_type*>&& ul)
+                                     std::vector<channel_type*>&& ul, const dram_timing_parameters& timing)
     : champsim::operable(freq_scale), queues(std::move(ul)), tRP(cycles(t_rp / 1000, io_freq)), tRCD(cycles(t_rcd / 1000, io_freq)),
       tCAS(cycles(t_cas / 1000, io_freq)), DRAM_DBUS_TURN_AROUND_TIME(cycles(turnaround / 1000, io_freq)),
-      DRAM_DBUS_RETURN_TIME(cycles(std::ceil(BLOCK_SIZE) / std::ceil(DRAM_CHANNEL_WIDTH), 1))
+      DRAM_DBUS_RETURN_TIME(cycles(std::ceil(BLOCK_SIZE) / std::ceil(DRAM_CHANNEL_WIDTH), 1)), DRAM_BANK_GROUPS(std::max<std::size_t>(timing.bank_groups, 1)),
+      tRRD_S(cycles(timing.tRRD_S / 1000, io_freq)), tRRD_L(cycles(timing.tRRD_L / 1000, io_freq)), tFAW(cycles(timing.tFAW / 1000, io_freq)),
+      tCCD_S(cycles(timing.tCCD_S / 1000, io_freq)), tCCD_L(cycles(timing.tCCD_L / 1000, io_freq)), tWR(cycles(timing.tWR / 1000, io_freq)),
+      tWTR_S(cycles(timing.tWTR_S / 1000, io_freq)), tWTR_L(cycles(timing.tWTR_L / 1000, io_freq)), tREFI(cycles(timing.tREFI / 1000, io_freq)),
+      tRFC(cycles(timing.tRFC / 1000, io_freq)), tRFCsb(cycles(timing.tRFCsb / 1000, io_freq)), tXP(cycles(timing.tXP / 1000, io_freq)),
+      POWER_DOWN_THRESHOLD(cycles(timing.power_down_threshold / 1000, io_freq)), SAME_BANK_REFRESH(timing.same_bank_refresh),
+      module_pimpl(std::make_unique<module_model<0>>(this))
 {
+  if (DRAM_BANKS % DRAM_BANK_GROUPS != 0)
+    throw std::invalid_argument{fmt::format("The {} banks of a rank cannot be divided into {} bank groups", DRAM_BANKS, DRAM_BANK_GROUPS)};
+
+  // Stagger the refreshes of the ranks across the refresh interval
+  for (auto& channel : channels) {
+    for (std::size_t rank = 0; rank < DRAM_RANKS; ++rank)
+      channel.rank_timing[rank].refresh_due = refresh_interval() + rank * refresh_interval() / DRAM_RANKS;
+  }
 }
 
 long MEMORY_CONTROLLER::operate()
@@ -48,23 +63,26 @@ long MEMORY_CONTROLLER::operate()
   initiate_requests();
 
   for (auto& channel : channels) {
-    if (warmup) {
-      for (auto& entry : channel.RQ) {
-        if (entry.has_value()) {
-          response_type response{entry->address, entry->v_address, entry->data, entry->pf_metadata, entry->instr_depend_on_me};
-          for (auto ret : entry.value().to_return)
+    if (warmup && channel.RQ_occupancy > 0) {
+      for (auto it = std::begin(channel.RQ); it != std::end(channel.RQ); ++it) {
+        if (it->has_value()) {
+          response_type response{it->value().address, it->value().v_address, it->value().data, it->value().pf_metadata,
+                                 it->value().instr_depend_on_me};
+          for (auto ret : it->value().to_return)
             ret->push_back(response);
 
           ++progress;
-          entry.reset();
+          channel.remove_request(channel.RQ, it);
         }
       }
+    }
 
-      for (auto& entry : channel.WQ) {
-        if (entry.has_value()) {
+    if (warmup && channel.WQ_occupancy > 0) {
+      for (auto it = std::begin(channel.WQ); it != std::end(channel.WQ); ++it) {
+        if (it->has_value()) {
           ++progress;
+          channel.remove_request(channel.WQ, it);
         }
-        entry.reset();
       }
     }
 
@@ -79,16 +97,28 @@ long MEMORY_CONTROLLER::operate()
       for (auto ret : channel.active_request->pkt->value().to_return)
         ret->push_back(response);
 
+      auto bank_index = static_cast<std::size_t>(std::distance(std::begin(channel.bank_request), channel.active_request));
+      auto& rank_timing = channel.rank_timing[bank_index / DRAM_BANKS];
+      if (channel.active_request->is_write) {
+        channel.precharge_available[bank_index] = current_cycle + tWR;
+        rank_timing.write_end = current_cycle;
+        rank_timing.group_write_end[bank_group(bank_index)] = current_cycle;
+      }
+      rank_timing.last_active = std::max(rank_timing.last_active, current_cycle);
+
       channel.active_request->valid = false;
 
-      channel.active_request->pkt->reset();
+      channel.remove_request(channel.active_request->is_write ? channel.WQ : channel.RQ, channel.active_request->pkt);
       channel.active_request = std::end(channel.bank_request);
       ++progress;
     }
 
+    for (std::size_t rank = 0; rank < DRAM_RANKS; ++rank)
+      progress += refresh(channel, rank);
+
     // Check queue occupancy
-    auto wq_occu = static_cast<std::size_t>(std::count_if(std::begin(channel.WQ), std::end(channel.WQ), [](const auto& x) { return x.has_value(); }));
-    auto rq_occu = static_cast<std::size_t>(std::count_if(std::begin(channel.RQ), std::end(channel.RQ), [](const auto& x) { return x.has_value(); }));
+    auto wq_occu = channel.WQ_occupancy;
+    auto rq_occu = channel.RQ_occupancy;
 
     // Change modes if the queues are unbalanced
     if ((!channel.write_mode && (wq_occu >= DRAM_WRITE_HIGH_WM || (rq_occu == 0 && wq_occu > 0)))
@@ -100,11 +130,11 @@ long MEMORY_CONTROLLER::operate()
           // Leave rows charged
           if (it->event_cycle < (current_cycle + tCAS))
             it->open_row = UINT32_MAX;
+          cancel_activation(channel, static_cast<std::size_t>(std::distance(std::begin(channel.bank_request), it)));
 
           // This bank is ready for another DRAM request
           it->valid = false;
-          it->pkt->value().scheduled = false;
-          it->pkt->value().event_cycle = current_cycle;
+          channel.make_ready(it->is_write ? channel.WQ : channel.RQ, it->pkt, current_cycle);
         }
       }
 
@@ -118,15 +148,28 @@ long MEMORY_CONTROLLER::operate()
       channel.write_mode = !channel.write_mode;
     }
 
-    // Look for requests to put on the bus
-    auto iter_next_process = std::min_element(std::begin(channel.bank_request), std::end(channel.bank_request),
-                                              [](const auto& lhs, const auto& rhs) { return !rhs.valid || (lhs.valid && lhs.event_cycle < rhs.event_cycle); });
-    if (iter_next_process->valid && iter_next_process->event_cycle <= current_cycle) {
-      if (channel.active_request == std::end(channel.bank_request) && channel.dbus_cycle_available <= current_cycle) {
+    // Look for requests to put on the bus, in the order that they may use it, and then the order that their banks finished
+    auto iter_next_process = std::end(channel.bank_request);
+    std::pair<uint64_t, uint64_t> next_process_order{};
+    for (auto it = std::begin(channel.bank_request); it != std::end(channel.bank_request); ++it) {
+      if (it->valid) {
+        std::pair order{std::max(data_bus_ready(channel, it), current_cycle), it->event_cycle};
+        if (iter_next_process == std::end(channel.bank_request) || order < next_process_order) {
+          iter_next_process = it;
+          next_process_order = order;
+        }
+      }
+    }
+
+    if (iter_next_process != std::end(channel.bank_request) && iter_next_process->event_cycle <= current_cycle) {
+      auto bus_ready = data_bus_ready(channel, iter_next_process);
+      if (channel.active_request == std::end(channel.bank_request) && channel.dbus_cycle_available <= current_cycle && bus_ready <= current_cycle) {
         // Bus is available
         // Put this request on the data bus
         channel.active_request = iter_next_process;
         channel.active_request->event_cycle = current_cycle + DRAM_DBUS_RETURN_TIME;
+        channel.last_cas_cycle = current_cycle;
+        channel.last_cas_bank = static_cast<std::size_t>(std::distance(std::begin(channel.bank_request), iter_next_process));
 
         if (iter_next_process->row_buffer_hit)
           if (channel.write_mode)
@@ -143,37 +186,36 @@ long MEMORY_CONTROLLER::operate()
         // Bus is congested
         if (channel.active_request != std::end(channel.bank_request))
           channel.sim_stats.dbus_cycle_congested += (channel.active_request->event_cycle - current_cycle);
-        else
+        else if (channel.dbus_cycle_available > current_cycle)
           channel.sim_stats.dbus_cycle_congested += (channel.dbus_cycle_available - current_cycle);
+        else
+          channel.sim_stats.dbus_cycle_congested += (bus_ready - current_cycle);
         ++channel.sim_stats.dbus_count_congested;
       }
     }
 
     // Look for queued packets that have not been scheduled
-    auto next_schedule = [](const auto& lhs, const auto& rhs) {
-      return !(rhs.has_value() && !rhs.value().scheduled) || ((lhs.has_value() && !lhs.value().scheduled) && lhs.value().event_cycle < rhs.value().event_cycle);
-    };
-    DRAM_CHANNEL::queue_type::iterator iter_next_schedule;
-    if (channel.write_mode)
-      iter_next_schedule = std::min_element(std::begin(channel.WQ), std::end(channel.WQ), next_schedule);
-    else
-      iter_next_schedule = std::min_element(std::begin(channel.RQ), std::end(channel.RQ), next_schedule);
-
-    if (iter_next_schedule->has_value() && iter_next_schedule->value().event_cycle <= current_cycle) {
-      auto op_rank = dram_get_rank(iter_next_schedule->value().address);
-      auto op_bank = dram_get_bank(iter_next_schedule->value().address);
-      auto op_row = dram_get_row(iter_next_schedule->value().address);
+    auto& queue = channel.write_mode ? channel.WQ : channel.RQ;
+    auto iter_next_schedule = select_request(channel, queue);
 
-      auto op_idx = op_rank * DRAM_BANKS + op_bank;
+    if (iter_next_schedule != std::end(queue) && iter_next_schedule->value().event_cycle <= current_cycle) {
+      auto op_row = dram_get_row(iter_next_schedule->value().address);
+      auto op_idx = iter_next_schedule->value().bank_index;
 
-      if (!channel.bank_request[op_idx].valid) {
+      if (channel.bank_available(op_idx, current_cycle)) {
         bool row_buffer_hit = (channel.bank_request[op_idx].open_row == op_row);
 
-        // this bank is now busy
-        channel.bank_request[op_idx] = {true, row_buffer_hit, op_row, current_cycle + tCAS + (row_buffer_hit ? 0 : tRP + tRCD), iter_next_schedule};
+        auto begin = current_cycle + wake_rank(channel, op_idx / DRAM_BANKS);
+        auto ready = begin + tCAS;
+        if (!row_buffer_hit) {
+          auto activation = activation_ready(channel, op_idx, begin);
+          record_activation(channel, op_idx, activation);
+          ready = activation + tRCD + tCAS;
+        }
 
-        iter_next_schedule->value().scheduled = true;
-        iter_next_schedule->value().event_cycle = std::numeric_limits<uint64_t>::max();
+        // this bank is now busy
+        channel.bank_request[op_idx] = {true, row_buffer_hit, op_row, ready, iter_next_schedule, channel.write_mode};
+        channel.schedule(queue, iter_next_schedule);
 
         ++progress;
       }
@@ -183,6 +225,198 @@ long MEMORY_CONTROLLER::operate()
   return progress;
 }
 
+uint64_t MEMORY_CONTROLLER::next_event_cycle() const
+{
+  auto has_requests = [](const channel_type* ul) { return !(std::empty(ul->RQ) && std::empty(ul->WQ) && std::empty(ul->PQ)); };
+  if (std::any_of(std::begin(queues), std::end(queues), has_requests))
+    return current_cycle;
+
+  uint64_t next = std::numeric_limits<uint64_t>::max();
+  for (const auto& channel : channels) {
+    auto wq_occu = channel.WQ_occupancy;
+    auto rq_occu = channel.RQ_occupancy;
+
+    // Warmup drains, forwarding checks, and mode changes happen immediately
+    if ((warmup && (wq_occu > 0 || rq_occu > 0)) || channel.unchecked_requests > 0)
+      return current_cycle;
+
+    if ((!channel.write_mode && (wq_occu >= DRAM_WRITE_HIGH_WM || (rq_occu == 0 && wq_occu > 0)))
+        || (channel.write_mode && (wq_occu == 0 || (rq_occu > 0 && wq_occu < DRAM_WRITE_LOW_WM))))
+      return current_cycle;
+
+    // Requests in the banks, including the one on the data bus
+    for (auto it = std::cbegin(channel.bank_request); it != std::cend(channel.bank_request); ++it) {
+      if (it == channel.active_request)
+        next = std::min(next, it->event_cycle);
+      else if (it->valid)
+        next = std::min(next, data_bus_ready(channel, it));
+    }
+
+    // Refreshes that are due, or that may begin
+    for (std::size_t rank = 0; rank < DRAM_RANKS && tREFI > 0; ++rank) {
+      if (channel.rank_timing[rank].refresh_due > current_cycle) {
+        next = std::min(next, channel.rank_timing[rank].refresh_due);
+      } else {
+        bool idle = true;
+        for (std::size_t i = 0; i < refresh_set_size(); ++i)
+          idle = idle && !channel.bank_request[refresh_target(channel, rank, i)].valid;
+        if (idle)
+          return current_cycle;
+      }
+    }
+
+    const auto& queue = channel.write_mode ? channel.WQ : channel.RQ;
+    if (has_scheduler_module) {
+      // A scheduler may choose any request whose bank is available
+      const auto& lists = channel.ready_lists(queue);
+      for (std::size_t i = 0; i < std::size(lists); ++i) {
+        if (!std::empty(lists[i]) && !channel.bank_request[i].valid)
+          next = std::min(next, std::max(std::begin(lists[i])->first, channel.bank_blocked_until[i]));
+      }
+    } else {
+      // The next request to be scheduled, if its bank is available
+      auto iter_next_schedule = channel.next_ready(queue);
+      auto op_idx = (iter_next_schedule != std::end(queue)) ? iter_next_schedule->value().bank_index : 0;
+      if (iter_next_schedule != std::end(queue) && !channel.bank_request[op_idx].valid)
+        next = std::min(next, std::max(iter_next_schedule->value().event_cycle, channel.bank_blocked_until[op_idx]));
+    }
+  }
+
+  return next;
+}
+
+auto MEMORY_CONTROLLER::select_request(DRAM_CHANNEL& channel, DRAM_CHANNEL::queue_type& queue) -> DRAM_CHANNEL::queue_type::iterator
+{
+  if (has_scheduler_module)
+    return impl_dram_scheduler_select(channel, queue);
+  return channel.next_ready(queue);
+}
+
+uint64_t MEMORY_CONTROLLER::data_bus_ready(const DRAM_CHANNEL& channel, DRAM_CHANNEL::request_array_type::const_iterator bank) const
+{
+  auto bank_index = static_cast<std::size_t>(std::distance(std::cbegin(channel.bank_request), bank));
+  auto rank = bank_index / DRAM_BANKS;
+  const auto& rank_timing = channel.rank_timing[rank];
+
+  auto ready = bank->event_cycle;
+
+  // Column accesses to a rank are spaced further apart within a bank group
+  if (channel.last_cas_bank / DRAM_BANKS == rank) {
+    auto spacing = (bank_group(channel.last_cas_bank) == bank_group(bank_index)) ? tCCD_L : tCCD_S;
+    ready = std::max(ready, channel.last_cas_cycle + spacing);
+  }
+
+  // Reads wait for the writes to their rank to finish
+  if (!bank->is_write)
+    ready = std::max({ready, rank_timing.write_end + tWTR_S, rank_timing.group_write_end[bank_group(bank_index)] + tWTR_L});
+
+  return ready;
+}
+
+uint64_t MEMORY_CONTROLLER::activation_ready(const DRAM_CHANNEL& channel, std::size_t bank_index, uint64_t begin) const
+{
+  const auto& activations = channel.rank_timing[bank_index / DRAM_BANKS].activations;
+
+  // The open row is precharged once the bank has recovered from its last write
+  auto activation = std::max(begin, channel.precharge_available[bank_index]) + tRP;
+
+  // Activations to a rank are spaced further apart within a bank group
+  for (auto [cycle, bank] : activations)
+    activation = std::max(activation, cycle + ((bank_group(bank) == bank_group(bank_index)) ? tRRD_L : tRRD_S));
+  if (tFAW > 0 && std::size(activations) >= 4)
+    activation = std::max(activation, std::next(std::rbegin(activations), 3)->first + tFAW);
+  return activation;
+}
+
+void MEMORY_CONTROLLER::record_activation(DRAM_CHANNEL& channel, std::size_t bank_index, uint64_t cycle) const
+{
+  auto horizon = std::max({tRRD_S, tRRD_L, tFAW});
+  if (horizon == 0)
+    return;
+
+  // Forget the activations that can no longer delay another
+  auto& activations = channel.rank_timing[bank_index / DRAM_BANKS].activations;
+  while (!std::empty(activations) && activations.front().first + horizon <= current_cycle)
+    activations.pop_front();
+  activations.emplace_back(cycle, bank_index);
+}
+
+void MEMORY_CONTROLLER::cancel_activation(DRAM_CHANNEL& channel, std::size_t bank_index) const
+{
+  auto& activations = channel.rank_timing[bank_index / DRAM_BANKS].activations;
+  auto is_pending = [bank_index, cycle = current_cycle](const auto& x) { return x.second == bank_index && x.first > cycle; };
+  activations.erase(std::remove_if(std::begin(activations), std::end(activations), is_pending), std::end(activations));
+}
+
+uint64_t MEMORY_CONTROLLER::wake_rank(DRAM_CHANNEL& channel, std::size_t rank)
+{
+  auto& rank_timing = channel.rank_timing[rank];
+  auto first_bank = std::next(std::begin(channel.bank_request), static_cast<std::ptrdiff_t>(rank * DRAM_BANKS));
+  bool busy = std::any_of(first_bank, std::next(first_bank, DRAM_BANKS), [](const auto& bank) { return bank.valid; });
+
+  uint64_t delay = 0;
+  if (POWER_DOWN_THRESHOLD > 0 && !busy && current_cycle > rank_timing.last_active + POWER_DOWN_THRESHOLD) {
+    channel.sim_stats.POWER_DOWN_CYCLES += current_cycle - (rank_timing.last_active + POWER_DOWN_THRESHOLD);
+    delay = tXP;
+  }
+
+  rank_timing.last_active = std::max(rank_timing.last_active, current_cycle + delay);
+  return delay;
+}
+
+std::size_t MEMORY_CONTROLLER::refresh_target(const DRAM_CHANNEL& channel, std::size_t rank, std::size_t i) const
+{
+  // A same-bank refresh targets the bank with the same index in each bank group
+  if (SAME_BANK_REFRESH)
+    return rank * DRAM_BANKS + channel.rank_timing[rank].refresh_set * DRAM_BANK_GROUPS + i;
+  return rank * DRAM_BANKS + i;
+}
+
+long MEMORY_CONTROLLER::refresh(DRAM_CHANNEL& channel, std::size_t rank)
+{
+  auto& rank_timing = channel.rank_timing[rank];
+  if (tREFI == 0)
+    return 0;
+
+  // A refresh may outlast the deadlock window, so each of its cycles counts as progress
+  if (rank_timing.refresh_end > current_cycle)
+    return 1;
+
+  if (rank_timing.refresh_due > current_cycle)
+    return 0;
+
+  // The banks may not begin new accesses while they wait for the refresh
+  bool idle = true;
+  bool rows_open = false;
+  for (std::size_t i = 0; i < refresh_set_size(); ++i) {
+    auto bank = refresh_target(channel, rank, i);
+    channel.bank_blocked_until[bank] = std::numeric_limits<uint64_t>::max();
+    idle = idle && !channel.bank_request[bank].valid;
+    rows_open = rows_open || (channel.bank_request[bank].open_row != std::numeric_limits<uint32_t>::max());
+  }
+
+  if (!idle)
+    return 0;
+
+  // Precharge the open rows, then refresh
+  auto begin = current_cycle + wake_rank(channel, rank);
+  auto end = begin + (rows_open ? tRP : 0) + (SAME_BANK_REFRESH ? tRFCsb : tRFC);
+  for (std::size_t i = 0; i < refresh_set_size(); ++i) {
+    auto bank = refresh_target(channel, rank, i);
+    channel.bank_blocked_until[bank] = end;
+    channel.bank_request[bank].open_row = std::numeric_limits<uint32_t>::max();
+  }
+
+  rank_timing.last_active = std::max(rank_timing.last_active, end);
+  rank_timing.refresh_end = end;
+  rank_timing.refresh_due += refresh_interval();
+  if (SAME_BANK_REFRESH)
+    rank_timing.refresh_set = (rank_timing.refresh_set + 1) % (DRAM_BANKS / DRAM_BANK_GROUPS);
+
+  ++channel.sim_stats.REFRESHES;
+  return 1;
+}
+
 void MEMORY_CONTROLLER::initialize()
 {
   long long int dram_size = DRAM_CHANNELS * DRAM_RANKS * DRAM_BANKS * DRAM_ROWS * DRAM_COLUMNS * BLOCK_SIZE / 1024 / 1024; // in MiB
@@ -192,6 +426,8 @@ void MEMORY_CONTROLLER::initialize()
   else
     fmt::print("{} MiB", dram_size);
   fmt::print(" Channels: {} Width: {}-bit Data Race: {} MT/s\n", DRAM_CHANNELS, 8 * DRAM_CHANNEL_WIDTH, DRAM_IO_FREQ);
+
+  impl_initialize_dram_scheduler();
 }
 
 void MEMORY_CONTROLLER::begin_phase()
@@ -217,19 +453,87 @@ void MEMORY_CONTROLLER::end_phase(unsigned)
   }
 }
 
+namespace
+{
+std::size_t position(const DRAM_CHANNEL::queue_type& queue, DRAM_CHANNEL::queue_type::const_iterator it)
+{
+  return static_cast<std::size_t>(std::distance(std::begin(queue), it));
+}
+
+// The oldest of the first requests of each bank
+std::optional<std::pair<uint64_t, std::size_t>> first_ready(const DRAM_CHANNEL::bank_ready_lists& lists)
+{
+  std::optional<std::pair<uint64_t, std::size_t>> result;
+  for (const auto& list : lists) {
+    if (!std::empty(list) && (!result.has_value() || *std::begin(list) < *result))
+      result = *std::begin(list);
+  }
+  return result;
+}
+} // namespace
+
+void DRAM_CHANNEL::add_request(queue_type& queue, queue_type::iterator slot, value_type request)
+{
+  request.forward_checked = false;
+  *slot = std::move(request);
+  ++occupancy(queue);
+  ++unchecked_requests;
+  make_ready(queue, slot, slot->value().event_cycle);
+}
+
+void DRAM_CHANNEL::remove_request(queue_type& queue, queue_type::iterator it)
+{
+  if (!it->value().scheduled)
+    ready_lists(queue)[it->value().bank_index].erase({it->value().event_cycle, position(queue, it)});
+  if (!it->value().forward_checked)
+    --unchecked_requests;
+  --occupancy(queue);
+  it->reset();
+}
+
+void DRAM_CHANNEL::make_ready(queue_type& queue, queue_type::iterator it, uint64_t cycle)
+{
+  it->value().scheduled = false;
+  it->value().event_cycle = cycle;
+  ready_lists(queue)[it->value().bank_index].emplace(cycle, position(queue, it));
+}
+
+void DRAM_CHANNEL::schedule(queue_type& queue, queue_type::iterator it)
+{
+  ready_lists(queue)[it->value().bank_index].erase({it->value().event_cycle, position(queue, it)});
+  it->value().scheduled = true;
+  it->value().event_cycle = std::numeric_limits<uint64_t>::max();
+}
+
+auto DRAM_CHANNEL::next_ready(queue_type& queue) -> queue_type::iterator
+{
+  auto first = first_ready(ready_lists(queue));
+  return first.has_value() ? std::next(std::begin(queue), static_cast<std::ptrdiff_t>(first->second)) : std::end(queue);
+}
+
+auto DRAM_CHANNEL::next_ready(const queue_type& queue) const -> queue_type::const_iterator
+{
+  auto first = first_ready(ready_lists(queue));
+  return first.has_value() ? std::next(std::begin(queue), static_cast<std::ptrdiff_t>(first->second)) : std::end(queue);
+}
+
 void DRAM_CHANNEL::check_collision()
 {
+  if (unchecked_requests == 0)
+    return;
+
   for (auto wq_it = std::begin(WQ); wq_it != std::end(WQ); ++wq_it) {
     if (wq_it->has_value() && !wq_it->value().forward_checked) {
       auto checker = [addr = wq_it->value().address, offset = LOG2_BLOCK_SIZE](const auto& pkt) {
         return pkt.has_value() && (pkt->address >> offset) == (addr >> offset);
       };
       if (auto found = std::find_if(std::begin(WQ), wq_it, checker); found != wq_it) { // Forward check
-        wq_it->reset();
+        remove_request(WQ, wq_it);
       } else if (found = std::find_if(std::next(wq_it), std::end(WQ), checker); found != std::end(WQ)) { // Backward check
-        wq_it->reset();
+        remove_request(WQ, wq_it);
       } else {
         wq_it->value().forward_checked = true;
+        --unchecked_requests;
       }
     }
   }
@@ -246,7 +550,7 @@ void DRAM_CHANNEL::check_collision()
         for (auto ret : rq_it->value().to_return)
           ret->push_back(response);
 
-        rq_it->reset();
+        remove_request(RQ, rq_it);
       } else if (auto found = std::find_if(std::begin(RQ), rq_it, checker); found != rq_it) {
         auto instr_copy = std::move(found->value().instr_depend_on_me);
         auto ret_copy = std::move(found->value().to_return);
@@ -256,7 +560,7 @@ void DRAM_CHANNEL::check_collision()
         std::set_union(std::begin(ret_copy), std::end(ret_copy), std::begin(rq_it->value().to_return), std::end(rq_it->value().to_return),
                        std::back_inserter(found->value().to_return));
 
-        rq_it->reset();
+        remove_request(RQ, rq_it);
       } else if (found = std::find_if(std::next(rq_it), std::end(RQ), checker); found != std::end(RQ)) {
         auto instr_copy = std::move(found->value().instr_depend_on_me);
         auto ret_copy = std::move(found->value().to_return);
@@ -266,9 +570,10 @@ void DRAM_CHANNEL::check_collision()
         std::set_union(std::begin(ret_copy), std::end(ret_copy), std::begin(rq_it->value().to_return), std::end(rq_it->value().to_return),
                        std::back_inserter(found->value().to_return));
 
-        rq_it->reset();
+        remove_request(RQ, rq_it);
       } else {
         rq_it->value().forward_checked = true;
+        --unchecked_requests;
       }
     }
   }
@@ -303,12 +608,13 @@ bool MEMORY_CONTROLLER::add_rq(const request_type& packet, champsim::channel* ul
   // Find empty slot
   if (auto rq_it = std::find_if_not(std::begin(channel.RQ), std::end(channel.RQ), [](const auto& pkt) { return pkt.has_value(); });
       rq_it != std::end(channel.RQ)) {
-    *rq_it = DRAM_CHANNEL::request_type{packet};
-    rq_it->value().forward_checked = false;
-    rq_it->value().event_cycle = current_cycle;
+    DRAM_CHANNEL::request_type request{packet};
+    request.event_cycle = current_cycle;
+    request.bank_index = dram_get_rank(packet.address) * DRAM_BANKS + dram_get_bank(packet.address);
     if (packet.response_requested)
-      rq_it->value().to_return = {&ul->returned};
+      request.to_return = {&ul->returned};
 
+    channel.add_request(channel.RQ, rq_it, std::move(request));
     return true;
   }
 
@@ -322,10 +628,11 @@ bool MEMORY_CONTROLLER::add_wq(const request_type& packet)
   // search for the empty index
   if (auto wq_it = std::find_if_not(std::begin(channel.WQ), std::end(channel.WQ), [](const auto& pkt) { return pkt.has_value(); });
       wq_it != std::end(channel.WQ)) {
-    *wq_it = DRAM_CHANNEL::request_type{packet};
-    wq_it->value().forward_checked = false;
-    wq_it->value().event_cycle = current_cycle;
+    DRAM_CHANNEL::request_type request{packet};
+    request.event_cycle = current_cycle;
+    request.bank_index = dram_get_rank(packet.address) * DRAM_BANKS + dram_get_bank(packet.address);
 
+    channel.add_request(channel.WQ, wq_it, std::move(request));
     return true;
   }
 
@@ -338,31 +645,31 @@ bool MEMORY_CONTROLLER::add_wq(const request_type& packet)
  * offset |
  */
 
-uint32_t MEMORY_CONTROLLER::dram_get_channel(uint64_t address)
+uint32_t MEMORY_CONTROLLER::dram_get_channel(uint64_t address) const
 {
   int shift = LOG2_BLOCK_SIZE;
   return (address >> shift) & champsim::bitmask(champsim::lg2(DRAM_CHANNELS));
 }
 
-uint32_t MEMORY_CONTROLLER::dram_get_bank(uint64_t address)
+uint32_t MEMORY_CONTROLLER::dram_get_bank(uint64_t address) const
 {
   int shift = champsim::lg2(DRAM_CHANNELS) + LOG2_BLOCK_SIZE;
   return (address >> shift) & champsim::bitmask(champsim::lg2(DRAM_BANKS));
 }
 
-uint32_t MEMORY_CONTROLLER::dram_get_column(uint64_t address)
+uint32_t MEMORY_CONTROLLER::dram_get_column(uint64_t address) const
 {
   int shift = champsim::lg2(DRAM_BANKS) + champsim::lg2(DRAM_CHANNELS) + LOG2_BLOCK_SIZE;
   return (address >> shift) & champsim::bitmask(champsim::lg2(DRAM_COLUMNS));
 }
 
-uint32_t MEMORY_CONTROLLER::dram_get_rank(uint64_t address)
+uint32_t MEMORY_CONTROLLER::dram_get_rank(uint64_t address) const
 {
   int shift = champsim::lg2(DRAM_BANKS) + champsim::lg2(DRAM_COLUMNS) + champsim::lg2(DRAM_CHANNELS) + LOG2_BLOCK_SIZE;
   return (address >> shift) & champsim::bitmask(champsim::lg2(DRAM_RANKS));
 }
 
-uint32_t MEMORY_CONTROLLER::dram_get_row(uint64_t address)
+uint32_t MEMORY_CONTROLLER::dram_get_row(uint64_t address) const
 {
   int shift = champsim::lg2(DRAM_RANKS) + champsim::lg2(DRAM_BANKS) + champsim::lg2(DRAM_COLUMNS) + champsim::lg2(DRAM_CHANNELS) + LOG2_BLOCK_SIZE;
   return (address >> shift) & champsim::bitmask(champsim::lg2(DRAM_ROWS));
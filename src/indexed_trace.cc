@@ -0,0 +1,162 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "indexed_trace.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <lzma.h>
+#include <stdexcept>
+
+bool champsim::indexed_trace::has_footer(const std::string& fname)
+{
+  std::ifstream file{fname, std::ios::binary};
+  footer_type footer{};
+  file.seekg(-static_cast<std::streamoff>(sizeof(footer)), std::ios::end);
+  file.read(reinterpret_cast<char*>(&footer), sizeof(footer));
+  return file && footer.magic == magic;
+}
+
+champsim::indexed_trace_reader::indexed_trace_reader(std::string fname) : file_(fname, std::ios::binary)
+{
+  // A trace that cannot be opened reads as empty, as with an std::ifstream
+  if (!file_.is_open())
+    return;
+
+  file_.seekg(-static_cast<std::streamoff>(sizeof(footer_)), std::ios::end);
+  file_.read(reinterpret_cast<char*>(&footer_), sizeof(footer_));
+  if (!file_ || footer_.magic != indexed_trace::magic)
+    throw std::runtime_error{"Not an indexed trace: " + fname};
+
+  block_offsets_.resize(footer_.num_blocks + 1);
+  auto index_size = static_cast<std::streamoff>(std::size(block_offsets_) * sizeof(uint64_t));
+  file_.seekg(-static_cast<std::streamoff>(sizeof(footer_)) - index_size, std::ios::end);
+  file_.read(reinterpret_cast<char*>(std::data(block_offsets_)), index_size);
+  if (!file_)
+    throw std::runtime_error{"Could not read the index of trace: " + fname};
+
+  block_.reserve(footer_.block_size);
+  seek(0);
+}
+
+void champsim::indexed_trace_reader::load_block(uint64_t idx)
+{
+  block_idx_ = idx;
+  block_.clear();
+  if (idx >= footer_.num_blocks)
+    return;
+
+  compressed_.resize(block_offsets_[idx + 1] - block_offsets_[idx]);
+  file_.seekg(static_cast<std::streamoff>(block_offsets_[idx]));
+  file_.read(std::data(compressed_), static_cast<std::streamsize>(std::size(compressed_)));
+
+  block_.resize(footer_.block_size);
+  uint64_t memlimit = std::numeric_limits<uint64_t>::max();
+  std::size_t in_pos = 0, out_pos = 0;
+  auto ret = ::lzma_stream_buffer_decode(&memlimit, 0, nullptr, reinterpret_cast<const uint8_t*>(std::data(compressed_)), &in_pos,
+                                         std::size(compressed_), reinterpret_cast<uint8_t*>(std::data(block_)), &out_pos, std::size(block_));
+  if (ret != LZMA_OK)
+    throw std::runtime_error{"Could not decompress block " + std::to_string(idx) + " of an indexed trace"};
+  block_.resize(out_pos);
+}
+
+void champsim::indexed_trace_reader::seek(uint64_t pos)
+{
+  eof_ = false;
+  if (footer_.block_size == 0)
+    return;
+
+  if (auto idx = pos / footer_.block_size; idx != block_idx_ || std::empty(block_))
+    load_block(idx);
+  block_pos_ = static_cast<std::size_t>(pos % footer_.block_size);
+}
+
+auto champsim::indexed_trace_reader::read(char* s, std::streamsize count) -> indexed_trace_reader&
+{
+  gcount_ = 0;
+  while (gcount_ < count) {
+    if (block_pos_ >= std::size(block_)) {
+      if (std::empty(block_) || block_idx_ + 1 >= footer_.num_blocks) {
+        eof_ = true;
+        break;
+      }
+      load_block(block_idx_ + 1);
+      block_pos_ = 0;
+    }
+
+    auto available = std::min(static_cast<std::size_t>(count - gcount_), std::size(block_) - block_pos_);
+    std::copy_n(std::next(std::cbegin(block_), static_cast<long>(block_pos_)), available, std::next(s, gcount_));
+    block_pos_ += available;
+    gcount_ += static_cast<std::streamsize>(available);
+  }
+  return *this;
+}
+
+champsim::indexed_trace_writer::indexed_trace_writer(std::ostream& out, std::size_t block_size) : out_(out), block_size_(block_size)
+{
+  assert(block_size > 0);
+  block_.reserve(block_size);
+}
+
+champsim::indexed_trace_writer::~indexed_trace_writer()
+{
+  if (!finished_)
+    finish();
+}
+
+void champsim::indexed_trace_writer::flush_block()
+{
+  if (std::empty(block_))
+    return;
+
+  std::vector<uint8_t> compressed(::lzma_stream_buffer_bound(std::size(block_)));
+  std::size_t out_pos = 0;
+  [[maybe_unused]] auto ret = ::lzma_easy_buffer_encode(LZMA_PRESET_DEFAULT, LZMA_CHECK_CRC64, nullptr, reinterpret_cast<const uint8_t*>(std::data(block_)),
+                                                        std::size(block_), std::data(compressed), &out_pos, std::size(compressed));
+  assert(ret == LZMA_OK);
+
+  out_.write(reinterpret_cast<const char*>(std::data(compressed)), static_cast<std::streamsize>(out_pos));
+  block_offsets_.push_back(block_offsets_.back() + out_pos);
+  block_.clear();
+}
+
+auto champsim::indexed_trace_writer::write(const char* s, std::streamsize count) -> indexed_trace_writer&
+{
+  assert(!finished_);
+  auto remaining = static_cast<std::size_t>(count);
+  while (remaining > 0) {
+    auto chunk = std::min(remaining, block_size_ - std::size(block_));
+    block_.insert(std::end(block_), s, std::next(s, static_cast<long>(chunk)));
+    s = std::next(s, static_cast<long>(chunk));
+    remaining -= chunk;
+    total_size_ += chunk;
+
+    if (std::size(block_) == block_size_)
+      flush_block();
+  }
+  return *this;
+}
+
+void champsim::indexed_trace_writer::finish()
+{
+  flush_block();
+  indexed_trace::footer_type footer{block_size_, std::size(block_offsets_) - 1, total_size_, indexed_trace::magic};
+  out_.write(reinterpret_cast<const char*>(std::data(block_offsets_)), static_cast<std::streamsize>(std::size(block_offsets_) * sizeof(uint64_t)));
+  out_.write(reinterpret_cast<const char*>(&footer), sizeof(footer));
+  out_.flush();
+  finished_ = true;
+}
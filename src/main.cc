@@ -15,16 +15,24 @@
  */
 
 #include <algorithm>
+#include <cmath>
+#include <exception>
 #include <fstream>
+#include <memory>
 #include <numeric>
+#include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "champsim.h"
 #include "champsim_constants.h"
 #include "core_inst.inc"
+#include "inf_stream.h"
 #include "phase_info.h"
+#include "region.h"
 #include "stats_printer.h"
+#include "trace_format.h"
 #include "tracereader.h"
 #include "vmem.h"
 #include <CLI/CLI.hpp>
@@ -32,9 +40,83 @@
 
 namespace champsim
 {
-std::vector<phase_stats> main(environment& env, std::vector<phase_info>& phases, std::vector<tracereader>& traces);
+std::vector<phase_stats> main(environment& env, std::vector<phase_info>& phases, std::vector<tracereader>& traces, std::size_t num_threads);
+std::vector<phase_stats> run_phases(environment& env, std::vector<phase_info>& phases, std::vector<tracereader>& traces, std::size_t num_threads);
+} // namespace champsim
+
+namespace
+{
+std::vector<champsim::phase_info> make_phases(uint64_t warmup_instructions, uint64_t simulation_instructions, const std::vector<std::string>& trace_names)
+{
+  std::vector<champsim::phase_info> phases{
+      {champsim::phase_info{"Warmup", true, warmup_instructions, std::vector<std::size_t>(std::size(trace_names), 0), trace_names},
+       champsim::phase_info{"Simulation", false, simulation_instructions, std::vector<std::size_t>(std::size(trace_names), 0), trace_names}}};
+
+  for (auto& p : phases)
+    std::iota(std::begin(p.trace_index), std::end(p.trace_index), 0);
+
+  return phases;
 }
 
+// Simulate each region in its own environment, with up to num_threads regions at once
+std::vector<champsim::phase_stats> run_regions(const std::vector<champsim::region_info>& regions, const std::vector<std::string>& trace_names,
+                                               bool cloudsuite, bool async_read, const std::string& cache_directory, bool hide_heartbeat,
+                                               std::size_t num_threads)
+{
+  std::vector<champsim::phase_stats> results(std::size(regions));
+  std::vector<std::exception_ptr> errors(std::size(regions));
+
+  // Modules keep their state in global containers, keyed by the component that owns it and filled as components are initialized. The regions
+  // are simulated in waves of up to num_threads, and every environment of a wave is initialized before any of its regions begins, so that
+  // the running regions only read those containers, and never share an entry.
+  auto wave_size = std::max<std::size_t>(num_threads, 1);
+  for (std::size_t first = 0; first < std::size(regions); first += wave_size) {
+    auto last = std::min(first + wave_size, std::size(regions));
+
+    std::vector<std::unique_ptr<champsim::configured::generated_environment>> environments;
+    for (std::size_t i = first; i < last; ++i) {
+      auto& env = environments.emplace_back(std::make_unique<champsim::configured::generated_environment>());
+      for (O3_CPU& cpu : env->cpu_view())
+        cpu.show_heartbeat = cpu.show_heartbeat && !hide_heartbeat;
+      for (champsim::operable& op : env->operable_view())
+        op.initialize();
+    }
+
+    auto simulate = [&](std::size_t i) {
+      try {
+        const auto& region = regions.at(i);
+
+        // Each region reads its own copy of the traces, beginning at the warmup
+        std::vector<champsim::tracereader> traces;
+        std::transform(std::begin(trace_names), std::end(trace_names), std::back_inserter(traces),
+                       [cloudsuite, async_read, &cache_directory, skip = region.start - region.warmup, cpu = uint8_t(0)](auto name) mutable {
+                         return get_tracereader(name, cpu++, cloudsuite, true, async_read, skip, cache_directory);
+                       });
+
+        auto phases = make_phases(region.warmup, region.length, trace_names);
+        results.at(i) = champsim::run_phases(*environments.at(i - first), phases, traces, 1).back();
+      } catch (...) {
+        errors.at(i) = std::current_exception();
+      }
+    };
+
+    std::vector<std::thread> workers;
+    for (std::size_t i = first + 1; i < last; ++i)
+      workers.emplace_back(simulate, i);
+    simulate(first);
+    for (auto& worker : workers)
+      worker.join();
+  }
+
+  for (auto& error : errors) {
+    if (error)
+      std::rethrow_exception(error);
+  }
+
+  return results;
+}
+} // namespace
+
 int main(int argc, char** argv)
 {
   champsim::configured::generated_environment gen_environment{};
@@ -42,18 +124,20 @@ int main(int argc, char** argv)
   CLI::App app{"A microarchitecture simulator for research and education"};
 
   bool knob_cloudsuite{false};
+  bool knob_async_read{false};
+  bool knob_hide_heartbeat{false};
   uint64_t warmup_instructions = 0;
+  uint64_t skip_instructions = 0;
   uint64_t simulation_instructions = std::numeric_limits<uint64_t>::max();
+  std::size_t num_threads = 1;
   std::string json_file_name;
+  std::string regions_file_name;
+  std::string trace_cache_directory;
   std::vector<std::string> trace_names;
 
-  auto set_heartbeat_callback = [&](auto) {
-    for (O3_CPU& cpu : gen_environment.cpu_view())
-      cpu.show_heartbeat = false;
-  };
-
-  app.add_flag("-c,--cloudsuite", knob_cloudsuite, "Read all traces using the cloudsuite format");
-  app.add_flag("--hide-heartbeat", set_heartbeat_callback, "Hide the heartbeat output");
+  app.add_flag("-c,--cloudsuite", knob_cloudsuite, "Read all traces using the cloudsuite format, except compact traces, which record their own");
+  app.add_flag("--async-read", knob_async_read, "Decompress and decode each trace on a background thread");
+  app.add_flag("--hide-heartbeat", knob_hide_heartbeat, "Hide the heartbeat output");
   auto warmup_instr_option = app.add_option("-w,--warmup-instructions", warmup_instructions, "The number of instructions in the warmup phase");
   auto deprec_warmup_instr_option =
       app.add_option("--warmup_instructions", warmup_instructions, "[deprecated] use --warmup-instructions instead")->excludes(warmup_instr_option);
@@ -62,10 +146,61 @@ int main(int argc, char** argv)
   auto deprec_sim_instr_option =
       app.add_option("--simulation_instructions", simulation_instructions, "[deprecated] use --simulation-instructions instead")->excludes(sim_instr_option);
 
+  auto skip_instr_option = app.add_option("--skip-instructions", skip_instructions,
+                 "The number of instructions at the start of each trace to skip before the warmup phase. Indexed and uncompressed traces seek "
+                 "directly to the first instruction.");
+
+  app.add_option("-j,--threads", num_threads,
+                 "The number of threads used to operate the cores, or, with --regions, to simulate the regions. With more than one, the components "
+                 "private to each core are operated in parallel, or up to this many regions are simulated at once, each in an environment of its own.")
+      ->check(CLI::PositiveNumber);
+
+  app.add_option("--trace-cache", trace_cache_directory,
+                 "A directory in which to keep decompressed copies of compressed traces. A trace is decompressed once, by the first process to "
+                 "read it, and mapped into memory by every later reader.")
+      ->check(CLI::ExistingDirectory);
+
+  app.add_option("--trace-buffer-size", champsim::max_buffered_trace_bytes,
+                 "The largest trace, in bytes after decompression, that is kept in memory to be repeated. Larger traces that cannot seek are "
+                 "reopened each time they are repeated.");
+
+  app.add_option("--decompression-threads", champsim::decomp_tags::lzma_threads,
+                 "The number of threads used to decompress each xz trace. Only traces compressed in multiple blocks, such as by xz -T0, can use more "
+                 "than one. If 0, one thread is used for each processor.");
+
+  auto regions_option = app.add_option("--regions", regions_file_name,
+                                       "A file listing regions of the traces to simulate, one per line as \"start warmup length weight\". Each region is "
+                                       "simulated separately, up to --threads at once, and the statistics are combined in proportion to the weights.")
+                            ->check(CLI::ExistingFile)
+                            ->excludes(warmup_instr_option)
+                            ->excludes(deprec_warmup_instr_option)
+                            ->excludes(sim_instr_option)
+                            ->excludes(deprec_sim_instr_option)
+                            ->excludes(skip_instr_option);
+
   auto json_option =
       app.add_option("--json", json_file_name, "The name of the file to receive JSON output. If no name is specified, stdout will be used")->expected(0, 1);
 
-  app.add_option("traces", trace_names, "The paths to the traces")->required()->expected(NUM_CPUS)->check(CLI::ExistingFile);
+  // A trace that is not a file may be generated by a registered format, which rejects a malformed name when its reader is made.
+  // A trace that is a file is not opened here, since a pipe can be read only once.
+  CLI::Validator trace_source{[](std::string& name) -> std::string {
+                                auto missing = CLI::ExistingFile(name);
+                                if (std::empty(missing))
+                                  return {};
+                                if (!champsim::is_registered_trace(name))
+                                  return missing;
+                                try {
+                                  champsim::find_trace_format(name).make_reader(name, {});
+                                } catch (const std::invalid_argument& err) {
+                                  return err.what();
+                                }
+                                return {};
+                              },
+                              "TRACE"};
+  app.add_option("traces", trace_names, "The paths to the traces, or synthetic workloads such as gen:stream:stride=64:footprint=1G")
+      ->required()
+      ->expected(NUM_CPUS)
+      ->check(trace_source);
 
   CLI11_PARSE(app, argc, argv);
 
@@ -81,32 +216,71 @@ int main(int argc, char** argv)
   if (simulation_given && !warmup_given)
     warmup_instructions = simulation_instructions * 2 / 10;
 
-  std::vector<champsim::tracereader> traces;
-  std::transform(
-      std::begin(trace_names), std::end(trace_names), std::back_inserter(traces),
-      [knob_cloudsuite, repeat = simulation_given, i = uint8_t(0)](auto name) mutable { return get_tracereader(name, i++, knob_cloudsuite, repeat); });
+  std::vector<champsim::phase_stats> phase_stats;
+  if (regions_option->count() > 0) {
+    std::ifstream regions_file{regions_file_name};
+    std::vector<champsim::region_info> regions;
+    try {
+      regions = champsim::read_regions(regions_file);
+    } catch (const std::invalid_argument& err) {
+      fmt::print(stderr, "{}: {}\n", regions_file_name, err.what());
+      return 1;
+    }
 
-  std::vector<champsim::phase_info> phases{
-      {champsim::phase_info{"Warmup", true, warmup_instructions, std::vector<std::size_t>(std::size(trace_names), 0), trace_names},
-       champsim::phase_info{"Simulation", false, simulation_instructions, std::vector<std::size_t>(std::size(trace_names), 0), trace_names}}};
+    if (std::empty(regions)) {
+      fmt::print(stderr, "{}: no regions are listed\n", regions_file_name);
+      return 1;
+    }
 
-  for (auto& p : phases)
-    std::iota(std::begin(p.trace_index), std::end(p.trace_index), 0);
+    fmt::print("\n*** ChampSim Multicore Out-of-Order Simulator ***\nRegions: {}\nNumber of CPUs: {}\nPage size: {}\n\n", std::size(regions),
+               std::size(gen_environment.cpu_view()), PAGE_SIZE);
+
+    auto region_stats = run_regions(regions, trace_names, knob_cloudsuite, knob_async_read, trace_cache_directory, knob_hide_heartbeat, num_threads);
+
+    fmt::print("\nChampSim completed all regions\n\n");
+
+    for (std::size_t i = 0; i < std::size(regions); ++i) {
+      for (const auto& stats : region_stats.at(i).roi_cpu_stats) {
+        fmt::print("Region {} start: {} warmup: {} length: {} weight: {:.4g} {} cumulative IPC: {:.4g}\n", i, regions.at(i).start, regions.at(i).warmup,
+                   regions.at(i).length, regions.at(i).weight, stats.name, std::ceil(stats.instrs()) / std::ceil(stats.cycles()));
+      }
+    }
+
+    std::vector<double> weights;
+    std::transform(std::begin(regions), std::end(regions), std::back_inserter(weights), [](const auto& region) { return region.weight; });
+    phase_stats.push_back(champsim::weighted_sum(region_stats, weights));
 
-  fmt::print("\n*** ChampSim Multicore Out-of-Order Simulator ***\nWarmup Instructions: {}\nSimulation Instructions: {}\nNumber of CPUs: {}\nPage size: {}\n\n",
-             phases.at(0).length, phases.at(1).length, std::size(gen_environment.cpu_view()), PAGE_SIZE);
+    champsim::plain_printer{std::cout}.print(phase_stats);
+  } else {
+    for (O3_CPU& cpu : gen_environment.cpu_view())
+      cpu.show_heartbeat = cpu.show_heartbeat && !knob_hide_heartbeat;
+
+    std::vector<champsim::tracereader> traces;
+    std::transform(
+        std::begin(trace_names), std::end(trace_names), std::back_inserter(traces),
+        [knob_cloudsuite, knob_async_read, skip_instructions, &trace_cache_directory, repeat = simulation_given, i = uint8_t(0)](auto name) mutable {
+          return get_tracereader(name, i++, knob_cloudsuite, repeat, knob_async_read, skip_instructions, trace_cache_directory);
+        });
+
+    auto phases = make_phases(warmup_instructions, simulation_instructions, trace_names);
 
-  auto phase_stats = champsim::main(gen_environment, phases, traces);
+    fmt::print("\n*** ChampSim Multicore Out-of-Order Simulator ***\nWarmup Instructions: {}\nSimulation Instructions: {}\nNumber of CPUs: {}\nPage size: {}\n\n",
+               phases.at(0).length, phases.at(1).length, std::size(gen_environment.cpu_view()), PAGE_SIZE);
 
-  fmt::print("\nChampSim completed all CPUs\n\n");
+    phase_stats = champsim::main(gen_environment, phases, traces, num_threads);
 
-  champsim::plain_printer{std::cout}.print(phase_stats);
+    fmt::print("\nChampSim completed all CPUs\n\n");
 
-  for (CACHE& cache : gen_environment.cache_view())
-    cache.impl_prefetcher_final_stats();
+    champsim::plain_printer{std::cout}.print(phase_stats);
 
-  for (CACHE& cache : gen_environment.cache_view())
-    cache.impl_replacement_final_stats();
+    for (CACHE& cache : gen_environment.cache_view())
+      cache.impl_prefetcher_final_stats();
+
+    for (CACHE& cache : gen_environment.cache_view())
+      cache.impl_replacement_final_stats();
+
+    gen_environment.dram_view().impl_dram_scheduler_final_stats();
+  }
 
   if (json_option->count() > 0) {
     if (json_file_name.empty()) {
@@ -0,0 +1,108 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mapped_file.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+champsim::mapped_file::mapped_file(std::string fname)
+{
+  auto fd = ::open(fname.c_str(), O_RDONLY);
+  if (fd < 0)
+    return;
+
+  // A pipe or a device has no size to map, and must not be mistaken for an empty trace
+  struct stat st;
+  if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+    ::close(fd);
+    throw std::runtime_error{"Not a regular file, so it cannot be mapped: " + fname};
+  }
+
+  if (st.st_size > 0) {
+    auto size = static_cast<std::size_t>(st.st_size);
+    auto addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr == MAP_FAILED) {
+      ::close(fd);
+      throw std::runtime_error{"Could not map the file: " + fname};
+    }
+    data_ = static_cast<const char*>(addr);
+    size_ = size;
+
+    // The trace is read once, front to back. These are hints, so failures are ignored.
+    ::madvise(addr, size, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+    ::madvise(addr, size, MADV_HUGEPAGE);
+#endif
+  }
+
+  // The mapping holds its own reference to the file
+  ::close(fd);
+}
+
+champsim::mapped_file::mapped_file(mapped_file&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)), pos_(other.pos_), gcount_(other.gcount_), eof_(other.eof_)
+{
+}
+
+auto champsim::mapped_file::operator=(mapped_file&& other) noexcept -> mapped_file&
+{
+  unmap();
+  data_ = std::exchange(other.data_, nullptr);
+  size_ = std::exchange(other.size_, 0);
+  pos_ = other.pos_;
+  gcount_ = other.gcount_;
+  eof_ = other.eof_;
+  return *this;
+}
+
+champsim::mapped_file::~mapped_file() { unmap(); }
+
+void champsim::mapped_file::unmap()
+{
+  if (data_ != nullptr)
+    ::munmap(const_cast<char*>(data_), size_);
+  data_ = nullptr;
+}
+
+std::string_view champsim::mapped_file::view(std::size_t count)
+{
+  auto available = std::min(count, size_ - pos_);
+  std::string_view retval{data_ + pos_, available};
+  pos_ += available;
+  gcount_ = static_cast<std::streamsize>(available);
+  eof_ = eof_ || (available < count);
+  return retval;
+}
+
+void champsim::mapped_file::seek(uint64_t pos)
+{
+  pos_ = static_cast<std::size_t>(std::min<uint64_t>(pos, size_));
+  eof_ = false;
+}
+
+auto champsim::mapped_file::read(char* s, std::streamsize count) -> mapped_file&
+{
+  auto bytes = view(static_cast<std::size_t>(count));
+  std::copy(std::begin(bytes), std::end(bytes), s);
+  return *this;
+}
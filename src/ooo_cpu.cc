@@ -32,6 +32,14 @@
 
 std::chrono::seconds elapsed_time();
 
+namespace
+{
+void insert_in_program_order(std::vector<std::reference_wrapper<ooo_model_instr>>& instrs, ooo_model_instr& instr)
+{
+  instrs.insert(std::upper_bound(std::begin(instrs), std::end(instrs), instr, ooo_model_instr::program_order), std::ref(instr));
+}
+} // namespace
+
 long O3_CPU::operate()
 {
   long progress{0};
@@ -59,8 +67,12 @@ long O3_CPU::operate()
     auto phase_instr{std::ceil(num_retired - begin_phase_instr)};
     auto phase_cycle{std::ceil(current_cycle - begin_phase_cycle)};
 
-    fmt::print("Heartbeat CPU {} instructions: {} cycles: {} heartbeat IPC: {:.4g} cumulative IPC: {:.4g} (Simulation time: {:%H hr %M min %S sec})\n", cpu,
-               num_retired, current_cycle, heartbeat_instr / heartbeat_cycle, phase_instr / phase_cycle, elapsed_time());
+    auto heartbeat = fmt::format("Heartbeat CPU {} instructions: {} cycles: {} heartbeat IPC: {:.4g} cumulative IPC: {:.4g} (Simulation time: {:%H hr %M min %S sec})\n",
+                                 cpu, num_retired, current_cycle, heartbeat_instr / heartbeat_cycle, phase_instr / phase_cycle, elapsed_time());
+    if (defer_output)
+      deferred_output += heartbeat;
+    else
+      fmt::print("{}", heartbeat);
     next_print_instruction += STAT_PRINTING_PERIOD;
 
     last_heartbeat_instr = num_retired;
@@ -70,6 +82,59 @@ long O3_CPU::operate()
   return progress;
 }
 
+uint64_t O3_CPU::next_event_cycle() const
+{
+  // Retirement, memory returns, the heartbeat, and fetches are performed as soon as they are possible
+  auto fetch_ready = [](const ooo_model_instr& x) { return !x.dib_checked || (x.dib_checked == COMPLETED && !x.fetched); };
+  if ((!std::empty(ROB) && ROB.front().executed == COMPLETED) || !std::empty(L1I_bus.lower_level->returned) || !std::empty(L1D_bus.lower_level->returned)
+      || (show_heartbeat && (num_retired >= next_print_instruction)) || std::any_of(std::begin(IFETCH_BUFFER), std::end(IFETCH_BUFFER), fetch_ready))
+    return current_cycle;
+
+  // Instructions in the scheduling window are scheduled immediately
+  auto first_unscheduled = std::find_if(std::next(std::begin(ROB), static_cast<long>(std::min(schedule_head, std::size(ROB)))), std::end(ROB),
+                                        [](const ooo_model_instr& x) { return x.scheduled == 0; });
+  if (first_unscheduled != std::end(ROB) && num_scheduled_unexecuted < SCHEDULER_SIZE)
+    return current_cycle;
+
+  uint64_t next = std::numeric_limits<uint64_t>::max();
+  auto wake_at = [&next](uint64_t cycle) { next = std::min(next, cycle); };
+
+  for (const ooo_model_instr& x : inflight_instrs) {
+    if (x.completed_mem_ops == x.num_mem_ops())
+      wake_at(x.event_cycle); // complete_inflight_instruction()
+  }
+  for (const ooo_model_instr& x : ready_instrs)
+    wake_at(x.event_cycle); // execute_instruction()
+
+  const auto complete_id = std::empty(ROB) ? std::numeric_limits<uint64_t>::max() : ROB.front().instr_id;
+  for (const auto& sq_entry : SQ) {
+    if (!sq_entry.fetch_issued || sq_entry.instr_id < complete_id)
+      wake_at(sq_entry.event_cycle);
+  }
+
+  for (const auto& lq_entry : LQ) {
+    if (lq_entry.has_value() && lq_entry->producer_id == std::numeric_limits<uint64_t>::max() && !lq_entry->fetch_issued)
+      wake_at(lq_entry->event_cycle + 1);
+  }
+
+  if (!std::empty(DISPATCH_BUFFER) && std::size(ROB) != ROB_SIZE
+      && (LQ_free_slots.num_free()
+          >= std::size(DISPATCH_BUFFER.front().source_memory))
+      && ((std::size(DISPATCH_BUFFER.front().destination_memory) + std::size(SQ)) <= SQ_SIZE))
+    wake_at(DISPATCH_BUFFER.front().event_cycle + 1);
+
+  if (!std::empty(DECODE_BUFFER) && std::size(DISPATCH_BUFFER) < DISPATCH_BUFFER_SIZE)
+    wake_at(DECODE_BUFFER.front().event_cycle);
+
+  if (!std::empty(IFETCH_BUFFER) && std::size(DECODE_BUFFER) < DECODE_BUFFER_SIZE && IFETCH_BUFFER.front().fetched == COMPLETED)
+    wake_at(IFETCH_BUFFER.front().event_cycle);
+
+  if (!std::empty(input_queue) && std::size(IFETCH_BUFFER) < IFETCH_BUFFER_SIZE)
+    wake_at(fetch_resume_cycle);
+
+  return next;
+}
+
 void O3_CPU::initialize()
 {
   // BRANCH PREDICTOR & BTB
@@ -116,7 +181,7 @@ void O3_CPU::initialize_instruction()
       instrs_to_read_this_cycle = 0;
 
     // Add to IFETCH_BUFFER
-    IFETCH_BUFFER.push_back(input_queue.front());
+    IFETCH_BUFFER.push_back(std::move(input_queue.front()));
     input_queue.pop_front();
 
     IFETCH_BUFFER.back().event_cycle = current_cycle;
@@ -256,7 +321,7 @@ long O3_CPU::fetch_instruction()
   return progress;
 }
 
-bool O3_CPU::do_fetch_instruction(std::deque<ooo_model_instr>::iterator begin, std::deque<ooo_model_instr>::iterator end)
+bool O3_CPU::do_fetch_instruction(champsim::circular_buffer<ooo_model_instr>::iterator begin, champsim::circular_buffer<ooo_model_instr>::iterator end)
 {
   CacheBus::request_type fetch_packet;
   fetch_packet.v_address = begin->ip;
@@ -328,7 +393,7 @@ long O3_CPU::dispatch_instruction()
 
   // dispatch DISPATCH_WIDTH instructions into the ROB
   while (available_dispatch_bandwidth > 0 && !std::empty(DISPATCH_BUFFER) && DISPATCH_BUFFER.front().event_cycle < current_cycle && std::size(ROB) != ROB_SIZE
-         && ((std::size_t)std::count_if(std::begin(LQ), std::end(LQ), [](const auto& lq_entry) { return !lq_entry.has_value(); })
+         && (LQ_free_slots.num_free()
              >= std::size(DISPATCH_BUFFER.front().source_memory))
          && ((std::size(DISPATCH_BUFFER.front().destination_memory) + std::size(SQ)) <= SQ_SIZE)) {
     ROB.push_back(std::move(DISPATCH_BUFFER.front()));
@@ -343,9 +408,14 @@ long O3_CPU::dispatch_instruction()
 
 long O3_CPU::schedule_instruction()
 {
-  auto search_bw = SCHEDULER_SIZE;
+  // Instructions are scheduled in program order, so the scheduled instructions are a prefix of the ROB.
+  // The scheduling window extends until it holds SCHEDULER_SIZE instructions that have not begun to execute.
+  while (schedule_head < std::size(ROB) && ROB[schedule_head].scheduled != 0)
+    ++schedule_head;
+
+  auto search_bw = SCHEDULER_SIZE - num_scheduled_unexecuted;
   int progress{0};
-  for (auto rob_it = std::begin(ROB); rob_it != std::end(ROB) && search_bw > 0; ++rob_it) {
+  for (auto rob_it = std::next(std::begin(ROB), static_cast<long>(schedule_head)); rob_it != std::end(ROB) && search_bw > 0; ++rob_it) {
     if (rob_it->scheduled == 0) {
       do_scheduling(*rob_it);
       ++progress;
@@ -353,6 +423,7 @@ long O3_CPU::schedule_instruction()
 
     if (rob_it->executed == 0)
       --search_bw;
+    ++schedule_head;
   }
 
   return progress;
@@ -364,8 +435,8 @@ void O3_CPU::do_scheduling(ooo_model_instr& instr)
   for (auto src_reg : instr.source_registers) {
     if (!std::empty(reg_producers[src_reg])) {
       ooo_model_instr& prior = reg_producers[src_reg].back();
-      if (prior.registers_instrs_depend_on_me.empty() || prior.registers_instrs_depend_on_me.back().get().instr_id != instr.instr_id) {
-        prior.registers_instrs_depend_on_me.push_back(instr);
+      if (prior.registers_instrs_depend_on_me == nullptr || prior.registers_instrs_depend_on_me->dependent->instr_id != instr.instr_id) {
+        prior.add_register_dependent(instr);
         instr.num_reg_dependent++;
       }
     }
@@ -380,17 +451,28 @@ void O3_CPU::do_scheduling(ooo_model_instr& instr)
 
   instr.scheduled = COMPLETED;
   instr.event_cycle = current_cycle + (warmup ? 0 : SCHEDULING_LATENCY);
+
+  if (instr.executed == 0) {
+    ++num_scheduled_unexecuted;
+    if (instr.num_reg_dependent == 0)
+      insert_in_program_order(ready_instrs, instr);
+  }
 }
 
 long O3_CPU::execute_instruction()
 {
+  // Execute the oldest ready instructions, keeping the rest in order
   auto exec_bw = EXEC_WIDTH;
-  for (auto rob_it = std::begin(ROB); rob_it != std::end(ROB) && exec_bw > 0; ++rob_it) {
-    if (rob_it->scheduled == COMPLETED && rob_it->executed == 0 && rob_it->num_reg_dependent == 0 && rob_it->event_cycle <= current_cycle) {
-      do_execution(*rob_it);
+  auto keep_end = std::begin(ready_instrs);
+  for (auto it = std::begin(ready_instrs); it != std::end(ready_instrs); ++it) {
+    if (exec_bw > 0 && it->get().event_cycle <= current_cycle) {
+      do_execution(*it);
       --exec_bw;
+    } else {
+      *keep_end++ = *it;
     }
   }
+  ready_instrs.erase(keep_end, std::end(ready_instrs));
 
   return EXEC_WIDTH - exec_bw;
 }
@@ -399,6 +481,8 @@ void O3_CPU::do_execution(ooo_model_instr& rob_entry)
 {
   rob_entry.executed = INFLIGHT;
   rob_entry.event_cycle = current_cycle + (warmup ? 0 : EXEC_LATENCY);
+  --num_scheduled_unexecuted;
+  insert_in_program_order(inflight_instrs, rob_entry);
 
   // Mark LQ entries as ready to translate
   for (auto& lq_entry : LQ)
@@ -419,17 +503,17 @@ void O3_CPU::do_memory_scheduling(ooo_model_instr& instr)
 {
   // load
   for (auto& smem : instr.source_memory) {
-    auto q_entry = std::find_if_not(std::begin(LQ), std::end(LQ), [](const auto& lq_entry) { return lq_entry.has_value(); });
-    assert(q_entry != std::end(LQ));
+    auto slot = LQ_free_slots.find_free();
+    assert(slot != std::size(LQ));
+    LQ_free_slots.occupy(slot);
+    auto q_entry = std::next(std::begin(LQ), static_cast<long>(slot));
     q_entry->emplace(instr.instr_id, smem, instr.ip, instr.asid); // add it to the load queue
 
-    // Check for forwarding
-    auto sq_it = std::max_element(std::begin(SQ), std::end(SQ), [smem](const auto& lhs, const auto& rhs) {
-      return lhs.virtual_address != smem || (rhs.virtual_address == smem && lhs.instr_id < rhs.instr_id);
-    });
-    if (sq_it != std::end(SQ) && sq_it->virtual_address == smem) {
+    // Check for forwarding from the youngest store to the same address
+    if (auto found = SQ_youngest_store.find(smem); found != std::end(SQ_youngest_store)) {
+      auto sq_it = &found->second.get();
       if (sq_it->fetch_issued) { // Store already executed
-        q_entry->reset();
+        release_lq_entry(*q_entry);
         ++instr.completed_mem_ops;
 
         if constexpr (champsim::debug_print)
@@ -446,8 +530,12 @@ void O3_CPU::do_memory_scheduling(ooo_model_instr& instr)
   }
 
   // store
-  for (auto& dmem : instr.destination_memory)
-    SQ.emplace_back(instr.instr_id, dmem, instr.ip, instr.asid); // add it to the store queue
+  for (auto& dmem : instr.destination_memory) {
+    auto& sq_entry = SQ.emplace_back(instr.instr_id, dmem, instr.ip, instr.asid); // add it to the store queue
+    auto [found, inserted] = SQ_youngest_store.try_emplace(dmem, sq_entry);
+    if (!inserted && found->second.get().instr_id < sq_entry.instr_id)
+      found->second = sq_entry;
+  }
 
   if constexpr (champsim::debug_print) {
     fmt::print("[DISPATCH] {} instr_id: {} loads: {} stores: {}\n", __func__, instr.instr_id, std::size(instr.source_memory),
@@ -476,6 +564,8 @@ long O3_CPU::operate_lsq()
 
   auto [complete_begin, complete_end] = champsim::get_span_p(std::cbegin(SQ), std::cend(SQ), store_bw, do_complete);
   store_bw -= std::distance(complete_begin, complete_end);
+  for (auto it = complete_begin; it != complete_end; ++it)
+    release_sq_entry(it);
   SQ.erase(complete_begin, complete_end);
 
   auto load_bw = LQ_WIDTH;
@@ -504,10 +594,31 @@ void O3_CPU::do_finish_store(const LSQ_ENTRY& sq_entry)
     assert(dependent->producer_id == sq_entry.instr_id);
 
     dependent->finish(std::begin(ROB), std::end(ROB));
-    dependent.reset();
+    release_lq_entry(dependent);
   }
 }
 
+void O3_CPU::release_lq_entry(std::optional<LSQ_ENTRY>& lq_entry)
+{
+  LQ_free_slots.release(static_cast<std::size_t>(std::distance(std::data(LQ), &lq_entry)));
+  lq_entry.reset();
+}
+
+void O3_CPU::release_sq_entry(champsim::circular_buffer<LSQ_ENTRY>::const_iterator sq_entry)
+{
+  auto found = SQ_youngest_store.find(sq_entry->virtual_address);
+  if (found == std::end(SQ_youngest_store) || &found->second.get() != &*sq_entry)
+    return;
+
+  // Another store from the same instruction to the same address may remain
+  auto same_instr_end = std::find_if(std::next(sq_entry), std::cend(SQ), [id = sq_entry->instr_id](const auto& x) { return x.instr_id != id; });
+  auto sibling = std::find_if(std::next(sq_entry), same_instr_end, [addr = sq_entry->virtual_address](const auto& x) { return x.virtual_address == addr; });
+  if (sibling != same_instr_end)
+    found->second = SQ[static_cast<std::size_t>(std::distance(std::cbegin(SQ), sibling))];
+  else
+    SQ_youngest_store.erase(found);
+}
+
 bool O3_CPU::do_complete_store(const LSQ_ENTRY& sq_entry)
 {
   CacheBus::request_type data_packet;
@@ -548,13 +659,15 @@ void O3_CPU::do_complete_execution(ooo_model_instr& instr)
 
   instr.executed = COMPLETED;
 
-  for (ooo_model_instr& dependent : instr.registers_instrs_depend_on_me) {
+  instr.for_each_register_dependent([this](ooo_model_instr& dependent) {
     dependent.num_reg_dependent--;
     assert(dependent.num_reg_dependent >= 0);
 
-    if (dependent.num_reg_dependent == 0)
+    if (dependent.num_reg_dependent == 0) {
       dependent.scheduled = COMPLETED;
-  }
+      insert_in_program_order(this->ready_instrs, dependent);
+    }
+  });
 
   if (instr.branch_mispredicted)
     fetch_resume_cycle = current_cycle + BRANCH_MISPREDICT_PENALTY;
@@ -562,14 +675,19 @@ void O3_CPU::do_complete_execution(ooo_model_instr& instr)
 
 long O3_CPU::complete_inflight_instruction()
 {
-  // update ROB entries with completed executions
+  // update ROB entries with completed executions, oldest first
   auto complete_bw = EXEC_WIDTH;
-  for (auto rob_it = std::begin(ROB); rob_it != std::end(ROB) && complete_bw > 0; ++rob_it) {
-    if ((rob_it->executed == INFLIGHT) && (rob_it->event_cycle <= current_cycle) && rob_it->completed_mem_ops == rob_it->num_mem_ops()) {
-      do_complete_execution(*rob_it);
+  auto keep_end = std::begin(inflight_instrs);
+  for (auto it = std::begin(inflight_instrs); it != std::end(inflight_instrs); ++it) {
+    ooo_model_instr& instr = *it;
+    if (complete_bw > 0 && instr.event_cycle <= current_cycle && instr.completed_mem_ops == instr.num_mem_ops()) {
+      do_complete_execution(instr);
       --complete_bw;
+    } else {
+      *keep_end++ = *it;
     }
   }
+  inflight_instrs.erase(keep_end, std::end(inflight_instrs));
 
   return EXEC_WIDTH - complete_bw;
 }
@@ -608,7 +726,7 @@ long O3_CPU::handle_memory_return()
     for (auto& lq_entry : LQ) {
       if (lq_entry.has_value() && lq_entry->fetch_issued && lq_entry->virtual_address >> LOG2_BLOCK_SIZE == l1d_it->v_address >> LOG2_BLOCK_SIZE) {
         lq_entry->finish(std::begin(ROB), std::end(ROB));
-        lq_entry.reset();
+        release_lq_entry(lq_entry);
         ++progress;
       }
     }
@@ -629,6 +747,9 @@ long O3_CPU::retire_rob()
   num_retired += retire_count;
   ROB.erase(retire_begin, retire_end);
 
+  // Instructions placed directly into the ROB may retire without having been scheduled
+  schedule_head -= std::min(schedule_head, static_cast<std::size_t>(retire_count));
+
   return retire_count;
 }
 
@@ -673,9 +794,9 @@ LSQ_ENTRY::LSQ_ENTRY(uint64_t id, uint64_t addr, uint64_t local_ip, std::array<u
 {
 }
 
-void LSQ_ENTRY::finish(std::deque<ooo_model_instr>::iterator begin, std::deque<ooo_model_instr>::iterator end) const
+void LSQ_ENTRY::finish(champsim::circular_buffer<ooo_model_instr>::iterator begin, champsim::circular_buffer<ooo_model_instr>::iterator end) const
 {
-  auto rob_entry = std::partition_point(begin, end, [id = this->instr_id](auto x) { return x.instr_id < id; });
+  auto rob_entry = std::partition_point(begin, end, [id = this->instr_id](const auto& x) { return x.instr_id < id; });
   assert(rob_entry != end);
   assert(rob_entry->instr_id == this->instr_id);
 
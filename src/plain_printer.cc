@@ -87,6 +87,8 @@ void champsim::plain_printer::print(DRAM_CHANNEL::stats_type stats)
     fmt::print(stream, " AVG DBUS CONGESTED CYCLE: -\n");
   fmt::print(stream, "WQ ROW_BUFFER_HIT: {:10}\n  ROW_BUFFER_MISS: {:10}\n  FULL: {:10}\n", stats.name, stats.WQ_ROW_BUFFER_HIT, stats.WQ_ROW_BUFFER_MISS,
              stats.WQ_FULL);
+  if (stats.REFRESHES > 0 || stats.POWER_DOWN_CYCLES > 0)
+    fmt::print(stream, "REFRESHES: {:10}\n  POWER_DOWN_CYCLES: {:10}\n", stats.REFRESHES, stats.POWER_DOWN_CYCLES);
 }
 
 void champsim::plain_printer::print(champsim::phase_stats& stats)
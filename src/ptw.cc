@@ -16,6 +16,8 @@
 
 #include "ptw.h"
 
+#include <algorithm>
+#include <limits>
 #include <numeric>
 
 #include "champsim.h"
@@ -158,6 +160,19 @@ long PageTableWalker::operate()
   return progress;
 }
 
+uint64_t PageTableWalker::next_event_cycle() const
+{
+  if (!std::empty(lower_level->returned) || std::any_of(std::begin(upper_levels), std::end(upper_levels), [](auto ul) { return !std::empty(ul->RQ); }))
+    return current_cycle;
+
+  uint64_t next = std::numeric_limits<uint64_t>::max();
+  for (const auto& q : {std::cref(completed), std::cref(finished)}) {
+    for (const auto& x : q.get())
+      next = std::min(next, x.event_cycle);
+  }
+  return next;
+}
+
 void PageTableWalker::finish_packet(const response_type& packet)
 {
   auto finish_step = [this](auto& mshr_entry) {
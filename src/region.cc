@@ -0,0 +1,143 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "region.h"
+
+#include <cmath>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include <fmt/core.h>
+
+namespace
+{
+template <typename T>
+T scale(T value, double weight)
+{
+  return static_cast<T>(std::llround(weight * static_cast<double>(value)));
+}
+
+// Combine one element of each of a list of vectors of statistics
+template <typename Stats, typename F>
+std::vector<Stats> combine(const std::vector<champsim::phase_stats>& stats, std::vector<Stats> champsim::phase_stats::*member, F&& accumulate)
+{
+  std::vector<Stats> result;
+  for (std::size_t i = 0; i < std::size(stats.front().*member); ++i) {
+    Stats sum{};
+    sum.name = (stats.front().*member).at(i).name;
+    for (std::size_t j = 0; j < std::size(stats); ++j)
+      accumulate(sum, (stats.at(j).*member).at(i), j);
+    result.push_back(sum);
+  }
+  return result;
+}
+
+void finish_cache_stats(CACHE::stats_type& stats)
+{
+  uint64_t total_miss = 0;
+  for (const auto& type_misses : stats.misses)
+    total_miss = std::accumulate(std::begin(type_misses), std::end(type_misses), total_miss);
+  stats.avg_miss_latency = std::ceil(stats.total_miss_latency) / std::ceil(total_miss);
+}
+} // namespace
+
+std::vector<champsim::region_info> champsim::read_regions(std::istream& in)
+{
+  std::vector<region_info> result;
+  std::string line;
+  for (std::size_t lineno = 1; std::getline(in, line); ++lineno) {
+    std::istringstream line_stream{line};
+    std::string first_word;
+    if (!(line_stream >> first_word) || first_word.front() == '#')
+      continue;
+
+    line_stream.str(line);
+    line_stream.clear();
+    region_info region{};
+    if (!(line_stream >> region.start >> region.warmup >> region.length >> region.weight) || !(line_stream >> std::ws).eof())
+      throw std::invalid_argument{fmt::format("Region on line {} is not of the form \"start warmup length weight\"", lineno)};
+    if (region.warmup > region.start)
+      throw std::invalid_argument{fmt::format("Region on line {} has a warmup of {} instructions, longer than the {} before its start", lineno,
+                                              region.warmup, region.start)};
+    result.push_back(region);
+  }
+  return result;
+}
+
+champsim::phase_stats champsim::weighted_sum(const std::vector<phase_stats>& stats, const std::vector<double>& weights)
+{
+  if (std::empty(stats))
+    return {};
+
+  auto cpu_sum = [&weights](O3_CPU::stats_type& sum, const O3_CPU::stats_type& x, std::size_t j) {
+    auto w = weights.at(j);
+    sum.end_instrs += scale(x.instrs(), w);
+    sum.end_cycles += scale(x.cycles(), w);
+    sum.total_rob_occupancy_at_branch_mispredict += scale(x.total_rob_occupancy_at_branch_mispredict, w);
+    for (std::size_t k = 0; k < std::size(sum.total_branch_types); ++k) {
+      sum.total_branch_types.at(k) += scale(x.total_branch_types.at(k), w);
+      sum.branch_type_misses.at(k) += scale(x.branch_type_misses.at(k), w);
+    }
+  };
+
+  auto cache_sum = [&weights](CACHE::stats_type& sum, const CACHE::stats_type& x, std::size_t j) {
+    auto w = weights.at(j);
+    sum.pf_requested += scale(x.pf_requested, w);
+    sum.pf_issued += scale(x.pf_issued, w);
+    sum.pf_useful += scale(x.pf_useful, w);
+    sum.pf_useless += scale(x.pf_useless, w);
+    sum.pf_fill += scale(x.pf_fill, w);
+    for (std::size_t type = 0; type < std::size(sum.hits); ++type) {
+      for (std::size_t cpu = 0; cpu < std::size(sum.hits.at(type)); ++cpu) {
+        sum.hits.at(type).at(cpu) += scale(x.hits.at(type).at(cpu), w);
+        sum.misses.at(type).at(cpu) += scale(x.misses.at(type).at(cpu), w);
+      }
+    }
+    sum.total_miss_latency += scale(x.total_miss_latency, w);
+  };
+
+  auto dram_sum = [&weights](DRAM_CHANNEL::stats_type& sum, const DRAM_CHANNEL::stats_type& x, std::size_t j) {
+    auto w = weights.at(j);
+    sum.dbus_cycle_congested += scale(x.dbus_cycle_congested, w);
+    sum.dbus_count_congested += scale(x.dbus_count_congested, w);
+    sum.WQ_ROW_BUFFER_HIT += scale(x.WQ_ROW_BUFFER_HIT, w);
+    sum.WQ_ROW_BUFFER_MISS += scale(x.WQ_ROW_BUFFER_MISS, w);
+    sum.RQ_ROW_BUFFER_HIT += scale(x.RQ_ROW_BUFFER_HIT, w);
+    sum.RQ_ROW_BUFFER_MISS += scale(x.RQ_ROW_BUFFER_MISS, w);
+    sum.WQ_FULL += scale(x.WQ_FULL, w);
+    sum.REFRESHES += scale(x.REFRESHES, w);
+    sum.POWER_DOWN_CYCLES += scale(x.POWER_DOWN_CYCLES, w);
+  };
+
+  phase_stats result;
+  result.name = stats.front().name;
+  result.trace_names = stats.front().trace_names;
+  result.roi_cpu_stats = combine(stats, &phase_stats::roi_cpu_stats, cpu_sum);
+  result.sim_cpu_stats = combine(stats, &phase_stats::sim_cpu_stats, cpu_sum);
+  result.roi_cache_stats = combine(stats, &phase_stats::roi_cache_stats, cache_sum);
+  result.sim_cache_stats = combine(stats, &phase_stats::sim_cache_stats, cache_sum);
+  result.roi_dram_stats = combine(stats, &phase_stats::roi_dram_stats, dram_sum);
+  result.sim_dram_stats = combine(stats, &phase_stats::sim_dram_stats, dram_sum);
+
+  for (auto& cache_stats : result.roi_cache_stats)
+    finish_cache_stats(cache_stats);
+  for (auto& cache_stats : result.sim_cache_stats)
+    finish_cache_stats(cache_stats);
+
+  return result;
+}
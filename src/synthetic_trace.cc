@@ -0,0 +1,236 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "synthetic_trace.h"
+
+#include <algorithm>
+#include <cctype>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "trace_format.h"
+#include <fmt/core.h>
+
+namespace
+{
+constexpr uint64_t code_base = 0x400000;
+constexpr uint64_t data_base = 0x10000000;
+
+constexpr unsigned char reg_loaded = 1;
+constexpr unsigned char reg_index = 2;
+constexpr unsigned char reg_work = 3;
+
+std::vector<std::string_view> split(std::string_view spec)
+{
+  std::vector<std::string_view> fields;
+  for (auto pos = spec.find(':'); pos != std::string_view::npos; pos = spec.find(':')) {
+    fields.push_back(spec.substr(0, pos));
+    spec.remove_prefix(pos + 1);
+  }
+  fields.push_back(spec);
+  return fields;
+}
+
+double parse_fraction(std::string_view value)
+{
+  std::size_t pos = 0;
+  double result = 0;
+  try {
+    result = std::stod(std::string{value}, &pos);
+  } catch (const std::logic_error&) {
+    pos = 0; // Either not a number, or out of the range of a double
+  }
+  if (pos == 0 || pos != std::size(value))
+    throw std::invalid_argument{fmt::format("\"{}\" is not a number", value)};
+  return result;
+}
+
+// A bijection on the integers below 2^bits, which visits them in a scrambled order
+uint64_t scramble(uint64_t x, unsigned bits, uint64_t seed)
+{
+  auto mask = (uint64_t{1} << bits) - 1;
+  auto shift = (bits + 1) / 2;
+  x = (x * 0x9e3779b97f4a7c15ull) & mask;
+  x ^= x >> shift;
+  x = (x * 0xbf58476d1ce4e5b9ull) & mask;
+  x ^= x >> shift;
+  return x ^ (seed & mask);
+}
+
+champsim::trace_format_registration synthetic_format{champsim::trace_format{
+    "synthetic", [](const std::string& fname, std::string_view) { return fname.rfind("gen:", 0) == 0; },
+    [](const std::string& fname, const champsim::trace_options& options) {
+      champsim::synthetic_trace trace{options.cpu, champsim::synthetic::parse(fname)};
+      for (uint64_t i = 0; i < options.skip_instructions; ++i)
+        trace();
+      return champsim::tracereader{std::move(trace)};
+    }}};
+} // namespace
+
+uint64_t champsim::synthetic::parse_size(std::string_view size)
+{
+  auto digits_end = std::find_if_not(std::begin(size), std::end(size), [](unsigned char c) { return std::isdigit(c); });
+  auto digits = std::string{std::begin(size), digits_end};
+  auto suffix = std::string{digits_end, std::end(size)};
+  if (std::empty(digits))
+    throw std::invalid_argument{fmt::format("\"{}\" is not a size", size)};
+
+  std::transform(std::begin(suffix), std::end(suffix), std::begin(suffix), [](unsigned char c) { return std::toupper(c); });
+  if (!std::empty(suffix) && suffix.back() == 'B')
+    suffix.pop_back();
+
+  unsigned shift = 0;
+  if (suffix == "K")
+    shift = 10;
+  else if (suffix == "M")
+    shift = 20;
+  else if (suffix == "G")
+    shift = 30;
+  else if (suffix == "T")
+    shift = 40;
+  else if (!std::empty(suffix))
+    throw std::invalid_argument{fmt::format("\"{}\" is not a size", size)};
+
+  uint64_t value = 0;
+  try {
+    value = std::stoull(digits);
+  } catch (const std::out_of_range&) {
+    throw std::invalid_argument{fmt::format("\"{}\" is too large a size", size)};
+  }
+  if (value > (std::numeric_limits<uint64_t>::max() >> shift))
+    throw std::invalid_argument{fmt::format("\"{}\" is too large a size", size)};
+  return value << shift;
+}
+
+champsim::synthetic::parameters champsim::synthetic::parse(std::string_view spec)
+{
+  auto fields = split(spec);
+  if (std::size(fields) < 2 || fields.at(0) != "gen")
+    throw std::invalid_argument{fmt::format("\"{}\" is not of the form gen:KIND[:PARAMETER=VALUE]...", spec)};
+
+  parameters result;
+  if (fields.at(1) == "stream") {
+    result.kind = workload::stream;
+  } else if (fields.at(1) == "stride") {
+    result.kind = workload::stride;
+    result.stride = 4096;
+  } else if (fields.at(1) == "chase") {
+    result.kind = workload::chase;
+    result.stride = 64;
+  } else if (fields.at(1) == "random") {
+    result.kind = workload::random;
+    result.stride = 64;
+  } else if (fields.at(1) == "branch") {
+    result.kind = workload::branch;
+  } else {
+    throw std::invalid_argument{fmt::format("Unknown synthetic workload \"{}\"", fields.at(1))};
+  }
+
+  for (auto it = std::next(std::begin(fields), 2); it != std::end(fields); ++it) {
+    auto eq = it->find('=');
+    auto key = it->substr(0, eq);
+    auto value = (eq == std::string_view::npos) ? std::string_view{} : it->substr(eq + 1);
+    if (std::empty(value))
+      throw std::invalid_argument{fmt::format("Parameter \"{}\" of \"{}\" has no value", key, spec)};
+
+    if (key == "footprint")
+      result.footprint = parse_size(value);
+    else if (key == "stride")
+      result.stride = parse_size(value);
+    else if (key == "work")
+      result.work = parse_size(value);
+    else if (key == "seed")
+      result.seed = parse_size(value);
+    else if (key == "mispredict")
+      result.mispredict = parse_fraction(value);
+    else
+      throw std::invalid_argument{fmt::format("Unknown parameter \"{}\" of \"{}\"", key, spec)};
+  }
+
+  if (result.stride == 0)
+    throw std::invalid_argument{fmt::format("The stride of \"{}\" must be positive", spec)};
+  if (result.mispredict < 0 || result.mispredict > 1)
+    throw std::invalid_argument{fmt::format("The misprediction rate of \"{}\" must be between 0 and 1", spec)};
+  return result;
+}
+
+champsim::synthetic_trace::synthetic_trace(uint8_t cpu_idx, synthetic::parameters parameters)
+    : cpu(cpu_idx), params(parameters), rng(parameters.seed), num_lines(std::max<uint64_t>(parameters.footprint / parameters.stride, 1))
+{
+  // The chase visits a power of two of the strides, so that they can be scrambled
+  if (params.kind == synthetic::workload::chase)
+    num_lines = uint64_t{1} << (63 - __builtin_clzll(num_lines));
+}
+
+uint64_t champsim::synthetic_trace::next_address()
+{
+  switch (params.kind) {
+  case synthetic::workload::chase:
+    return data_base + params.stride * scramble(iteration % num_lines, static_cast<unsigned>(__builtin_ctzll(num_lines)), params.seed);
+  case synthetic::workload::random:
+    return data_base + params.stride * (rng() % num_lines);
+  default:
+    return data_base + params.stride * (iteration % num_lines);
+  }
+}
+
+ooo_model_instr champsim::synthetic_trace::operator()()
+{
+  bool is_branchy = (params.kind == synthetic::workload::branch);
+  bool is_chase = (params.kind == synthetic::workload::chase);
+
+  // The branch workload skips the instruction after its conditional branch when the branch is taken
+  auto body_length = params.work + (is_branchy ? 3 : 2);
+  auto next_pos = body_pos + 1;
+
+  input_instr instr{};
+  instr.ip = code_base + 4 * body_pos;
+  if (body_pos == body_length - 1) {
+    instr.is_branch = 1;
+    instr.branch_taken = 1;
+    instr.destination_registers[0] = champsim::REG_INSTRUCTION_POINTER;
+    instr.source_registers[0] = champsim::REG_INSTRUCTION_POINTER;
+    instr.source_registers[1] = champsim::REG_FLAGS;
+    next_pos = 0;
+  } else if (is_branchy && body_pos == params.work) {
+    bool taken = (static_cast<double>(rng() >> 11) * 0x1.0p-53) >= params.mispredict;
+    instr.is_branch = 1;
+    instr.branch_taken = taken;
+    instr.destination_registers[0] = champsim::REG_INSTRUCTION_POINTER;
+    instr.source_registers[0] = champsim::REG_INSTRUCTION_POINTER;
+    instr.source_registers[1] = champsim::REG_FLAGS;
+    next_pos = body_pos + (taken ? 2 : 1);
+  } else if (!is_branchy && body_pos == 0) {
+    instr.destination_registers[0] = reg_loaded;
+    instr.source_registers[0] = is_chase ? reg_loaded : reg_index;
+    instr.source_memory[0] = next_address();
+  } else {
+    auto reg = (is_chase || is_branchy) ? reg_work : reg_index;
+    instr.destination_registers[0] = reg;
+    instr.source_registers[0] = reg;
+  }
+
+  ooo_model_instr result{cpu, instr};
+  if (result.branch_taken)
+    result.branch_target = code_base + 4 * next_pos;
+
+  body_pos = next_pos;
+  if (body_pos == 0)
+    ++iteration;
+  return result;
+}
@@ -0,0 +1,130 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "trace_cache.h"
+
+#include <array>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fmt/core.h>
+
+namespace
+{
+// FNV-1a, which is stable between builds, unlike std::hash
+uint64_t fnv1a(const std::string& s)
+{
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (unsigned char c : s) {
+    hash ^= c;
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+
+// Holds an exclusive lock on a file until destroyed
+class file_lock
+{
+  int fd_;
+
+public:
+  explicit file_lock(const std::string& fname) : fd_(::open(fname.c_str(), O_RDWR | O_CREAT, 0666))
+  {
+    if (fd_ >= 0 && ::flock(fd_, LOCK_EX) != 0) {
+      ::close(fd_);
+      fd_ = -1;
+    }
+  }
+  file_lock(const file_lock&) = delete;
+  file_lock& operator=(const file_lock&) = delete;
+  ~file_lock()
+  {
+    if (fd_ >= 0)
+      ::close(fd_);
+  }
+
+  bool locked() const { return fd_ >= 0; }
+};
+
+bool exists(const std::string& fname)
+{
+  struct stat st;
+  return ::stat(fname.c_str(), &st) == 0;
+}
+} // namespace
+
+champsim::trace_cache::trace_cache(std::string directory) : directory_(std::move(directory)) {}
+
+std::optional<std::string> champsim::trace_cache::cached_name(const std::string& fname) const
+{
+  std::array<char, PATH_MAX> path;
+  struct stat st;
+  if (::realpath(fname.c_str(), std::data(path)) == nullptr || ::stat(std::data(path), &st) != 0)
+    return std::nullopt;
+
+  auto key = fmt::format("{}:{}.{}:{}", std::data(path), st.st_mtim.tv_sec, st.st_mtim.tv_nsec, st.st_size);
+  auto basename = fname.substr(fname.find_last_of('/') + 1);
+  return fmt::format("{}/{}-{:016x}", directory_, basename, fnv1a(key));
+}
+
+std::optional<std::string> champsim::trace_cache::get(const std::string& fname, const std::function<void(std::ostream&)>& decompress) const
+{
+  auto name = cached_name(fname);
+  if (!name.has_value())
+    return std::nullopt;
+
+  if (exists(*name))
+    return name;
+
+  // Only one process decompresses each trace. The others wait for it, then find the finished copy.
+  file_lock lock{*name + ".lock"};
+  if (!lock.locked())
+    return std::nullopt;
+
+  if (exists(*name))
+    return name;
+
+  // The copy is written under a temporary name, so that it appears complete or not at all
+  std::string temp_name = *name + ".XXXXXX";
+  auto fd = ::mkstemp(std::data(temp_name));
+  if (fd < 0)
+    return std::nullopt;
+  ::fchmod(fd, 0644);
+  ::close(fd);
+
+  std::ofstream temp_file{temp_name, std::ios::binary};
+  try {
+    decompress(temp_file);
+  } catch (...) {
+    std::remove(temp_name.c_str());
+    throw;
+  }
+  temp_file.close();
+
+  if (!temp_file || ::rename(temp_name.c_str(), name->c_str()) != 0) {
+    std::remove(temp_name.c_str());
+    return std::nullopt;
+  }
+
+  return name;
+}
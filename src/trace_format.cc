@@ -0,0 +1,105 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "trace_format.h"
+
+#include <algorithm>
+#include <fstream>
+#include <utility>
+
+#include <sys/stat.h>
+
+#include "indexed_trace.h"
+#include "inf_stream.h"
+
+namespace
+{
+std::vector<champsim::trace_format>& registered_formats()
+{
+  static std::vector<champsim::trace_format> formats;
+  return formats;
+}
+
+using namespace std::literals::string_literals;
+
+// Formats within this file are registered in the order they are defined, so the indexed format is tried before the xz format
+champsim::trace_format_registration indexed_format{champsim::stream_trace_format<champsim::indexed_trace_reader>(
+    "indexed", [](const std::string& fname, std::string_view) { return champsim::indexed_trace::has_footer(fname); })};
+champsim::trace_format_registration xz_format{
+    champsim::stream_trace_format<champsim::inf_istream<champsim::decomp_tags::lzma_tag_t<>>>("xz", "\xFD" "7zXZ\0"s)};
+champsim::trace_format_registration gzip_format{
+    champsim::stream_trace_format<champsim::inf_istream<champsim::decomp_tags::gzip_tag_t<>>>("gzip", "\x1F\x8B"s)};
+champsim::trace_format_registration bzip2_format{
+    champsim::stream_trace_format<champsim::inf_istream<champsim::decomp_tags::bzip2_tag_t>>("bzip2", "BZh"s)};
+champsim::trace_format_registration zstd_format{
+    champsim::stream_trace_format<champsim::inf_istream<champsim::decomp_tags::zstd_tag_t<>>>("zstd", "\x28\xB5\x2F\xFD"s)};
+
+// A trace that is not a regular file, such as a pipe, can be read only once, so it must not be opened to find its format
+bool is_stream_only(const std::string& fname)
+{
+  struct stat st;
+  return ::stat(fname.c_str(), &st) == 0 && !S_ISREG(st.st_mode) && !S_ISDIR(st.st_mode);
+}
+
+template <typename S>
+champsim::trace_format unprobed_stream_format(std::string name)
+{
+  return champsim::trace_format{std::move(name), [](const std::string&, std::string_view) { return true; },
+                                &champsim::trace_formats::make_unprobed_reader<S>};
+}
+
+const champsim::trace_format* registered_format_for(const std::string& fname)
+{
+  if (is_stream_only(fname))
+    return nullptr;
+
+  std::string header(16, '\0');
+  std::ifstream file{fname, std::ios::binary};
+  file.read(std::data(header), static_cast<std::streamsize>(std::size(header)));
+  header.resize(static_cast<std::size_t>(file.gcount()));
+
+  auto& formats = registered_formats();
+  auto found = std::find_if(std::cbegin(formats), std::cend(formats), [&](const auto& format) { return format.matches(fname, header); });
+  return (found == std::cend(formats)) ? nullptr : &*found;
+}
+} // namespace
+
+void champsim::register_trace_format(trace_format format) { registered_formats().push_back(std::move(format)); }
+
+bool champsim::is_registered_trace(const std::string& fname) { return registered_format_for(fname) != nullptr; }
+
+const champsim::trace_format& champsim::find_trace_format(const std::string& fname)
+{
+  static const trace_format uncompressed_format{
+      stream_trace_format<champsim::mapped_file>("uncompressed", [](const std::string&, std::string_view) { return true; })};
+  static const std::vector<std::pair<std::string, trace_format>> stream_formats{
+      {".xz", unprobed_stream_format<champsim::inf_istream<champsim::decomp_tags::lzma_tag_t<>>>("xz stream")},
+      {".gz", unprobed_stream_format<champsim::inf_istream<champsim::decomp_tags::gzip_tag_t<>>>("gzip stream")},
+      {".bz2", unprobed_stream_format<champsim::inf_istream<champsim::decomp_tags::bzip2_tag_t>>("bzip2 stream")},
+      {".zst", unprobed_stream_format<champsim::inf_istream<champsim::decomp_tags::zstd_tag_t<>>>("zstd stream")},
+      {"", unprobed_stream_format<std::ifstream>("uncompressed stream")}};
+
+  // A stream can be read only once, so its compression is known only from its name
+  if (is_stream_only(fname)) {
+    auto found = std::find_if(std::cbegin(stream_formats), std::cend(stream_formats), [&fname](const auto& entry) {
+      return std::size(fname) >= std::size(entry.first) && fname.compare(std::size(fname) - std::size(entry.first), std::string::npos, entry.first) == 0;
+    });
+    return found->second;
+  }
+
+  auto format = registered_format_for(fname);
+  return (format == nullptr) ? uncompressed_format : *format;
+}
@@ -40,3 +40,21 @@ TEST_CASE("An operable with a scale greater than 2 skips multiple cycles") {
 
   REQUIRE(uut.current_cycle == num_cycles/4);
 }
+
+TEST_CASE("An operable with a scale that is not a binary fraction does not drift") {
+  constexpr double scale = 4000.0 / 3000.0;
+  constexpr int num_cycles = 3000000;
+  mock_operable uut{scale};
+
+  for (int i = 0; i < num_cycles; ++i)
+    uut._operate();
+
+  REQUIRE(uut.current_cycle == (3*num_cycles)/4);
+}
+
+TEST_CASE("Clock scales are represented as exact fractions") {
+  REQUIRE(champsim::rational_approximation(1.0) == std::pair<uint64_t, uint64_t>{1, 1});
+  REQUIRE(champsim::rational_approximation(1.25) == std::pair<uint64_t, uint64_t>{5, 4});
+  REQUIRE(champsim::rational_approximation(4000.0 / 3000.0) == std::pair<uint64_t, uint64_t>{4, 3});
+  REQUIRE(champsim::rational_approximation(4000.0 / 2933.0) == std::pair<uint64_t, uint64_t>{4000, 2933});
+}
@@ -0,0 +1,38 @@
+#include <catch.hpp>
+#include "operable.h"
+
+namespace {
+struct mock_operable : champsim::operable {
+  using operable::operable;
+  long operate_count = 0;
+  long idle_count = 0;
+  long operate() final { ++operate_count; return 1; }
+  bool operate_idle() final { ++idle_count; return false; }
+};
+}
+
+TEST_CASE("Skipping a cycle advances the clock like operating it") {
+  auto scale = GENERATE(1.0, 1.25, 4.0);
+  constexpr int num_cycles = 100;
+  mock_operable operated{scale};
+  mock_operable skipped{scale};
+
+  for (int i = 0; i < num_cycles; ++i) {
+    operated._operate();
+    skipped._skip();
+  }
+
+  REQUIRE(skipped.current_cycle == operated.current_cycle);
+  REQUIRE(skipped.leap_operation == operated.leap_operation);
+  REQUIRE(skipped.operate_count == 0);
+  REQUIRE(skipped.idle_count == operated.operate_count);
+}
+
+TEST_CASE("An operable conservatively reports that it has work on the current cycle") {
+  mock_operable uut{1};
+
+  for (int i = 0; i < 10; ++i) {
+    REQUIRE(uut.next_event_cycle() == uut.current_cycle);
+    uut._operate();
+  }
+}
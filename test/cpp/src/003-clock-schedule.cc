@@ -0,0 +1,55 @@
+#include <catch.hpp>
+#include "clock_schedule.h"
+
+#include <string>
+#include <vector>
+
+namespace {
+struct logging_operable : champsim::operable {
+  std::string name;
+  std::vector<std::string>& log;
+  logging_operable(double scale, std::string n, std::vector<std::string>& l) : operable(scale), name(n), log(l) {}
+  long operate() final { log.push_back(name); return 1; }
+};
+}
+
+TEST_CASE("A clock schedule operates each clock domain at its own rate") {
+  std::vector<std::string> log;
+  logging_operable fast{1, "fast", log};
+  logging_operable slow{1.25, "slow", log};
+  std::vector<std::reference_wrapper<champsim::operable>> ops{{fast, slow}};
+  champsim::clock_schedule uut{std::begin(ops), std::end(ops)};
+
+  for (int i = 0; i < 100; ++i)
+    uut.operate();
+
+  REQUIRE(fast.current_cycle == 100);
+  REQUIRE(slow.current_cycle == 80);
+}
+
+TEST_CASE("A clock schedule operates members of a clock domain in the order they were added") {
+  std::vector<std::string> log;
+  logging_operable a{1, "a", log};
+  logging_operable b{1.25, "b", log};
+  logging_operable c{1, "c", log};
+  std::vector<std::reference_wrapper<champsim::operable>> ops{{a, b, c}};
+  champsim::clock_schedule uut{std::begin(ops), std::end(ops)};
+
+  uut.operate();
+
+  REQUIRE(log == std::vector<std::string>{"a", "c", "b"});
+}
+
+TEST_CASE("A clock schedule operates the domains that lag the least first") {
+  std::vector<std::string> log;
+  logging_operable slow{1.25, "slow", log};
+  logging_operable fast{1, "fast", log};
+  std::vector<std::reference_wrapper<champsim::operable>> ops{{slow, fast}};
+  champsim::clock_schedule uut{std::begin(ops), std::end(ops)};
+
+  for (int i = 0; i < 5; ++i)
+    uut.operate();
+
+  // The slow clock lags after its first cycle, and skips the fifth
+  REQUIRE(log == std::vector<std::string>{"slow", "fast", "fast", "slow", "fast", "slow", "fast", "slow", "fast"});
+}
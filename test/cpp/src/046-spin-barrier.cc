@@ -0,0 +1,42 @@
+#include <catch.hpp>
+
+#include "util/barrier.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+TEST_CASE("A spin barrier with a count of one does not wait") {
+  champsim::spin_barrier uut{1};
+  for (int i = 0; i < 10; ++i)
+    uut.arrive_and_wait();
+  SUCCEED();
+}
+
+TEST_CASE("A spin barrier separates the phases of its threads") {
+  constexpr std::size_t num_threads = 4;
+  constexpr int num_phases = 100;
+  champsim::spin_barrier uut{num_threads};
+
+  // Each thread writes its own slot in a phase, then reads every slot in the next
+  std::vector<int> slots(num_threads, 0);
+  std::vector<int> consistent(num_threads, 1);
+  auto work = [&](std::size_t id) {
+    for (int phase = 1; phase <= num_phases; ++phase) {
+      slots[id] = phase;
+      uut.arrive_and_wait();
+      for (auto slot : slots)
+        consistent[id] = consistent[id] && (slot == phase);
+      uut.arrive_and_wait();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < num_threads; ++i)
+    threads.emplace_back(work, i);
+  work(0);
+  for (auto& t : threads)
+    t.join();
+
+  REQUIRE(std::all_of(std::begin(consistent), std::end(consistent), [](int x) { return x != 0; }));
+}
@@ -0,0 +1,58 @@
+#include <catch.hpp>
+#include "util/inline_vector.h"
+
+#include <vector>
+
+TEST_CASE("An inline_vector is empty when constructed") {
+  champsim::inline_vector<int, 4> uut{};
+  REQUIRE(std::empty(uut));
+  REQUIRE(std::size(uut) == 0);
+  REQUIRE(uut.capacity() == 4);
+}
+
+TEST_CASE("An inline_vector holds elements up to its capacity") {
+  champsim::inline_vector<int, 4> uut{};
+  for (int i = 0; i < 4; ++i)
+    uut.push_back(i);
+
+  REQUIRE(std::size(uut) == 4);
+  REQUIRE_THAT(uut, Catch::Matchers::RangeEquals(std::vector{0, 1, 2, 3}));
+  REQUIRE(uut.back() == 3);
+}
+
+TEST_CASE("An inline_vector can erase a range of elements") {
+  std::vector<int> init{1, 2, 3, 4};
+  champsim::inline_vector<int, 4> uut{std::begin(init), std::end(init)};
+  auto it = uut.erase(std::next(std::begin(uut)), std::next(std::begin(uut), 3));
+
+  REQUIRE(*it == 4);
+  REQUIRE_THAT(uut, Catch::Matchers::RangeEquals(std::vector{1, 4}));
+}
+
+TEST_CASE("An inline_vector can be filled with a back_inserter") {
+  std::vector<int> init{0, 5, 0, 6};
+  champsim::inline_vector<int, 4> uut{};
+  std::remove_copy(std::begin(init), std::end(init), std::back_inserter(uut), 0);
+
+  REQUIRE_THAT(uut, Catch::Matchers::RangeEquals(std::vector{5, 6}));
+}
+
+TEST_CASE("A copied inline_vector is independent of the original") {
+  champsim::inline_vector<int, 4> uut{};
+  uut.push_back(1);
+  auto copy = uut;
+  copy.push_back(2);
+
+  REQUIRE(std::size(uut) == 1);
+  REQUIRE(std::size(copy) == 2);
+  REQUIRE(uut != copy);
+  copy.pop_back();
+  REQUIRE(uut == copy);
+}
+
+TEST_CASE("Clearing an inline_vector empties it") {
+  champsim::inline_vector<int, 4> uut{};
+  uut.push_back(1);
+  uut.clear();
+  REQUIRE(std::empty(uut));
+}
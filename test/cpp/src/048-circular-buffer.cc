@@ -0,0 +1,80 @@
+#include <catch.hpp>
+#include "util/circular_buffer.h"
+
+#include <vector>
+
+TEST_CASE("A circular_buffer is empty when constructed") {
+  champsim::circular_buffer<int> uut{4};
+  REQUIRE(std::empty(uut));
+  REQUIRE(std::size(uut) == 0);
+  REQUIRE(uut.capacity() == 4);
+}
+
+TEST_CASE("A circular_buffer is full at its capacity") {
+  champsim::circular_buffer<int> uut{4};
+  for (int i = 0; i < 4; ++i)
+    uut.push_back(i);
+
+  REQUIRE(uut.full());
+  REQUIRE_THAT(uut, Catch::Matchers::RangeEquals(std::vector{0, 1, 2, 3}));
+}
+
+TEST_CASE("A circular_buffer wraps around its capacity") {
+  champsim::circular_buffer<int> uut{4};
+  for (int i = 0; i < 10; ++i) {
+    uut.push_back(i);
+    if (std::size(uut) > 3)
+      uut.pop_front();
+  }
+
+  REQUIRE_THAT(uut, Catch::Matchers::RangeEquals(std::vector{7, 8, 9}));
+  REQUIRE(uut.front() == 7);
+  REQUIRE(uut.back() == 9);
+  REQUIRE(uut[1] == 8);
+}
+
+TEST_CASE("References to elements of a circular_buffer are stable") {
+  champsim::circular_buffer<int> uut{4};
+  uut.push_back(0);
+  uut.push_back(1);
+  int& ref = uut.back();
+  uut.pop_front();
+  uut.push_back(2);
+  uut.push_back(3);
+  uut.push_back(4);
+
+  REQUIRE(&ref == &uut.front());
+}
+
+TEST_CASE("A circular_buffer can erase from the front") {
+  champsim::circular_buffer<int> uut{4};
+  for (int i = 0; i < 4; ++i)
+    uut.push_back(i);
+
+  auto it = uut.erase(std::cbegin(uut), std::next(std::cbegin(uut), 2));
+  REQUIRE(it == std::begin(uut));
+  REQUIRE_THAT(uut, Catch::Matchers::RangeEquals(std::vector{2, 3}));
+}
+
+TEST_CASE("A circular_buffer can erase from the middle") {
+  champsim::circular_buffer<int> uut{4};
+  for (int i = 0; i < 4; ++i)
+    uut.push_back(i);
+
+  auto it = uut.erase(std::next(std::cbegin(uut)), std::next(std::cbegin(uut), 3));
+  REQUIRE(*it == 3);
+  REQUIRE_THAT(uut, Catch::Matchers::RangeEquals(std::vector{0, 3}));
+}
+
+TEST_CASE("A circular_buffer's iterators are random access") {
+  champsim::circular_buffer<int> uut{4};
+  uut.push_back(5);
+  uut.push_back(0);
+  for (int i = 1; i < 4; ++i) {
+    uut.pop_front();
+    uut.push_back(i);
+  }
+
+  REQUIRE(std::distance(std::begin(uut), std::end(uut)) == 2);
+  REQUIRE(std::partition_point(std::begin(uut), std::end(uut), [](int x){ return x < 3; }) == std::next(std::begin(uut)));
+}
@@ -0,0 +1,36 @@
+#include <catch.hpp>
+#include "util/slot_bitmap.h"
+
+TEST_CASE("A slot_bitmap starts with every slot free") {
+  champsim::slot_bitmap uut{70};
+  REQUIRE(uut.size() == 70);
+  REQUIRE(uut.num_free() == 70);
+  for (std::size_t i = 0; i < 70; ++i)
+    REQUIRE(uut.is_free(i));
+  REQUIRE(uut.find_free() == 0);
+}
+
+TEST_CASE("A slot_bitmap finds the lowest free slot") {
+  champsim::slot_bitmap uut{70};
+  for (std::size_t i = 0; i < 66; ++i)
+    uut.occupy(i);
+
+  REQUIRE(uut.num_free() == 4);
+  REQUIRE(uut.find_free() == 66);
+
+  uut.release(3);
+  REQUIRE(uut.num_free() == 5);
+  REQUIRE(uut.find_free() == 3);
+}
+
+TEST_CASE("A full slot_bitmap finds no free slot") {
+  champsim::slot_bitmap uut{70};
+  for (std::size_t i = 0; i < 70; ++i)
+    uut.occupy(uut.find_free());
+
+  REQUIRE(uut.num_free() == 0);
+  REQUIRE(uut.find_free() == uut.size());
+
+  uut.release(69);
+  REQUIRE(uut.find_free() == 69);
+}
@@ -0,0 +1,85 @@
+#include <catch.hpp>
+#include "util/mshr_queue.h"
+
+#include <vector>
+
+namespace
+{
+struct test_entry {
+  uint64_t address;
+  uint64_t event_cycle = 0;
+};
+
+std::vector<uint64_t> addresses_of(const champsim::mshr_queue<test_entry>& uut)
+{
+  std::vector<uint64_t> retval;
+  for (const auto& x : uut)
+    retval.push_back(x.address);
+  return retval;
+}
+} // namespace
+
+TEST_CASE("An mshr_queue finds entries by block address") {
+  champsim::mshr_queue<test_entry> uut{6};
+  uut.push_back({0x1000});
+  uut.push_back({0x2000});
+
+  REQUIRE(uut.find(0x1000) != std::end(uut));
+  CHECK(uut.find(0x1000)->address == 0x1000);
+  CHECK(uut.find(0x203f)->address == 0x2000);
+  CHECK(uut.find(0x2040) == std::end(uut));
+}
+
+TEST_CASE("An mshr_queue orders returned entries before unreturned entries") {
+  champsim::mshr_queue<test_entry> uut{6};
+  for (uint64_t addr : {0x1000, 0x2000, 0x3000, 0x4000})
+    uut.push_back({addr});
+  REQUIRE(uut.returned_end() == std::begin(uut));
+
+  uut.mark_returned(uut.find(0x3000));
+  REQUIRE_THAT(addresses_of(uut), Catch::Matchers::RangeEquals(std::vector<uint64_t>{0x3000, 0x1000, 0x2000, 0x4000}));
+  REQUIRE(std::distance(std::begin(uut), uut.returned_end()) == 1);
+
+  uut.mark_returned(uut.find(0x1000));
+  uut.mark_returned(uut.find(0x4000));
+  REQUIRE_THAT(addresses_of(uut), Catch::Matchers::RangeEquals(std::vector<uint64_t>{0x3000, 0x1000, 0x4000, 0x2000}));
+  REQUIRE(std::distance(std::begin(uut), uut.returned_end()) == 3);
+
+  // Returning an entry twice does not reorder it
+  uut.mark_returned(uut.find(0x3000));
+  REQUIRE_THAT(addresses_of(uut), Catch::Matchers::RangeEquals(std::vector<uint64_t>{0x3000, 0x1000, 0x4000, 0x2000}));
+}
+
+TEST_CASE("Erasing from an mshr_queue removes the entries from the index") {
+  champsim::mshr_queue<test_entry> uut{6};
+  for (uint64_t addr : {0x1000, 0x2000, 0x3000})
+    uut.push_back({addr});
+  uut.mark_returned(uut.find(0x1000));
+  uut.mark_returned(uut.find(0x2000));
+
+  uut.erase(std::cbegin(uut), uut.returned_end());
+  REQUIRE(std::size(uut) == 1);
+  CHECK(uut.find(0x1000) == std::end(uut));
+  CHECK(uut.find(0x2000) == std::end(uut));
+  CHECK(uut.returned_end() == std::begin(uut));
+
+  uut.mark_returned(uut.find(0x3000));
+  uut.erase(std::cbegin(uut));
+  CHECK(std::empty(uut));
+  CHECK(uut.returned_end() == std::end(uut));
+
+  uut.push_back({0x1000});
+  CHECK(uut.returned_end() == std::begin(uut));
+}
+
+TEST_CASE("A moved mshr_queue keeps its order and index") {
+  champsim::mshr_queue<test_entry> orig{6};
+  for (uint64_t addr : {0x1000, 0x2000})
+    orig.push_back({addr});
+  orig.mark_returned(orig.find(0x2000));
+
+  auto uut{std::move(orig)};
+  REQUIRE_THAT(addresses_of(uut), Catch::Matchers::RangeEquals(std::vector<uint64_t>{0x2000, 0x1000}));
+  CHECK(std::distance(std::begin(uut), uut.returned_end()) == 1);
+  CHECK(uut.find(0x1000)->address == 0x1000);
+}
@@ -0,0 +1,27 @@
+#include <catch.hpp>
+#include "util/find_tag.h"
+
+#include <numeric>
+#include <vector>
+
+TEST_CASE("find_tag finds the first matching tag at every position") {
+  auto num_tags = GENERATE(as<std::size_t>{}, 1, 2, 3, 4, 5, 7, 8, 16, 17);
+  std::vector<uint64_t> tags(num_tags);
+  std::iota(std::begin(tags), std::end(tags), 0xdead0000);
+
+  for (std::size_t i = 0; i < num_tags; ++i) {
+    auto found = champsim::find_tag(std::data(tags), std::data(tags) + num_tags, tags[i]);
+    REQUIRE(found == std::data(tags) + i);
+  }
+}
+
+TEST_CASE("find_tag returns the end of the array if no tag matches") {
+  std::vector<uint64_t> tags(16, 0x1234);
+  REQUIRE(champsim::find_tag(std::data(tags), std::data(tags) + std::size(tags), 0x4321) == std::data(tags) + std::size(tags));
+  REQUIRE(champsim::find_tag(std::data(tags), std::data(tags), 0x1234) == std::data(tags));
+}
+
+TEST_CASE("find_tag returns the first of duplicate tags") {
+  std::vector<uint64_t> tags{1, 2, 3, 4, 5, 6, 5, 6};
+  REQUIRE(champsim::find_tag(std::data(tags), std::data(tags) + std::size(tags), 6) == std::data(tags) + 5);
+}
@@ -0,0 +1,56 @@
+#include <catch.hpp>
+#include "util/spsc_queue.h"
+
+#include <numeric>
+#include <thread>
+#include <vector>
+
+TEST_CASE("An spsc_queue pops elements in the order they were pushed") {
+  champsim::spsc_queue<int> uut{8};
+  std::vector<int> input{1, 2, 3, 4, 5};
+  REQUIRE(uut.push(std::begin(input), std::end(input)) == std::end(input));
+  REQUIRE(std::size(uut) == 5);
+
+  std::vector<int> output;
+  uut.pop(std::back_inserter(output), 3);
+  REQUIRE_THAT(output, Catch::Matchers::RangeEquals(std::vector{1, 2, 3}));
+  uut.pop(std::back_inserter(output), 10);
+  REQUIRE_THAT(output, Catch::Matchers::RangeEquals(input));
+  REQUIRE(std::empty(uut));
+}
+
+TEST_CASE("An spsc_queue pushes only as many elements as will fit") {
+  champsim::spsc_queue<int> uut{4};
+  std::vector<int> input{1, 2, 3, 4, 5, 6};
+  auto rest = uut.push(std::begin(input), std::end(input));
+  REQUIRE(rest == std::next(std::begin(input), 4));
+
+  std::vector<int> output;
+  uut.pop(std::back_inserter(output), 2);
+  REQUIRE(uut.push(rest, std::end(input)) == std::end(input));
+  uut.pop(std::back_inserter(output), 10);
+  REQUIRE_THAT(output, Catch::Matchers::RangeEquals(input));
+}
+
+TEST_CASE("An spsc_queue passes elements between threads in order") {
+  constexpr int count = 100000;
+  champsim::spsc_queue<int> uut{64};
+
+  std::thread producer{[&uut]() {
+    std::vector<int> batch(16);
+    for (int base = 0; base < count; base += static_cast<int>(std::size(batch))) {
+      std::iota(std::begin(batch), std::end(batch), base);
+      for (auto it = std::begin(batch); it != std::end(batch);)
+        it = uut.push(it, std::end(batch));
+    }
+  }};
+
+  std::vector<int> output;
+  while (std::size(output) < count)
+    uut.pop(std::back_inserter(output), 10);
+  producer.join();
+
+  std::vector<int> expected(count);
+  std::iota(std::begin(expected), std::end(expected), 0);
+  REQUIRE_THAT(output, Catch::Matchers::RangeEquals(expected));
+}
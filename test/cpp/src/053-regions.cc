@@ -0,0 +1,97 @@
+#include <catch.hpp>
+#include "region.h"
+
+#include <sstream>
+#include <stdexcept>
+
+TEST_CASE("A list of regions can be read") {
+  std::istringstream input{"# start warmup length weight\n1000 100 500 0.25\n\n  4000 200 500 0.75  \n"};
+  auto regions = champsim::read_regions(input);
+
+  REQUIRE(std::size(regions) == 2);
+  CHECK(regions.at(0).start == 1000);
+  CHECK(regions.at(0).warmup == 100);
+  CHECK(regions.at(0).length == 500);
+  CHECK(regions.at(0).weight == 0.25);
+  CHECK(regions.at(1).start == 4000);
+  CHECK(regions.at(1).weight == 0.75);
+}
+
+TEST_CASE("A malformed region is rejected") {
+  std::istringstream missing{"1000 100 500\n"};
+  REQUIRE_THROWS_AS(champsim::read_regions(missing), std::invalid_argument);
+
+  std::istringstream extra{"1000 100 500 0.5 7\n"};
+  REQUIRE_THROWS_AS(champsim::read_regions(extra), std::invalid_argument);
+}
+
+TEST_CASE("A region whose warmup begins before the trace is rejected") {
+  std::istringstream input{"100 1000 500 1\n"};
+  REQUIRE_THROWS_AS(champsim::read_regions(input), std::invalid_argument);
+}
+
+TEST_CASE("Region statistics are combined in proportion to their weights") {
+  champsim::phase_stats first, second;
+
+  O3_CPU::stats_type cpu_first;
+  cpu_first.name = "CPU 0";
+  cpu_first.begin_instrs = 100;
+  cpu_first.end_instrs = 1100;
+  cpu_first.begin_cycles = 50;
+  cpu_first.end_cycles = 2050;
+  cpu_first.total_branch_types.at(1) = 40;
+  first.roi_cpu_stats.push_back(cpu_first);
+  first.sim_cpu_stats.push_back(cpu_first);
+
+  O3_CPU::stats_type cpu_second;
+  cpu_second.name = "CPU 0";
+  cpu_second.end_instrs = 1000;
+  cpu_second.end_cycles = 500;
+  cpu_second.total_branch_types.at(1) = 80;
+  second.roi_cpu_stats.push_back(cpu_second);
+  second.sim_cpu_stats.push_back(cpu_second);
+
+  CACHE::stats_type cache_first;
+  cache_first.name = "LLC";
+  cache_first.misses.at(0).at(0) = 12;
+  cache_first.total_miss_latency = 1200;
+  first.roi_cache_stats.push_back(cache_first);
+  first.sim_cache_stats.push_back(cache_first);
+
+  CACHE::stats_type cache_second;
+  cache_second.name = "LLC";
+  cache_second.misses.at(0).at(0) = 28;
+  cache_second.total_miss_latency = 640;
+  second.roi_cache_stats.push_back(cache_second);
+  second.sim_cache_stats.push_back(cache_second);
+
+  DRAM_CHANNEL::stats_type dram_first, dram_second;
+  dram_first.RQ_ROW_BUFFER_HIT = 8;
+  dram_second.RQ_ROW_BUFFER_HIT = 4;
+  dram_first.REFRESHES = 12;
+  dram_second.REFRESHES = 4;
+  dram_first.POWER_DOWN_CYCLES = 400;
+  dram_second.POWER_DOWN_CYCLES = 0;
+  first.roi_dram_stats.push_back(dram_first);
+  second.roi_dram_stats.push_back(dram_second);
+
+  auto result = champsim::weighted_sum({first, second}, {0.25, 0.75});
+
+  REQUIRE(std::size(result.roi_cpu_stats) == 1);
+  CHECK(result.roi_cpu_stats.at(0).name == "CPU 0");
+  CHECK(result.roi_cpu_stats.at(0).instrs() == 1000);
+  CHECK(result.roi_cpu_stats.at(0).cycles() == 875);
+  CHECK(result.roi_cpu_stats.at(0).total_branch_types.at(1) == 70);
+
+  REQUIRE(std::size(result.roi_cache_stats) == 1);
+  CHECK(result.roi_cache_stats.at(0).name == "LLC");
+  CHECK(result.roi_cache_stats.at(0).misses.at(0).at(0) == 24);
+  CHECK(result.roi_cache_stats.at(0).total_miss_latency == 780);
+  CHECK(result.roi_cache_stats.at(0).avg_miss_latency == 32.5);
+
+  REQUIRE(std::size(result.roi_dram_stats) == 1);
+  CHECK(result.roi_dram_stats.at(0).RQ_ROW_BUFFER_HIT == 5);
+  CHECK(result.roi_dram_stats.at(0).REFRESHES == 6);
+  CHECK(result.roi_dram_stats.at(0).POWER_DOWN_CYCLES == 100);
+  CHECK(std::empty(result.sim_dram_stats));
+}
@@ -61,3 +61,17 @@ TEST_CASE("A tracereader can read the byte representation of an input_instr") {
   REQUIRE_THAT(inst1.destination_memory, Catch::Matchers::IsEmpty());
   REQUIRE_THAT(inst1.source_memory, Catch::Matchers::IsEmpty());
 }
+
+TEST_CASE("A tracereader can read a range of input_instr at once") {
+  champsim::bulk_tracereader<input_instr, std::istringstream> uut{0, std::istringstream{trace}};
+  std::vector<ooo_model_instr> buffer(3, ooo_model_instr{0, input_instr{}});
+  auto end = uut(std::data(buffer), std::data(buffer) + std::size(buffer));
+
+  // The last instruction in the file is held back until its successor is known
+  REQUIRE(end == std::data(buffer) + 2);
+  REQUIRE(buffer.at(0).ip == 0x4c00133a);
+  REQUIRE_THAT(buffer.at(0).destination_registers, Catch::Matchers::RangeEquals(std::vector{59}));
+  REQUIRE(buffer.at(1).ip == 0x4c00163a);
+  REQUIRE_THAT(buffer.at(1).destination_registers, Catch::Matchers::RangeEquals(std::vector{73}));
+  REQUIRE(uut.eof());
+}
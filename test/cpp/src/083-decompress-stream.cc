@@ -2,6 +2,10 @@
 
 #include "inf_stream.h"
 
+#include <sstream>
+#include <utility>
+#include <vector>
+
 const std::string plaintext{
 "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua. Ut enim ad minim veniam, quis nostrud exercitation ullamco laboris nisi ut aliquip ex ea commodo consequat. Duis aute irure dolor in reprehenderit in voluptate velit esse cillum dolore eu fugiat nulla pariatur. Excepteur sint occaecat cupidatat non proident, sunt in culpa qui officia deserunt mollit anim id est laborum."
 };
@@ -78,6 +82,27 @@ const std::string bz2_cyphertext{{
   '\x56', '\x80'
 }};
 
+const std::string zstd_cyphertext{{
+  '\x28', '\xb5', '\x2f', '\xfd', '\x64', '\xbd', '\x00', '\x75', '\x08', '\x00', '\x66', '\x57', '\x39', '\x17', '\x90', '\xa9',
+  '\x39', '\x00', '\x89', '\xec', '\x46', '\x4d', '\x64', '\xe3', '\xd8', '\xc7', '\x24', '\x01', '\x73', '\x4e', '\x96', '\x1e',
+  '\xb6', '\xba', '\xf3', '\x5f', '\x39', '\x31', '\x00', '\x32', '\x00', '\x33', '\x00', '\xa6', '\x98', '\x45', '\xcb', '\xf2',
+  '\x72', '\x62', '\x2f', '\xba', '\xe3', '\x18', '\x5b', '\xee', '\xa4', '\xbc', '\x7b', '\xa5', '\xc5', '\xa9', '\x06', '\xde',
+  '\xb8', '\x07', '\x3b', '\x49', '\x3f', '\x5e', '\xaa', '\x28', '\xd1', '\x48', '\x9c', '\xec', '\x48', '\x0d', '\xf4', '\xa9',
+  '\xe2', '\x53', '\xd1', '\x99', '\x2b', '\x3d', '\x99', '\x8e', '\xf7', '\x18', '\xdd', '\x20', '\x5d', '\xb8', '\xc7', '\x31',
+  '\xfb', '\x74', '\x6b', '\xfa', '\x91', '\x53', '\xc6', '\x64', '\xed', '\x8e', '\x85', '\x27', '\xc8', '\x0b', '\xb7', '\x24',
+  '\xc2', '\x74', '\xd6', '\xf4', '\x4c', '\xd4', '\x38', '\x75', '\xb3', '\xe2', '\xa7', '\xa5', '\x7a', '\x6e', '\x2e', '\x12',
+  '\x0a', '\xa8', '\x4c', '\xdc', '\x54', '\xcb', '\x0e', '\x75', '\x6a', '\x74', '\x8d', '\xae', '\x50', '\x01', '\x0b', '\x41',
+  '\x01', '\x28', '\xb1', '\x8e', '\xea', '\xa8', '\x15', '\xeb', '\x87', '\x34', '\x34', '\x5d', '\x1b', '\x73', '\x52', '\xa7',
+  '\xe4', '\x2a', '\x6a', '\x2c', '\x3c', '\xd2', '\x9c', '\xa2', '\xf6', '\xe2', '\x91', '\x8b', '\x19', '\x61', '\x74', '\x18',
+  '\xd5', '\x6e', '\x94', '\xe8', '\x35', '\x66', '\x05', '\x0a', '\xc0', '\xca', '\xc4', '\x95', '\x3b', '\xe7', '\x48', '\xcb',
+  '\x01', '\x80', '\x93', '\xc9', '\x2d', '\xef', '\xb9', '\x95', '\xb9', '\x53', '\xb4', '\x44', '\x4e', '\x2e', '\xad', '\x93',
+  '\x1b', '\x0c', '\xd7', '\x67', '\xa2', '\x75', '\x98', '\x24', '\x96', '\xa9', '\x06', '\x9a', '\xcb', '\x0f', '\x1d', '\xb5',
+  '\xb3', '\x62', '\x61', '\x95', '\x1f', '\x49', '\x8a', '\x45', '\x5c', '\x84', '\x5c', '\xd1', '\x9e', '\x8a', '\xd2', '\x78',
+  '\x98', '\x04', '\x0d', '\x08', '\x10', '\x70', '\xb4', '\x3c', '\x5b', '\x0b', '\xa9', '\x30', '\x3b', '\xc7', '\x23', '\x88',
+  '\x62', '\xf9', '\x25', '\x0b', '\xdd', '\xb6', '\x76', '\x6f', '\x03', '\x39', '\x0d', '\xe2', '\x5f', '\x56', '\x8c', '\xd2',
+  '\x85', '\x25', '\x16', '\xd9', '\xf4', '\x62', '\x88', '\x02', '\x30', '\x56', '\x76', '\x43'
+}};
+
 TEST_CASE("An inf_stream can inflate a gzip-compressed text") {
   // Initialize a inflation/deflation buffer
   champsim::inf_istream<champsim::decomp_tags::gzip_tag_t<>, std::istringstream> comp_stream{std::istringstream{gzip_cyphertext}};
@@ -116,3 +141,176 @@ TEST_CASE("An inf_stream can inflate a bz2-compressed text") {
   comp_stream.read(inflated, static_cast<std::streamsize>(std::size(plaintext)));
   REQUIRE_THAT(std::string{inflated}, Catch::Matchers::Equals(plaintext));
 }
+
+TEST_CASE("An inf_stream can inflate a zstd-compressed text") {
+  // Initialize a inflation/deflation buffer
+  champsim::inf_istream<champsim::decomp_tags::zstd_tag_t<>, std::istringstream> comp_stream{std::istringstream{zstd_cyphertext}};
+
+  STATIC_REQUIRE(std::is_move_constructible<decltype(comp_stream)>::value);
+  STATIC_REQUIRE(std::is_move_assignable<decltype(comp_stream)>::value);
+  STATIC_REQUIRE(std::is_swappable<decltype(comp_stream)>::value);
+
+  char inflated[1000] = {};
+  comp_stream.read(inflated, static_cast<std::streamsize>(std::size(plaintext)));
+  REQUIRE_THAT(std::string{inflated}, Catch::Matchers::Equals(plaintext));
+}
+
+namespace
+{
+template <typename Tag>
+std::string deflate_all(const std::string& text)
+{
+  auto strm = Tag::new_deflate_state();
+  std::vector<typename Tag::in_char_type> in_buf(std::begin(text), std::end(text));
+  std::vector<typename Tag::out_char_type> out_buf(1 << 12);
+  std::string result;
+
+  strm->next_in = std::data(in_buf);
+  strm->avail_in = std::size(in_buf);
+  auto status = Tag::status_type::CAN_CONTINUE;
+  while (status == Tag::status_type::CAN_CONTINUE) {
+    strm->next_out = std::data(out_buf);
+    strm->avail_out = std::size(out_buf);
+    status = Tag::deflate(strm, true);
+    result.append(std::begin(out_buf), std::next(std::begin(out_buf), static_cast<long>(std::size(out_buf) - strm->avail_out)));
+  }
+  REQUIRE(status == Tag::status_type::END);
+  return result;
+}
+}
+
+TEST_CASE("A zstd-compressed text survives a round trip") {
+  auto compressed = deflate_all<champsim::decomp_tags::zstd_tag_t<>>(plaintext);
+  REQUIRE(std::size(compressed) < std::size(plaintext));
+
+  champsim::inf_istream<champsim::decomp_tags::zstd_tag_t<>, std::istringstream> comp_stream{std::istringstream{compressed}};
+  std::string inflated(std::size(plaintext), '\0');
+  comp_stream.read(std::data(inflated), static_cast<std::streamsize>(std::size(inflated)));
+  REQUIRE(comp_stream.gcount() == static_cast<std::streamsize>(std::size(plaintext)));
+  REQUIRE_THAT(inflated, Catch::Matchers::Equals(plaintext));
+}
+
+TEST_CASE("A zstd-compressed stream larger than the inflation buffer is read to its end") {
+  std::string text;
+  for (int i = 0; text.size() < (1u << 20); ++i)
+    text += plaintext.substr(static_cast<std::size_t>(i) % 64);
+  auto compressed = deflate_all<champsim::decomp_tags::zstd_tag_t<>>(text);
+
+  champsim::inf_istream<champsim::decomp_tags::zstd_tag_t<>, std::istringstream> comp_stream{std::istringstream{compressed}};
+  std::string inflated(std::size(text) + 1, '\0');
+  comp_stream.read(std::data(inflated), static_cast<std::streamsize>(std::size(inflated)));
+  REQUIRE(comp_stream.eof());
+  REQUIRE(comp_stream.gcount() == static_cast<std::streamsize>(std::size(text)));
+  inflated.resize(std::size(text));
+  REQUIRE(inflated == text);
+}
+
+TEST_CASE("An xz stream with multiple blocks can be inflated with several threads") {
+  std::string text;
+  for (int i = 0; text.size() < (1u << 20); ++i)
+    text += plaintext.substr(static_cast<std::size_t>(i) % 64);
+
+  // Compress in small blocks, as xz -T0 would
+  lzma_stream enc = LZMA_STREAM_INIT;
+  lzma_mt options{};
+  options.threads = 4;
+  options.block_size = 1 << 16;
+  options.preset = LZMA_PRESET_DEFAULT;
+  options.check = LZMA_CHECK_CRC64;
+  REQUIRE(::lzma_stream_encoder_mt(&enc, &options) == LZMA_OK);
+
+  std::vector<uint8_t> in_buf(std::begin(text), std::end(text));
+  std::vector<uint8_t> out_buf(std::size(text) + (1 << 16));
+  enc.next_in = std::data(in_buf);
+  enc.avail_in = std::size(in_buf);
+  enc.next_out = std::data(out_buf);
+  enc.avail_out = std::size(out_buf);
+  REQUIRE(::lzma_code(&enc, LZMA_FINISH) == LZMA_STREAM_END);
+  std::string compressed(std::begin(out_buf), std::next(std::begin(out_buf), static_cast<long>(enc.total_out)));
+  ::lzma_end(&enc);
+
+  auto old_threads = std::exchange(champsim::decomp_tags::lzma_threads, 4);
+  champsim::inf_istream<champsim::decomp_tags::lzma_tag_t<>, std::istringstream> comp_stream{std::istringstream{compressed}};
+  champsim::decomp_tags::lzma_threads = old_threads;
+
+  std::string inflated(std::size(text) + 1, '\0');
+  comp_stream.read(std::data(inflated), static_cast<std::streamsize>(std::size(inflated)));
+  REQUIRE(comp_stream.gcount() == static_cast<std::streamsize>(std::size(text)));
+  inflated.resize(std::size(text));
+  REQUIRE(inflated == text);
+}
+
+TEMPLATE_TEST_CASE("A def_ostream compresses a text that an inf_istream inflates", "", champsim::decomp_tags::gzip_tag_t<>,
+                   champsim::decomp_tags::lzma_tag_t<>, champsim::decomp_tags::bzip2_tag_t, champsim::decomp_tags::zstd_tag_t<>) {
+  std::string text;
+  for (int i = 0; text.size() < (1u << 18); ++i)
+    text += plaintext.substr(static_cast<std::size_t>(i) % 64);
+
+  champsim::def_ostream<TestType, std::ostringstream> def_stream{std::ostringstream{}};
+  def_stream.write(std::data(text), static_cast<std::streamsize>(std::size(text)));
+  def_stream.finish();
+  REQUIRE(def_stream.good());
+  auto compressed = def_stream.get_underlying().str();
+  REQUIRE(std::size(compressed) < std::size(text));
+
+  champsim::inf_istream<TestType, std::istringstream> comp_stream{std::istringstream{compressed}};
+  std::string inflated(std::size(text) + 1, '\0');
+  comp_stream.read(std::data(inflated), static_cast<std::streamsize>(std::size(inflated)));
+  REQUIRE(comp_stream.gcount() == static_cast<std::streamsize>(std::size(text)));
+  inflated.resize(std::size(text));
+  REQUIRE(inflated == text);
+}
+
+TEST_CASE("A def_ostream compresses an xz stream with several threads") {
+  std::string text;
+  for (int i = 0; text.size() < (1u << 18); ++i)
+    text += plaintext.substr(static_cast<std::size_t>(i) % 64);
+
+  auto old_threads = std::exchange(champsim::decomp_tags::lzma_threads, 4);
+  champsim::def_ostream<champsim::decomp_tags::lzma_tag_t<>, std::ostringstream> def_stream{std::ostringstream{}};
+  champsim::decomp_tags::lzma_threads = old_threads;
+  def_stream << text;
+  def_stream.finish();
+  auto compressed = def_stream.get_underlying().str();
+
+  champsim::inf_istream<champsim::decomp_tags::lzma_tag_t<>, std::istringstream> comp_stream{std::istringstream{compressed}};
+  std::string inflated(std::size(text), '\0');
+  comp_stream.read(std::data(inflated), static_cast<std::streamsize>(std::size(inflated)));
+  REQUIRE(inflated == text);
+}
+
+TEMPLATE_TEST_CASE("An inf_istream finds the size of the data that the file records", "", champsim::decomp_tags::gzip_tag_t<>,
+                   champsim::decomp_tags::lzma_tag_t<>) {
+  std::string text;
+  for (int i = 0; text.size() < (1u << 18); ++i)
+    text += plaintext.substr(static_cast<std::size_t>(i) % 64);
+
+  champsim::def_ostream<TestType, std::ostringstream> def_stream{std::ostringstream{}};
+  def_stream << text;
+  def_stream.finish();
+
+  champsim::inf_istream<TestType, std::istringstream> comp_stream{std::istringstream{def_stream.get_underlying().str()}};
+  REQUIRE(comp_stream.size_hint() == std::size(text));
+
+  // Finding the size does not disturb the inflation
+  std::string inflated(std::size(text), '\0');
+  comp_stream.read(std::data(inflated), static_cast<std::streamsize>(std::size(inflated)));
+  REQUIRE(inflated == text);
+}
+
+TEST_CASE("An inf_istream finds the size of the data in a zstd frame") {
+  std::string compressed(::ZSTD_compressBound(std::size(plaintext)), '\0');
+  compressed.resize(::ZSTD_compress(std::data(compressed), std::size(compressed), std::data(plaintext), std::size(plaintext), ZSTD_CLEVEL_DEFAULT));
+
+  champsim::inf_istream<champsim::decomp_tags::zstd_tag_t<>, std::istringstream> comp_stream{std::istringstream{compressed}};
+  REQUIRE(comp_stream.size_hint() == std::size(plaintext));
+
+  std::string inflated(std::size(plaintext), '\0');
+  comp_stream.read(std::data(inflated), static_cast<std::streamsize>(std::size(inflated)));
+  REQUIRE(inflated == plaintext);
+}
+
+TEST_CASE("An inf_istream does not know the size of the data in a bzip2 file") {
+  champsim::inf_istream<champsim::decomp_tags::bzip2_tag_t, std::istringstream> comp_stream{std::istringstream{bz2_cyphertext}};
+  REQUIRE_FALSE(comp_stream.size_hint().has_value());
+}
@@ -55,3 +55,73 @@ TEST_CASE("A repeatable's generator takes the type of the underlying generator")
       >
     >);
 }
+
+namespace {
+  struct mock_bulk_repeatable {
+    int remaining = 3;
+
+    bool eof() const { return remaining == 0; }
+
+    ooo_model_instr operator()() { --remaining; return ooo_model_instr{0, input_instr{}}; }
+
+    ooo_model_instr* operator()(ooo_model_instr* first, ooo_model_instr* last) {
+      for (; first != last && !eof(); ++first)
+        *first = (*this)();
+      return first;
+    }
+  };
+}
+
+TEST_CASE("A repeatable fills a whole range by repeating") {
+  champsim::repeatable<mock_bulk_repeatable> uut{};
+  std::vector<ooo_model_instr> buffer(10, ooo_model_instr{0, input_instr{}});
+  auto end = uut(std::data(buffer), std::data(buffer) + std::size(buffer));
+
+  REQUIRE(end == std::data(buffer) + std::size(buffer));
+}
+
+namespace {
+  struct mock_empty_bulk_repeatable {
+    bool eof() const { return true; }
+    ooo_model_instr operator()() { return ooo_model_instr{0, input_instr{}}; }
+    ooo_model_instr* operator()(ooo_model_instr* first, ooo_model_instr*) { return first; }
+  };
+}
+
+TEST_CASE("A repeatable of an empty trace stops with an error") {
+  champsim::repeatable<mock_empty_bulk_repeatable> uut{};
+  std::vector<ooo_model_instr> buffer(10, ooo_model_instr{0, input_instr{}});
+  REQUIRE_THROWS_AS(uut(std::data(buffer), std::data(buffer) + std::size(buffer)), std::runtime_error);
+}
+
+namespace {
+  struct mock_rewindable {
+    inline static int constructor_calls = 0;
+    int rewind_calls = 0;
+    bool can_rewind;
+
+    bool eof() const { return true; }
+    ooo_model_instr operator()() { return ooo_model_instr{0, input_instr{}}; }
+    bool rewind() { ++rewind_calls; return can_rewind; }
+
+    explicit mock_rewindable(bool r) : can_rewind(r) { constructor_calls++; }
+  };
+}
+
+TEST_CASE("A repeatable rewinds rather than reopening when it can") {
+  champsim::repeatable<mock_rewindable, bool> uut{true};
+
+  auto old_calls = mock_rewindable::constructor_calls;
+  (void)uut();
+  (void)uut();
+  REQUIRE(mock_rewindable::constructor_calls == old_calls);
+  REQUIRE(uut.intern_.rewind_calls == 2);
+}
+
+TEST_CASE("A repeatable reopens when it cannot rewind") {
+  champsim::repeatable<mock_rewindable, bool> uut{false};
+
+  auto old_calls = mock_rewindable::constructor_calls;
+  (void)uut();
+  REQUIRE(mock_rewindable::constructor_calls > old_calls);
+}
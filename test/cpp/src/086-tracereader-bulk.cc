@@ -0,0 +1,120 @@
+#include <catch.hpp>
+
+#include "tracereader.h"
+
+#include <algorithm>
+#include <optional>
+#include <sstream>
+#include <utility>
+
+namespace {
+  struct counting_generator {
+    uint64_t count = 0;
+    uint64_t length;
+
+    bool eof() const { return count >= length; }
+
+    ooo_model_instr operator()() {
+      ooo_model_instr retval{0, input_instr{}};
+      retval.ip = count++;
+      return retval;
+    }
+  };
+}
+
+TEST_CASE("A tracereader fills a range from a generator without a bulk read") {
+  champsim::tracereader uut{counting_generator{0, 100}};
+  std::vector<ooo_model_instr> buffer(10, ooo_model_instr{0, input_instr{}});
+  auto end = uut(std::data(buffer), std::data(buffer) + std::size(buffer));
+
+  REQUIRE(end == std::data(buffer) + std::size(buffer));
+  for (std::size_t i = 0; i < std::size(buffer); ++i)
+    REQUIRE(buffer.at(i).ip == i);
+}
+
+TEST_CASE("A tracereader stops filling a range when the trace ends") {
+  champsim::tracereader uut{counting_generator{0, 4}};
+  std::vector<ooo_model_instr> buffer(10, ooo_model_instr{0, input_instr{}});
+  auto end = uut(std::data(buffer), std::data(buffer) + std::size(buffer));
+
+  REQUIRE(end == std::data(buffer) + 4);
+  REQUIRE(uut.eof());
+}
+
+TEST_CASE("A tracereader assigns increasing instruction IDs to a filled range") {
+  champsim::tracereader uut{counting_generator{0, 100}};
+  std::vector<ooo_model_instr> buffer(10, ooo_model_instr{0, input_instr{}});
+  auto first_id = uut().instr_id;
+  auto end = uut(std::data(buffer), std::data(buffer) + std::size(buffer));
+
+  for (auto it = std::data(buffer); it != end; ++it)
+    REQUIRE(it->instr_id == ++first_id);
+}
+
+namespace {
+  std::string make_trace(std::size_t length)
+  {
+    std::string bytes;
+    for (std::size_t i = 0; i < length; ++i) {
+      input_instr instr{};
+      instr.ip = 0x1000 + 4 * i;
+      bytes.append(reinterpret_cast<const char*>(&instr), sizeof(instr));
+    }
+    return bytes;
+  }
+
+  template <typename R>
+  std::vector<uint64_t> read_ips(R& reader)
+  {
+    std::vector<ooo_model_instr> buffer(1000, ooo_model_instr{0, input_instr{}});
+    auto end = reader(std::data(buffer), std::data(buffer) + std::size(buffer));
+    std::vector<uint64_t> ips;
+    std::transform(std::data(buffer), end, std::back_inserter(ips), [](const auto& instr) { return instr.ip; });
+    return ips;
+  }
+}
+
+TEST_CASE("A bulk_tracereader that cannot seek rewinds from memory") {
+  champsim::bulk_tracereader<input_instr, std::istringstream> uut{0, std::istringstream{make_trace(300)}};
+
+  REQUIRE_FALSE(uut.rewind());
+  // The last instruction only provides the branch target of the one before it
+  auto first_pass = read_ips(uut);
+  REQUIRE(std::size(first_pass) == 299);
+  REQUIRE(uut.eof());
+
+  REQUIRE(uut.rewind());
+  REQUIRE_FALSE(uut.eof());
+  REQUIRE(read_ips(uut) == first_pass);
+  REQUIRE(uut.rewind());
+  REQUIRE(read_ips(uut) == first_pass);
+}
+
+TEST_CASE("A bulk_tracereader does not keep a trace that is too large") {
+  auto old_limit = std::exchange(champsim::max_buffered_trace_bytes, 100 * sizeof(input_instr));
+  champsim::bulk_tracereader<input_instr, std::istringstream> uut{0, std::istringstream{make_trace(300)}};
+
+  REQUIRE(std::size(read_ips(uut)) == 299);
+  REQUIRE_FALSE(uut.rewind());
+  champsim::max_buffered_trace_bytes = old_limit;
+}
+
+namespace {
+  // A stream that knows how large its data is before reading it, as a compressed file may
+  struct sized_istringstream : std::istringstream {
+    std::optional<uint64_t> hint;
+    sized_istringstream(std::string s, uint64_t h) : std::istringstream(std::move(s)), hint(h) {}
+    sized_istringstream(sized_istringstream&& other) : std::istringstream(std::move(other)), hint(other.hint) {}
+    std::optional<uint64_t> size_hint() const { return hint; }
+  };
+}
+
+TEST_CASE("A bulk_tracereader does not keep a trace that is known to be too large") {
+  auto old_limit = std::exchange(champsim::max_buffered_trace_bytes, 1000 * sizeof(input_instr));
+  auto trace = make_trace(300);
+  champsim::bulk_tracereader<input_instr, sized_istringstream> uut{0, sized_istringstream{trace, 2000 * sizeof(input_instr)}};
+
+  REQUIRE(std::size(read_ips(uut)) == 299);
+  REQUIRE_FALSE(uut.rewind());
+  champsim::max_buffered_trace_bytes = old_limit;
+}
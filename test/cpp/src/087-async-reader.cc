@@ -0,0 +1,65 @@
+#include <catch.hpp>
+
+#include "async_reader.h"
+#include "tracereader.h"
+
+namespace {
+  struct counting_bulk_generator {
+    uint64_t count = 0;
+    uint64_t length;
+
+    bool eof() const { return count >= length; }
+
+    ooo_model_instr operator()() {
+      ooo_model_instr retval{0, input_instr{}};
+      retval.ip = count++;
+      return retval;
+    }
+
+    ooo_model_instr* operator()(ooo_model_instr* first, ooo_model_instr* last) {
+      for (; first != last && !eof(); ++first)
+        *first = (*this)();
+      return first;
+    }
+  };
+
+  struct throwing_generator {
+    bool eof() const { return false; }
+    ooo_model_instr operator()() { throw std::runtime_error{"read failed"}; }
+    ooo_model_instr* operator()(ooo_model_instr*, ooo_model_instr*) { throw std::runtime_error{"read failed"}; }
+  };
+}
+
+TEST_CASE("An async_reader delivers every instruction in order") {
+  champsim::tracereader uut{champsim::async_reader<counting_bulk_generator>{uint64_t{0}, uint64_t{10000}}};
+  std::vector<ooo_model_instr> buffer(37, ooo_model_instr{0, input_instr{}});
+
+  uint64_t expected_ip = 0;
+  while (!uut.eof()) {
+    auto end = uut(std::data(buffer), std::data(buffer) + std::size(buffer));
+    for (auto it = std::data(buffer); it != end; ++it)
+      REQUIRE(it->ip == expected_ip++);
+  }
+
+  REQUIRE(expected_ip == 10000);
+}
+
+TEST_CASE("An async_reader fills a range completely unless the trace ends") {
+  champsim::tracereader uut{champsim::async_reader<counting_bulk_generator>{uint64_t{0}, uint64_t{1000}}};
+  std::vector<ooo_model_instr> buffer(600, ooo_model_instr{0, input_instr{}});
+
+  REQUIRE(uut(std::data(buffer), std::data(buffer) + std::size(buffer)) == std::data(buffer) + 600);
+  REQUIRE(uut(std::data(buffer), std::data(buffer) + std::size(buffer)) == std::data(buffer) + 400);
+  REQUIRE(uut.eof());
+}
+
+TEST_CASE("An async_reader can be destroyed before the trace ends") {
+  champsim::async_reader<counting_bulk_generator> uut{uint64_t{0}, std::numeric_limits<uint64_t>::max()};
+  REQUIRE(uut().ip == 0);
+}
+
+TEST_CASE("An async_reader reports errors from the background thread") {
+  champsim::async_reader<throwing_generator> uut{};
+  std::vector<ooo_model_instr> buffer(10, ooo_model_instr{0, input_instr{}});
+  REQUIRE_THROWS_AS(uut(std::data(buffer), std::data(buffer) + std::size(buffer)), std::runtime_error);
+}
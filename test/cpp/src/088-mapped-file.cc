@@ -0,0 +1,99 @@
+#include <catch.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <numeric>
+#include <stdexcept>
+#include <unistd.h>
+
+#include "mapped_file.h"
+#include "tracereader.h"
+
+namespace {
+  struct temporary_file {
+    std::string name = "/tmp/champsim-mapped-file-XXXXXX";
+    explicit temporary_file(const std::string& contents)
+    {
+      ::close(::mkstemp(std::data(name)));
+      std::ofstream{name, std::ios::binary} << contents;
+    }
+    ~temporary_file() { std::remove(name.c_str()); }
+  };
+}
+
+TEST_CASE("A mapped_file views the file in order") {
+  temporary_file file{"0123456789"};
+  champsim::mapped_file uut{file.name};
+
+  REQUIRE(uut.view(4) == "0123");
+  REQUIRE(uut.view(4) == "4567");
+  REQUIRE_FALSE(uut.eof());
+  REQUIRE(uut.view(4) == "89");
+  REQUIRE(uut.gcount() == 2);
+  REQUIRE(uut.eof());
+}
+
+TEST_CASE("A mapped_file reaches eof like an ifstream") {
+  temporary_file file{"01234567"};
+  champsim::mapped_file uut{file.name};
+  std::ifstream ref{file.name, std::ios::binary};
+
+  std::array<char, 4> buf, ref_buf;
+  for (int i = 0; i < 3; ++i) {
+    uut.read(std::data(buf), std::size(buf));
+    ref.read(std::data(ref_buf), std::size(ref_buf));
+    REQUIRE(uut.gcount() == ref.gcount());
+    REQUIRE(uut.eof() == ref.eof());
+    REQUIRE(std::string_view{std::data(buf), static_cast<std::size_t>(uut.gcount())} == std::string_view{std::data(ref_buf), static_cast<std::size_t>(ref.gcount())});
+  }
+}
+
+TEST_CASE("A mapped_file that cannot be opened is empty") {
+  champsim::mapped_file uut{"/nonexistent/trace"};
+  REQUIRE(std::empty(uut.view(4)));
+  REQUIRE(uut.eof());
+}
+
+TEST_CASE("A mapped_file of something other than a regular file is an error") {
+  REQUIRE_THROWS_AS(champsim::mapped_file{"/dev/null"}, std::runtime_error);
+}
+
+TEST_CASE("A bulk_tracereader reads the same instructions from a mapped_file as from an ifstream") {
+  std::vector<input_instr> trace(300);
+  for (std::size_t i = 0; i < std::size(trace); ++i) {
+    trace[i].ip = 0x1000 + 4 * i;
+    trace[i].is_branch = (i % 3 == 0);
+    trace[i].branch_taken = (i % 2 == 0);
+  }
+  temporary_file file{std::string{reinterpret_cast<const char*>(std::data(trace)), std::size(trace) * sizeof(input_instr)}};
+
+  champsim::bulk_tracereader<input_instr, champsim::mapped_file> uut{0, file.name};
+  champsim::bulk_tracereader<input_instr, std::ifstream> ref{0, file.name};
+
+  while (!ref.eof()) {
+    REQUIRE_FALSE(uut.eof());
+    auto uut_instr = uut();
+    auto ref_instr = ref();
+    REQUIRE(uut_instr.ip == ref_instr.ip);
+    REQUIRE(uut_instr.branch_target == ref_instr.branch_target);
+  }
+  REQUIRE(uut.eof());
+}
+
+TEST_CASE("A bulk_tracereader rewinds a mapped_file to its first instruction") {
+  std::vector<input_instr> trace(300);
+  for (std::size_t i = 0; i < std::size(trace); ++i)
+    trace[i].ip = 0x1000 + 4 * i;
+  temporary_file file{std::string{reinterpret_cast<const char*>(std::data(trace)), std::size(trace) * sizeof(input_instr)}};
+
+  champsim::bulk_tracereader<input_instr, champsim::mapped_file> uut{0, file.name, 10};
+  std::vector<ooo_model_instr> buffer(400, ooo_model_instr{0, input_instr{}});
+  auto end = uut(std::data(buffer), std::data(buffer) + std::size(buffer));
+  REQUIRE(std::distance(std::data(buffer), end) == 289);
+  REQUIRE(uut.eof());
+
+  REQUIRE(uut.rewind());
+  REQUIRE_FALSE(uut.eof());
+  REQUIRE(uut().ip == trace.at(10).ip);
+}
@@ -0,0 +1,114 @@
+#include <catch.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <numeric>
+#include <sstream>
+#include <unistd.h>
+
+#include "indexed_trace.h"
+#include "tracereader.h"
+
+namespace {
+  struct temporary_file {
+    std::string name = "/tmp/champsim-indexed-trace-XXXXXX";
+    temporary_file() { ::close(::mkstemp(std::data(name))); }
+    ~temporary_file() { std::remove(name.c_str()); }
+  };
+
+  std::vector<input_instr> make_trace(std::size_t length)
+  {
+    std::vector<input_instr> trace(length);
+    for (std::size_t i = 0; i < std::size(trace); ++i) {
+      trace[i].ip = 0x1000 + 4 * i;
+      trace[i].is_branch = (i % 3 == 0);
+      trace[i].branch_taken = (i % 2 == 0);
+    }
+    return trace;
+  }
+
+  void write_indexed(const std::string& name, const std::vector<input_instr>& trace, std::size_t block_size)
+  {
+    std::ofstream out{name, std::ios::binary};
+    champsim::indexed_trace_writer writer{out, block_size};
+    writer.write(reinterpret_cast<const char*>(std::data(trace)), static_cast<std::streamsize>(std::size(trace) * sizeof(input_instr)));
+  }
+}
+
+TEST_CASE("An indexed trace reads back the bytes that were written") {
+  temporary_file file;
+  std::string contents(1000, '\0');
+  std::iota(std::begin(contents), std::end(contents), 'a');
+  {
+    std::ofstream out{file.name, std::ios::binary};
+    champsim::indexed_trace_writer writer{out, 64};
+    writer.write(std::data(contents), 500);
+    writer.write(std::data(contents) + 500, 500);
+  }
+
+  champsim::indexed_trace_reader uut{file.name};
+  std::string result(1000, '\0');
+  uut.read(std::data(result), 1000);
+  REQUIRE(uut.gcount() == 1000);
+  REQUIRE_FALSE(uut.eof());
+  REQUIRE(result == contents);
+
+  uut.read(std::data(result), 1);
+  REQUIRE(uut.gcount() == 0);
+  REQUIRE(uut.eof());
+}
+
+TEST_CASE("An indexed trace seeks to any byte") {
+  temporary_file file;
+  std::string contents(1000, '\0');
+  std::iota(std::begin(contents), std::end(contents), 'a');
+  {
+    std::ofstream out{file.name, std::ios::binary};
+    champsim::indexed_trace_writer writer{out, 64};
+    writer.write(std::data(contents), static_cast<std::streamsize>(std::size(contents)));
+  }
+
+  champsim::indexed_trace_reader uut{file.name};
+  auto pos = GENERATE(as<uint64_t>{}, 0, 1, 63, 64, 65, 500, 959, 960, 999);
+  uut.seek(pos);
+
+  std::string result(100, '\0');
+  uut.read(std::data(result), 100);
+  auto expected_size = std::min<std::size_t>(100, 1000 - pos);
+  REQUIRE(uut.gcount() == static_cast<std::streamsize>(expected_size));
+  REQUIRE(result.substr(0, expected_size) == contents.substr(pos, expected_size));
+}
+
+TEST_CASE("A file that is not an indexed trace is rejected") {
+  temporary_file file;
+  std::ofstream{file.name, std::ios::binary} << std::string(100, 'x');
+  REQUIRE_THROWS(champsim::indexed_trace_reader{file.name});
+}
+
+TEST_CASE("A bulk_tracereader skips instructions in an indexed trace") {
+  temporary_file file;
+  auto trace = make_trace(1000);
+  write_indexed(file.name, trace, 10 * sizeof(input_instr) + 7); // blocks do not align with instructions
+
+  auto skip = GENERATE(as<uint64_t>{}, 0, 1, 10, 11, 500, 998);
+  champsim::bulk_tracereader<input_instr, champsim::indexed_trace_reader> uut{0, file.name, skip};
+
+  for (auto i = skip; i + 1 < std::size(trace); ++i) {
+    REQUIRE_FALSE(uut.eof());
+    auto instr = uut();
+    REQUIRE(instr.ip == trace[i].ip);
+  }
+  REQUIRE(uut.eof());
+}
+
+TEST_CASE("A bulk_tracereader skips instructions in a trace that cannot seek") {
+  temporary_file file;
+  auto trace = make_trace(1000);
+  std::ofstream{file.name, std::ios::binary}.write(reinterpret_cast<const char*>(std::data(trace)), static_cast<std::streamsize>(std::size(trace) * sizeof(input_instr)));
+
+  auto skip = GENERATE(as<uint64_t>{}, 0, 300, 998);
+  champsim::bulk_tracereader<input_instr, std::ifstream> uut{0, file.name, skip};
+
+  REQUIRE(uut().ip == trace[skip].ip);
+}
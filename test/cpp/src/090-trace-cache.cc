@@ -0,0 +1,76 @@
+#include <catch.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <unistd.h>
+
+#include "trace_cache.h"
+
+namespace {
+  struct temporary_directory {
+    std::string name = "/tmp/champsim-trace-cache-XXXXXX";
+    temporary_directory() { ::mkdtemp(std::data(name)); }
+    ~temporary_directory() { std::system(("rm -rf " + name).c_str()); }
+  };
+
+  std::string contents_of(const std::string& fname)
+  {
+    std::ifstream in{fname, std::ios::binary};
+    return {std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+  }
+}
+
+TEST_CASE("A trace is decompressed into the cache once") {
+  temporary_directory dir;
+  std::string trace_name = dir.name + "/trace.xz";
+  std::ofstream{trace_name} << "compressed";
+
+  champsim::trace_cache uut{dir.name};
+  int calls = 0;
+  auto decompress = [&calls](std::ostream& out) {
+    ++calls;
+    out << "decompressed";
+  };
+
+  auto first = uut.get(trace_name, decompress);
+  REQUIRE(first.has_value());
+  REQUIRE(contents_of(*first) == "decompressed");
+  REQUIRE(calls == 1);
+
+  auto second = champsim::trace_cache{dir.name}.get(trace_name, decompress);
+  REQUIRE(second == first);
+  REQUIRE(calls == 1);
+}
+
+TEST_CASE("A trace that changes is decompressed again") {
+  temporary_directory dir;
+  std::string trace_name = dir.name + "/trace.xz";
+  std::ofstream{trace_name} << "compressed";
+
+  champsim::trace_cache uut{dir.name};
+  auto before = uut.cached_name(trace_name);
+  std::ofstream{trace_name} << "compressed differently";
+  auto after = uut.cached_name(trace_name);
+
+  REQUIRE(before.has_value());
+  REQUIRE(after.has_value());
+  REQUIRE(before != after);
+}
+
+TEST_CASE("A trace that does not exist is not cached") {
+  temporary_directory dir;
+  champsim::trace_cache uut{dir.name};
+  REQUIRE_FALSE(uut.get(dir.name + "/missing.xz", [](std::ostream&) {}).has_value());
+}
+
+TEST_CASE("A cache that cannot be written is not used") {
+  temporary_directory dir;
+  std::string trace_name = dir.name + "/trace.xz";
+  std::ofstream{trace_name} << "compressed";
+
+  champsim::trace_cache uut{dir.name + "/nonexistent"};
+  REQUIRE_FALSE(uut.get(trace_name, [](std::ostream& out) { out << "decompressed"; }).has_value());
+}
@@ -0,0 +1,148 @@
+#include <catch.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+#include <vector>
+
+#include "compact_trace.h"
+#include "tracereader.h"
+
+namespace {
+  struct temporary_file {
+    std::string name = "/tmp/champsim-compact-trace-XXXXXX";
+    explicit temporary_file(const std::string& contents)
+    {
+      ::close(::mkstemp(std::data(name)));
+      std::ofstream{name, std::ios::binary} << contents;
+    }
+    ~temporary_file() { std::remove(name.c_str()); }
+  };
+
+  template <typename T>
+  std::vector<T> make_trace(std::size_t size)
+  {
+    std::vector<T> trace(size);
+    for (std::size_t i = 0; i < size; ++i) {
+      trace[i].ip = 0x400000 + 4 * i;
+      trace[i].is_branch = (i % 5 == 4);
+      trace[i].branch_taken = (i % 10 == 4);
+      trace[i].destination_registers[0] = static_cast<unsigned char>(1 + i % 7);
+      trace[i].source_registers[1] = static_cast<unsigned char>(2 + i % 3);
+      if (i % 3 == 0)
+        trace[i].source_memory[0] = 0x7fff0000 + 64 * i;
+      if (i % 4 == 0)
+        trace[i].destination_memory[0] = 0x10000000 - 8 * i;
+    }
+    return trace;
+  }
+
+  template <typename T>
+  std::string encode(const std::vector<T>& trace)
+  {
+    std::ostringstream out;
+    {
+      champsim::compact_trace_writer<T> writer{out};
+      for (const auto& instr : trace)
+        writer.write(instr);
+    }
+    return out.str();
+  }
+
+  template <typename T>
+  std::vector<T> decode(const std::string& fname)
+  {
+    champsim::compact_trace_reader<T, std::ifstream> reader{fname};
+    std::vector<T> result;
+    T instr;
+    while (!reader.read(reinterpret_cast<char*>(&instr), sizeof(T)).eof())
+      result.push_back(instr);
+    return result;
+  }
+
+  template <typename T>
+  bool same_records(const std::vector<T>& lhs, const std::vector<T>& rhs)
+  {
+    return std::size(lhs) == std::size(rhs) && std::memcmp(std::data(lhs), std::data(rhs), sizeof(T) * std::size(lhs)) == 0;
+  }
+}
+
+TEMPLATE_TEST_CASE("A compact trace decodes to the records it was written with", "", input_instr, cloudsuite_instr) {
+  auto trace = make_trace<TestType>(1000);
+  if constexpr (std::is_same_v<TestType, cloudsuite_instr>) {
+    for (auto& instr : trace) {
+      instr.asid[0] = 3;
+      instr.asid[1] = 5;
+    }
+  }
+
+  temporary_file file{encode(trace)};
+  REQUIRE(same_records(decode<TestType>(file.name), trace));
+}
+
+TEST_CASE("A compact trace is much smaller than the fixed-size records") {
+  auto trace = make_trace<input_instr>(1000);
+  REQUIRE(std::size(encode(trace)) * 4 < sizeof(input_instr) * std::size(trace));
+}
+
+TEST_CASE("A compact trace preserves records whose flags are not booleans") {
+  auto trace = make_trace<input_instr>(10);
+  trace[3].is_branch = 7;
+  trace[6].branch_taken = 255;
+
+  temporary_file file{encode(trace)};
+  REQUIRE(same_records(decode<input_instr>(file.name), trace));
+}
+
+TEST_CASE("A compact trace that ends partway through a record drops that record") {
+  auto trace = make_trace<input_instr>(100);
+  auto encoded = encode(trace);
+  encoded.pop_back();
+
+  temporary_file file{encoded};
+  auto result = decode<input_instr>(file.name);
+  trace.pop_back();
+  REQUIRE(same_records(result, trace));
+}
+
+TEST_CASE("A compact trace can be read in chunks that are not a multiple of the record size") {
+  auto trace = make_trace<input_instr>(1000);
+  temporary_file file{encode(trace)};
+
+  champsim::compact_trace_reader<input_instr, std::ifstream> reader{file.name};
+  std::vector<char> buffer(3 * sizeof(input_instr) + sizeof(input_instr) / 2);
+  std::string contents;
+  do {
+    reader.read(std::data(buffer), static_cast<std::streamsize>(std::size(buffer)));
+    contents.append(std::data(buffer), static_cast<std::size_t>(reader.gcount()));
+  } while (!reader.eof() && reader.gcount() > 0);
+
+  std::vector<input_instr> result(std::size(contents) / sizeof(input_instr));
+  std::memcpy(std::data(result), std::data(contents), std::size(contents));
+  REQUIRE(std::size(contents) == sizeof(input_instr) * std::size(trace));
+  REQUIRE(same_records(result, trace));
+}
+
+TEST_CASE("A compact trace reader rejects a file without the header") {
+  temporary_file file{std::string(sizeof(input_instr), '\0')};
+  REQUIRE_THROWS_AS((champsim::compact_trace_reader<input_instr, std::ifstream>{file.name}), std::runtime_error);
+}
+
+TEST_CASE("A compact trace reader rejects a trace of the other record type") {
+  temporary_file file{encode(make_trace<input_instr>(10))};
+  REQUIRE_THROWS_AS((champsim::compact_trace_reader<cloudsuite_instr, std::ifstream>{file.name}), std::runtime_error);
+}
+
+TEST_CASE("A bulk_tracereader reads a compact trace") {
+  auto trace = make_trace<input_instr>(100);
+  temporary_file file{encode(trace)};
+
+  champsim::bulk_tracereader<input_instr, champsim::compact_trace_reader<input_instr, std::ifstream>> uut{0, file.name};
+  for (std::size_t i = 0; i + 1 < std::size(trace); ++i) {
+    auto instr = uut();
+    REQUIRE(instr.ip == trace[i].ip);
+    REQUIRE(instr.is_branch == trace[i].is_branch);
+  }
+}
@@ -0,0 +1,178 @@
+#include <catch.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "compact_trace.h"
+#include "indexed_trace.h"
+#include "inf_stream.h"
+#include "trace_format.h"
+
+namespace {
+  struct temporary_file {
+    std::string name = "/tmp/champsim-trace-format-XXXXXX";
+    explicit temporary_file(const std::string& contents)
+    {
+      ::close(::mkstemp(std::data(name)));
+      std::ofstream{name, std::ios::binary} << contents;
+    }
+    ~temporary_file() { std::remove(name.c_str()); }
+  };
+
+  template <typename T>
+  std::vector<T> make_trace(std::size_t size)
+  {
+    std::vector<T> trace(size);
+    for (std::size_t i = 0; i < size; ++i) {
+      trace[i].ip = 0x400000 + 4 * i;
+      trace[i].is_branch = (i % 6 == 5);
+      trace[i].branch_taken = (i % 12 == 5);
+      trace[i].destination_registers[0] = 1;
+      trace[i].source_memory[0] = (i % 3 == 0) ? 0x7fff0000 + 64 * i : 0;
+    }
+    return trace;
+  }
+
+  template <typename T>
+  std::string as_bytes(const std::vector<T>& trace)
+  {
+    return std::string(reinterpret_cast<const char*>(std::data(trace)), sizeof(T) * std::size(trace));
+  }
+
+  template <typename T>
+  void require_same_ips(champsim::tracereader& uut, const std::vector<T>& trace)
+  {
+    for (std::size_t i = 0; i + 1 < std::size(trace); ++i)
+      REQUIRE(uut().ip == trace[i].ip);
+  }
+
+  struct counting_reader {
+    uint64_t ip = 0;
+    ooo_model_instr operator()()
+    {
+      input_instr instr{};
+      instr.ip = ++ip;
+      return ooo_model_instr{uint8_t{0}, instr};
+    }
+  };
+
+  champsim::trace_format_registration counting_format{champsim::trace_format{
+      "counting", [](const std::string& fname, std::string_view) { return fname.rfind("test-counting:", 0) == 0; },
+      [](const std::string&, const champsim::trace_options&) { return champsim::tracereader{counting_reader{}}; }}};
+}
+
+TEST_CASE("A compressed trace is recognized by its magic bytes") {
+  auto [magic, name] = GENERATE(table<std::string, std::string>({
+    {std::string{"\xFD" "7zXZ\0", 6}, "xz"},
+    {"\x1F\x8B", "gzip"},
+    {"BZh9", "bzip2"},
+    {"\x28\xB5\x2F\xFD", "zstd"}
+  }));
+
+  temporary_file file{magic + std::string(64, 'x')};
+  REQUIRE(champsim::find_trace_format(file.name).name == name);
+}
+
+TEST_CASE("An indexed trace is recognized by its footer") {
+  std::ostringstream out;
+  {
+    champsim::indexed_trace_writer writer{out, 64};
+    auto bytes = as_bytes(make_trace<input_instr>(10));
+    writer.write(std::data(bytes), static_cast<std::streamsize>(std::size(bytes)));
+  }
+
+  temporary_file file{out.str()};
+  REQUIRE(champsim::find_trace_format(file.name).name == "indexed");
+}
+
+TEST_CASE("A trace that no format claims is read uncompressed") {
+  temporary_file file{as_bytes(make_trace<input_instr>(10))};
+  REQUIRE(champsim::find_trace_format(file.name).name == "uncompressed");
+}
+
+TEST_CASE("A registered format claims the traces it matches") {
+  REQUIRE(champsim::find_trace_format("test-counting:anything").name == "counting");
+
+  auto uut = get_tracereader("test-counting:anything", 0, false, false);
+  REQUIRE(uut().ip == 1);
+  REQUIRE(uut().ip == 2);
+}
+
+TEST_CASE("An uncompressed trace holds standard records unless they are said to be cloudsuite records") {
+  // These records look more like cloudsuite records than standard ones, but their type is not guessed from their contents
+  auto trace = make_trace<cloudsuite_instr>(100);
+  temporary_file file{as_bytes(trace)};
+
+  SECTION("Standard records by default") {
+    std::vector<input_instr> as_standard(sizeof(cloudsuite_instr) * std::size(trace) / sizeof(input_instr));
+    std::memcpy(std::data(as_standard), std::data(trace), sizeof(input_instr) * std::size(as_standard));
+    auto uut = get_tracereader(file.name, 0, false, false);
+    require_same_ips(uut, as_standard);
+  }
+
+  SECTION("Cloudsuite records when given") {
+    auto uut = get_tracereader(file.name, 0, true, false);
+    require_same_ips(uut, trace);
+  }
+}
+
+TEST_CASE("A compact trace is detected without its suffix") {
+  auto trace = make_trace<cloudsuite_instr>(100);
+  std::ostringstream out;
+  {
+    champsim::compact_trace_writer<cloudsuite_instr> writer{out};
+    for (const auto& instr : trace)
+      writer.write(instr);
+  }
+
+  temporary_file file{out.str()};
+  auto uut = get_tracereader(file.name, 0, false, false);
+  require_same_ips(uut, trace);
+}
+
+TEST_CASE("A trace that is not a regular file is read as a stream") {
+  auto trace = make_trace<input_instr>(100);
+  std::string name = "/tmp/champsim-trace-format-XXXXXX";
+  ::close(::mkstemp(std::data(name)));
+  std::remove(name.c_str());
+  REQUIRE(::mkfifo(name.c_str(), 0600) == 0);
+
+  REQUIRE(champsim::find_trace_format(name).name == "uncompressed stream");
+
+  // The reader and the writer of a pipe each wait for the other to open it
+  std::thread writer{[&]() { std::ofstream{name, std::ios::binary} << as_bytes(trace); }};
+  {
+    auto uut = get_tracereader(name, 0, false, false);
+    require_same_ips(uut, trace);
+  }
+  writer.join();
+  std::remove(name.c_str());
+}
+
+TEST_CASE("A compressed trace that is not a regular file is decompressed according to its name") {
+  auto trace = make_trace<input_instr>(100);
+  std::string name = "/tmp/champsim-trace-format-XXXXXX";
+  ::close(::mkstemp(std::data(name)));
+  std::remove(name.c_str());
+  name += ".xz";
+  REQUIRE(::mkfifo(name.c_str(), 0600) == 0);
+
+  REQUIRE(champsim::find_trace_format(name).name == "xz stream");
+
+  std::thread writer{[&]() {
+    champsim::def_ostream<champsim::decomp_tags::lzma_tag_t<>> out{name};
+    out << as_bytes(trace);
+  }};
+  {
+    auto uut = get_tracereader(name, 0, false, false);
+    require_same_ips(uut, trace);
+  }
+  writer.join();
+  std::remove(name.c_str());
+}
@@ -0,0 +1,121 @@
+#include <catch.hpp>
+
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+#include "synthetic_trace.h"
+#include "tracereader.h"
+
+namespace {
+  std::vector<ooo_model_instr> generate(champsim::synthetic_trace& uut, std::size_t count)
+  {
+    std::vector<ooo_model_instr> result;
+    for (std::size_t i = 0; i < count; ++i)
+      result.push_back(uut());
+    return result;
+  }
+
+  std::vector<uint64_t> loaded_addresses(const std::vector<ooo_model_instr>& instrs)
+  {
+    std::vector<uint64_t> result;
+    for (const auto& instr : instrs) {
+      if (!std::empty(instr.source_memory))
+        result.push_back(instr.source_memory.front());
+    }
+    return result;
+  }
+}
+
+TEST_CASE("Sizes may have binary suffixes") {
+  REQUIRE(champsim::synthetic::parse_size("64") == 64);
+  REQUIRE(champsim::synthetic::parse_size("4K") == 4096);
+  REQUIRE(champsim::synthetic::parse_size("16m") == (uint64_t{16} << 20));
+  REQUIRE(champsim::synthetic::parse_size("1GB") == (uint64_t{1} << 30));
+  REQUIRE_THROWS_AS(champsim::synthetic::parse_size("1Q"), std::invalid_argument);
+  REQUIRE_THROWS_AS(champsim::synthetic::parse_size("G"), std::invalid_argument);
+  REQUIRE_THROWS_AS(champsim::synthetic::parse_size("99999999999999999999"), std::invalid_argument);
+  REQUIRE_THROWS_AS(champsim::synthetic::parse_size("16777216T"), std::invalid_argument);
+  REQUIRE(champsim::synthetic::parse_size("16777215T") == (uint64_t{16777215} << 40));
+}
+
+TEST_CASE("A synthetic workload is parsed from its name") {
+  auto params = champsim::synthetic::parse("gen:stream:stride=64:footprint=1G");
+  REQUIRE(params.kind == champsim::synthetic::workload::stream);
+  REQUIRE(params.stride == 64);
+  REQUIRE(params.footprint == (uint64_t{1} << 30));
+
+  REQUIRE(champsim::synthetic::parse("gen:stride").stride == 4096);
+  REQUIRE(champsim::synthetic::parse("gen:branch:mispredict=0.25").mispredict == 0.25);
+}
+
+TEST_CASE("A malformed synthetic workload is rejected") {
+  auto spec = GENERATE(as<std::string>{}, "gen", "gen:walk", "gen:stream:size=1K", "gen:stream:stride", "gen:stream:stride=0",
+                       "gen:branch:mispredict=2", "gen:branch:mispredict=1e999", "gen:branch:mispredict=0.5x", "gen:stream:footprint=99999999999999999999");
+  REQUIRE_THROWS_AS(champsim::synthetic::parse(spec), std::invalid_argument);
+}
+
+TEST_CASE("A stream workload loads each stride of its footprint in order") {
+  champsim::synthetic_trace uut{0, champsim::synthetic::parse("gen:stream:stride=64:footprint=256")};
+  auto addresses = loaded_addresses(generate(uut, 18));
+
+  REQUIRE(std::size(addresses) == 6);
+  for (std::size_t i = 1; i < std::size(addresses); ++i)
+    REQUIRE(addresses[i] == addresses[0] + 64 * (i % 4));
+}
+
+TEST_CASE("A chase workload visits each stride of its footprint once, with dependent loads") {
+  champsim::synthetic_trace uut{0, champsim::synthetic::parse("gen:chase:stride=64:footprint=4K:work=0")};
+  auto instrs = generate(uut, 2 * 64);
+  auto addresses = loaded_addresses(instrs);
+
+  REQUIRE(std::size(std::set<uint64_t>(std::begin(addresses), std::end(addresses))) == 64);
+  for (const auto& instr : instrs) {
+    if (!std::empty(instr.source_memory))
+      REQUIRE(instr.source_registers.front() == instr.destination_registers.front());
+  }
+}
+
+TEST_CASE("A random workload stays within its footprint, and is reproducible") {
+  champsim::synthetic_trace uut{0, champsim::synthetic::parse("gen:random:footprint=64K:seed=3")};
+  champsim::synthetic_trace same{0, champsim::synthetic::parse("gen:random:footprint=64K:seed=3")};
+  auto addresses = loaded_addresses(generate(uut, 3000));
+
+  REQUIRE(addresses == loaded_addresses(generate(same, 3000)));
+  auto [min, max] = std::minmax_element(std::begin(addresses), std::end(addresses));
+  REQUIRE(*max - *min < 64 * 1024);
+  REQUIRE(std::size(std::set<uint64_t>(std::begin(addresses), std::end(addresses))) > 500);
+}
+
+TEST_CASE("A branch workload goes against its bias at the given rate") {
+  champsim::synthetic_trace uut{0, champsim::synthetic::parse("gen:branch:mispredict=0.2")};
+  auto instrs = generate(uut, 40000);
+
+  std::size_t conditional = 0;
+  std::size_t not_taken = 0;
+  for (std::size_t i = 0; i + 1 < std::size(instrs); ++i) {
+    // The loop branch follows the conditional branch and the instruction that it skips
+    if (instrs[i].branch_type == BRANCH_CONDITIONAL && instrs[i].ip == instrs[0].ip + 4) {
+      ++conditional;
+      not_taken += instrs[i].branch_taken ? 0 : 1;
+    }
+
+    // Every branch target is the next instruction generated
+    auto next_ip = instrs[i].branch_taken ? instrs[i].branch_target : instrs[i].ip + 4;
+    REQUIRE(instrs[i + 1].ip == next_ip);
+  }
+
+  REQUIRE(conditional > 0);
+  auto rate = static_cast<double>(not_taken) / static_cast<double>(conditional);
+  REQUIRE(rate > 0.18);
+  REQUIRE(rate < 0.22);
+}
+
+TEST_CASE("A synthetic workload is read through get_tracereader") {
+  auto uut = get_tracereader("gen:stream:stride=64", 0, false, false);
+  auto first = uut();
+  REQUIRE(std::size(first.source_memory) == 1);
+  uut();
+  uut();
+  REQUIRE(uut().source_memory.front() == first.source_memory.front() + 64);
+}
@@ -131,3 +131,18 @@ SCENARIO("The scheduler can detect RAW hazards") {
   }
 }
 
+
+TEST_CASE("An instruction lists each of its register dependents") {
+  std::vector test_instructions( 3, champsim::test::instruction_with_registers(42) );
+  uint64_t id = 0;
+  for (auto &instr : test_instructions)
+    instr.instr_id = id++;
+
+  test_instructions.at(0).add_register_dependent(test_instructions.at(1));
+  test_instructions.at(0).add_register_dependent(test_instructions.at(2));
+
+  std::vector<uint64_t> dependent_ids;
+  test_instructions.at(0).for_each_register_dependent([&dependent_ids](const ooo_model_instr& x){ dependent_ids.push_back(x.instr_id); });
+  std::sort(std::begin(dependent_ids), std::end(dependent_ids));
+  REQUIRE_THAT(dependent_ids, Catch::Matchers::RangeEquals(std::vector<uint64_t>{1, 2}));
+}
@@ -0,0 +1,52 @@
+#include <catch.hpp>
+#include "mocks.hpp"
+#include "defaults.hpp"
+#include "ooo_cpu.h"
+#include "instr.h"
+
+SCENARIO("The oldest ready instructions are executed first") {
+  GIVEN("A ROB with more independent instructions than the execute width") {
+    constexpr unsigned execute_width = 2;
+
+    do_nothing_MRC mock_L1I, mock_L1D;
+    O3_CPU uut{O3_CPU::Builder{champsim::defaults::default_core}
+      .execute_width(execute_width)
+      .schedule_latency(0)
+      .execute_latency(100)
+      .fetch_queues(&mock_L1I.queues)
+      .data_queues(&mock_L1D.queues)
+    };
+
+    for (uint64_t id = 0; id < 5; ++id) {
+      uut.ROB.push_back(champsim::test::instruction_with_ip(id));
+      uut.ROB.back().instr_id = id;
+      uut.ROB.back().event_cycle = uut.current_cycle;
+    }
+
+    WHEN("The instructions are scheduled and then executed") {
+      for (int i = 0; i < 2; ++i) {
+        for (auto op : std::array<champsim::operable*,3>{{&uut, &mock_L1I, &mock_L1D}})
+          op->_operate();
+      }
+
+      THEN("Only the oldest instructions are executing") {
+        REQUIRE(uut.ROB.at(0).executed == INFLIGHT);
+        REQUIRE(uut.ROB.at(1).executed == INFLIGHT);
+        REQUIRE(uut.ROB.at(2).executed == 0);
+        REQUIRE(uut.ROB.at(3).executed == 0);
+        REQUIRE(uut.ROB.at(4).executed == 0);
+      }
+
+      AND_WHEN("Another cycle passes") {
+        for (auto op : std::array<champsim::operable*,3>{{&uut, &mock_L1I, &mock_L1D}})
+          op->_operate();
+
+        THEN("The next oldest instructions are executing") {
+          REQUIRE(uut.ROB.at(2).executed == INFLIGHT);
+          REQUIRE(uut.ROB.at(3).executed == INFLIGHT);
+          REQUIRE(uut.ROB.at(4).executed == 0);
+        }
+      }
+    }
+  }
+}
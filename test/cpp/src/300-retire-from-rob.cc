@@ -76,7 +76,7 @@ SCENARIO("Completed instructions are retired") {
 
     std::vector test_instructions( retire_bandwidth, champsim::test::instruction_with_ip(1) );
 
-    uut.ROB.insert(std::end(uut.ROB), std::begin(test_instructions), std::end(test_instructions));
+    std::copy(std::begin(test_instructions), std::end(test_instructions), std::back_inserter(uut.ROB));
 
     auto old_rob_occupancy = std::size(uut.ROB);
     auto old_num_retired = uut.num_retired;
@@ -119,7 +119,7 @@ SCENARIO("Completed instructions are retired") {
 
     std::vector test_instructions( 2*retire_bandwidth, champsim::test::instruction_with_ip(1) );
 
-    uut.ROB.insert(std::end(uut.ROB), std::begin(test_instructions), std::end(test_instructions));
+    std::copy(std::begin(test_instructions), std::end(test_instructions), std::back_inserter(uut.ROB));
 
     auto old_rob_occupancy = std::size(uut.ROB);
     auto old_num_retired = uut.num_retired;
@@ -0,0 +1,66 @@
+#include <catch.hpp>
+#include "mocks.hpp"
+#include "defaults.hpp"
+#include "cache.h"
+
+SCENARIO("A cache reports when it will next have work to do") {
+  GIVEN("An empty cache") {
+    constexpr uint64_t hit_latency = 7;
+    constexpr uint64_t lower_latency = 11;
+    do_nothing_MRC mock_ll{lower_latency};
+    to_rq_MRP mock_ul;
+    CACHE uut{CACHE::Builder{champsim::defaults::default_l1d}
+      .name("408-uut")
+      .upper_levels({&mock_ul.queues})
+      .lower_level(&mock_ll.queues)
+      .hit_latency(hit_latency)
+    };
+
+    std::array<champsim::operable*, 3> elements{{&uut, &mock_ll, &mock_ul}};
+
+    // Initialize the prefetching and replacement
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    THEN("The cache has no events") {
+      REQUIRE(uut.next_event_cycle() == std::numeric_limits<uint64_t>::max());
+    }
+
+    WHEN("A packet is issued") {
+      decltype(mock_ul)::request_type test;
+      test.address = 0xdeadbeef;
+      test.is_translated = true;
+      test.cpu = 0;
+      test.type = access_type::LOAD;
+
+      auto test_result = mock_ul.issue(test);
+      THEN("This issue is received") {
+        REQUIRE(test_result);
+      }
+
+      THEN("The cache has work on this cycle") {
+        REQUIRE(uut.next_event_cycle() == uut.current_cycle);
+      }
+
+      for (auto elem : elements)
+        elem->_operate();
+
+      THEN("The cache waits for the tag check") {
+        REQUIRE(uut.next_event_cycle() > uut.current_cycle);
+        REQUIRE(uut.next_event_cycle() <= uut.current_cycle + hit_latency);
+      }
+
+      for (uint64_t i = 0; i < hit_latency; ++i)
+        for (auto elem : elements)
+          elem->_operate();
+
+      THEN("The cache waits for the lower level after a miss") {
+        REQUIRE(std::size(mock_ll.addresses) == 1);
+        REQUIRE(uut.next_event_cycle() == std::numeric_limits<uint64_t>::max());
+      }
+    }
+  }
+}
@@ -0,0 +1,102 @@
+#include <catch.hpp>
+
+#include <vector>
+
+#include "champsim_constants.h"
+#include "dram_controller.h"
+
+namespace {
+  // The address of a block in the given bank and row, in the first channel and rank
+  uint64_t dram_address(uint64_t bank, uint64_t row)
+  {
+    auto bank_shift = champsim::lg2(DRAM_CHANNELS) + LOG2_BLOCK_SIZE;
+    auto row_shift = champsim::lg2(DRAM_RANKS) + champsim::lg2(DRAM_BANKS) + champsim::lg2(DRAM_COLUMNS) + bank_shift;
+    return (bank << bank_shift) | (row << row_shift);
+  }
+
+  champsim::channel::request_type make_request(uint64_t address)
+  {
+    champsim::channel::request_type request;
+    request.address = address;
+    request.v_address = address;
+    request.cpu = 0;
+    return request;
+  }
+
+  std::vector<uint64_t> returned_addresses(const champsim::channel& ul)
+  {
+    std::vector<uint64_t> result;
+    for (const auto& response : ul.returned)
+      result.push_back(response.address);
+    return result;
+  }
+}
+
+SCENARIO("The memory controller counts the requests in its queues") {
+  GIVEN("A memory controller with reads and writes to different banks") {
+    champsim::channel ul{};
+    MEMORY_CONTROLLER uut{1, 3200, 12.5, 12.5, 12.5, 7.5, {&ul}};
+    uut.warmup = false;
+    uut.begin_phase();
+
+    for (uint64_t bank = 0; bank < 4; ++bank)
+      REQUIRE(ul.add_rq(make_request(dram_address(bank, 1))));
+    for (uint64_t bank = 0; bank < 2; ++bank)
+      REQUIRE(ul.add_wq(make_request(dram_address(bank, 2))));
+
+    WHEN("The requests reach the memory controller") {
+      uut._operate();
+
+      THEN("Each queue counts its requests") {
+        REQUIRE(uut.channels[0].RQ_occupancy == 4);
+        REQUIRE(uut.channels[0].WQ_occupancy == 2);
+      }
+
+      AND_WHEN("A read of a queued write arrives") {
+        REQUIRE(ul.add_rq(make_request(dram_address(1, 2))));
+        uut._operate();
+
+        THEN("The read is returned from the write queue, and is not counted") {
+          REQUIRE(uut.channels[0].RQ_occupancy == 4);
+          REQUIRE(std::size(ul.returned) == 1);
+        }
+      }
+
+      AND_WHEN("The memory controller runs until it is idle") {
+        for (auto i = 0; i < 1000; ++i)
+          uut._operate();
+
+        THEN("Every read is returned, and the queues are empty") {
+          REQUIRE(std::size(ul.returned) == 4);
+          REQUIRE(uut.channels[0].RQ_occupancy == 0);
+          REQUIRE(uut.channels[0].WQ_occupancy == 0);
+          REQUIRE(uut.channels[0].unchecked_requests == 0);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("The memory controller schedules the oldest read first, across banks") {
+  GIVEN("A memory controller with a read in one bank") {
+    champsim::channel ul{};
+    MEMORY_CONTROLLER uut{1, 3200, 12.5, 12.5, 12.5, 7.5, {&ul}};
+    uut.warmup = false;
+    uut.begin_phase();
+
+    REQUIRE(ul.add_rq(make_request(dram_address(3, 1))));
+    uut._operate();
+
+    WHEN("Reads to lower-numbered banks arrive later") {
+      REQUIRE(ul.add_rq(make_request(dram_address(2, 1))));
+      REQUIRE(ul.add_rq(make_request(dram_address(1, 1))));
+
+      for (auto i = 0; i < 1000; ++i)
+        uut._operate();
+
+      THEN("The reads are returned in the order that they arrived") {
+        REQUIRE(returned_addresses(ul) == std::vector<uint64_t>{dram_address(3, 1), dram_address(2, 1), dram_address(1, 1)});
+      }
+    }
+  }
+}
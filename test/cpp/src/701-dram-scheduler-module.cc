@@ -0,0 +1,91 @@
+#include <catch.hpp>
+
+#include <vector>
+
+#include "champsim_constants.h"
+#include "dram_controller.h"
+
+namespace {
+  // The address of a block in the given bank, row, and column, in the first channel and rank
+  uint64_t dram_address(uint64_t bank, uint64_t row, uint64_t column = 0)
+  {
+    auto bank_shift = champsim::lg2(DRAM_CHANNELS) + LOG2_BLOCK_SIZE;
+    auto column_shift = champsim::lg2(DRAM_BANKS) + bank_shift;
+    auto row_shift = champsim::lg2(DRAM_RANKS) + champsim::lg2(DRAM_BANKS) + champsim::lg2(DRAM_COLUMNS) + bank_shift;
+    return (bank << bank_shift) | (column << column_shift) | (row << row_shift);
+  }
+
+  champsim::channel::request_type make_request(uint64_t address)
+  {
+    champsim::channel::request_type request;
+    request.address = address;
+    request.v_address = address;
+    request.cpu = 0;
+    return request;
+  }
+
+  std::vector<uint64_t> returned_addresses(const champsim::channel& ul)
+  {
+    std::vector<uint64_t> result;
+    for (const auto& response : ul.returned)
+      result.push_back(response.address);
+    return result;
+  }
+
+  // Open row 1 of bank 0, then queue a read that misses in that row before a read that hits in it
+  std::vector<uint64_t> row_conflict_order(MEMORY_CONTROLLER& uut, champsim::channel& ul)
+  {
+    uut.warmup = false;
+    uut.initialize();
+    uut.begin_phase();
+
+    ul.add_rq(make_request(dram_address(0, 1)));
+    uut._operate();
+
+    ul.add_rq(make_request(dram_address(0, 2)));
+    uut._operate();
+
+    ul.add_rq(make_request(dram_address(0, 1, 1)));
+    for (auto i = 0; i < 1000; ++i)
+      uut._operate();
+
+    return returned_addresses(ul);
+  }
+}
+
+SCENARIO("Without a scheduler module, the memory controller schedules the oldest request first") {
+  GIVEN("A memory controller built without a scheduler") {
+    champsim::channel ul{};
+    MEMORY_CONTROLLER uut{MEMORY_CONTROLLER::Builder{}.io_frequency(3200).tRP(12.5).tRCD(12.5).tCAS(12.5).turn_around_time(7.5).upper_levels({&ul})};
+
+    WHEN("A row miss arrives before a row hit in the same bank") {
+      auto returned = row_conflict_order(uut, ul);
+
+      THEN("The reads are returned in the order that they arrived") {
+        REQUIRE(returned == std::vector<uint64_t>{dram_address(0, 1), dram_address(0, 2), dram_address(0, 1, 1)});
+      }
+    }
+  }
+}
+
+SCENARIO("The FR-FCFS scheduler schedules row hits before older row misses") {
+  GIVEN("A memory controller with the FR-FCFS scheduler") {
+    champsim::channel ul{};
+    MEMORY_CONTROLLER uut{MEMORY_CONTROLLER::Builder{}
+                              .io_frequency(3200)
+                              .tRP(12.5)
+                              .tRCD(12.5)
+                              .tCAS(12.5)
+                              .turn_around_time(7.5)
+                              .scheduler<MEMORY_CONTROLLER::sdram_schedulerDfrfcfs>()
+                              .upper_levels({&ul})};
+
+    WHEN("A row miss arrives before a row hit in the same bank") {
+      auto returned = row_conflict_order(uut, ul);
+
+      THEN("The row hit is returned before the row miss") {
+        REQUIRE(returned == std::vector<uint64_t>{dram_address(0, 1), dram_address(0, 1, 1), dram_address(0, 2)});
+      }
+    }
+  }
+}
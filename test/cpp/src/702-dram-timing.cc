@@ -0,0 +1,252 @@
+#include <catch.hpp>
+
+#include <vector>
+
+#include "champsim_constants.h"
+#include "dram_controller.h"
+
+namespace {
+  // The address of a block in the given bank and row, in the first channel and rank
+  uint64_t dram_address(uint64_t bank, uint64_t row)
+  {
+    auto bank_shift = champsim::lg2(DRAM_CHANNELS) + LOG2_BLOCK_SIZE;
+    auto row_shift = champsim::lg2(DRAM_RANKS) + champsim::lg2(DRAM_BANKS) + champsim::lg2(DRAM_COLUMNS) + bank_shift;
+    return (bank << bank_shift) | (row << row_shift);
+  }
+
+  champsim::channel::request_type make_request(uint64_t address)
+  {
+    champsim::channel::request_type request;
+    request.address = address;
+    request.v_address = address;
+    request.cpu = 0;
+    return request;
+  }
+
+  MEMORY_CONTROLLER::Builder<> ddr_builder(champsim::channel& ul)
+  {
+    return MEMORY_CONTROLLER::Builder{}.io_frequency(3200).tRP(12.5).tRCD(12.5).tCAS(12.5).turn_around_time(7.5).upper_levels({&ul});
+  }
+
+  void run_idle(MEMORY_CONTROLLER& uut, uint64_t cycles)
+  {
+    uut.warmup = false;
+    for (uint64_t i = 0; i < cycles; ++i)
+      uut._operate();
+  }
+
+  // Issue the reads together, and give the cycle at which each is returned, in the order that they are returned
+  std::vector<uint64_t> completion_cycles(MEMORY_CONTROLLER& uut, champsim::channel& ul, const std::vector<uint64_t>& addresses)
+  {
+    uut.warmup = false;
+    for (auto address : addresses)
+      ul.add_rq(make_request(address));
+
+    std::vector<uint64_t> result;
+    for (auto i = 0; i < 20000 && std::size(result) < std::size(addresses); ++i) {
+      uut._operate();
+      while (std::size(result) < std::size(ul.returned))
+        result.push_back(uut.current_cycle);
+    }
+    return result;
+  }
+
+  std::vector<uint64_t> one_row_in_each_bank()
+  {
+    std::vector<uint64_t> result;
+    for (uint64_t bank = 0; bank < DRAM_BANKS; ++bank)
+      result.push_back(dram_address(bank, 1));
+    return result;
+  }
+}
+
+SCENARIO("The four-activation window limits the rate of row activations") {
+  static_assert(DRAM_BANKS >= 5);
+  constexpr uint64_t faw_cycles = 320; // 100 ns at 3200 MT/s
+
+  GIVEN("A memory controller without an activation window") {
+    champsim::channel ul{};
+    MEMORY_CONTROLLER uut{ddr_builder(ul)};
+
+    WHEN("Reads activate a row in each bank") {
+      auto completions = completion_cycles(uut, ul, one_row_in_each_bank());
+
+      THEN("The fifth read is not delayed by the window") {
+        REQUIRE(std::size(completions) == DRAM_BANKS);
+        REQUIRE(completions.at(4) - completions.at(0) < faw_cycles);
+      }
+    }
+  }
+
+  GIVEN("A memory controller with an activation window") {
+    champsim::channel ul{};
+    MEMORY_CONTROLLER uut{ddr_builder(ul).tFAW(100)};
+
+    WHEN("Reads activate a row in each bank") {
+      auto completions = completion_cycles(uut, ul, one_row_in_each_bank());
+
+      THEN("The fifth activation waits for the window of the first") {
+        REQUIRE(std::size(completions) == DRAM_BANKS);
+        REQUIRE(completions.at(4) - completions.at(0) >= faw_cycles);
+      }
+    }
+  }
+}
+
+SCENARIO("An activation is withdrawn when its request returns to the queue") {
+  constexpr uint64_t rrd_cycles = 320; // 100 ns at 3200 MT/s
+
+  GIVEN("A memory controller with activation spacing, and a read that has been given to its bank") {
+    champsim::channel ul{};
+    MEMORY_CONTROLLER uut{ddr_builder(ul).tRRD_S(100).tRRD_L(100)};
+    uut.warmup = false;
+    REQUIRE(ul.add_rq(make_request(dram_address(0, 1))));
+    uut._operate();
+    REQUIRE(uut.channels[0].bank_request[0].valid);
+
+    WHEN("Enough writes arrive to change the controller to write mode") {
+      for (uint64_t row = 0; row < DRAM_WQ_SIZE; ++row)
+        REQUIRE(ul.add_wq(make_request(dram_address(1, row + 2))));
+
+      auto start = uut.current_cycle;
+      for (uint64_t i = 0; i < 10 * rrd_cycles && (uut.current_cycle == start || uut.channels[0].WQ_occupancy == DRAM_WQ_SIZE); ++i)
+        uut._operate();
+
+      THEN("The first write does not wait for the activation of the read") {
+        REQUIRE(uut.current_cycle - start < rrd_cycles);
+      }
+    }
+  }
+}
+
+SCENARIO("Column accesses are spaced further apart within a bank group") {
+  static_assert(DRAM_BANKS % 4 == 0);
+  constexpr uint64_t ccd_l_cycles = 160; // 50 ns at 3200 MT/s
+
+  GIVEN("A memory controller with four bank groups") {
+    champsim::channel ul{};
+    MEMORY_CONTROLLER uut{ddr_builder(ul).bank_groups(4).tCCD_L(50)};
+
+    WHEN("Reads go to two banks of the same bank group") {
+      auto completions = completion_cycles(uut, ul, {dram_address(4, 1), dram_address(0, 1)});
+
+      THEN("The second read waits for the long spacing") {
+        REQUIRE(std::size(completions) == 2);
+        REQUIRE(completions.at(1) - completions.at(0) >= ccd_l_cycles);
+      }
+    }
+
+    WHEN("Reads go to banks of different bank groups") {
+      auto completions = completion_cycles(uut, ul, {dram_address(0, 1), dram_address(1, 1)});
+
+      THEN("The second read does not wait for the long spacing") {
+        REQUIRE(std::size(completions) == 2);
+        REQUIRE(completions.at(1) - completions.at(0) < ccd_l_cycles);
+      }
+    }
+  }
+}
+
+SCENARIO("A read waits for the writes before it to finish") {
+  constexpr uint64_t wtr_l_cycles = 320; // 100 ns at 3200 MT/s
+
+  auto write_then_read = [](MEMORY_CONTROLLER& uut, champsim::channel& ul) {
+    uut.warmup = false;
+    ul.add_wq(make_request(dram_address(0, 1)));
+    do {
+      uut._operate();
+    } while (uut.channels[0].WQ_occupancy > 0);
+
+    auto write_done = uut.current_cycle;
+    return completion_cycles(uut, ul, {dram_address(0, 1)}).at(0) - write_done;
+  };
+
+  GIVEN("A memory controller without write-to-read spacing") {
+    champsim::channel ul{};
+    MEMORY_CONTROLLER uut{ddr_builder(ul)};
+
+    THEN("A read after a write to its bank group is not delayed") {
+      REQUIRE(write_then_read(uut, ul) < wtr_l_cycles);
+    }
+  }
+
+  GIVEN("A memory controller with write-to-read spacing") {
+    champsim::channel ul{};
+    MEMORY_CONTROLLER uut{ddr_builder(ul).tWTR_L(100)};
+
+    THEN("A read after a write to its bank group waits for the spacing") {
+      REQUIRE(write_then_read(uut, ul) >= wtr_l_cycles);
+    }
+  }
+}
+
+SCENARIO("Refreshes block the banks that they target") {
+  constexpr uint64_t refi_cycles = 3200; // 1000 ns at 3200 MT/s
+  constexpr uint64_t rfc_cycles = 1600;  // 500 ns at 3200 MT/s
+
+  GIVEN("A memory controller with all-bank refresh") {
+    champsim::channel ul{};
+    MEMORY_CONTROLLER uut{ddr_builder(ul).tREFI(1000).tRFC(500)};
+    uut.begin_phase();
+
+    WHEN("A read arrives after the refresh begins") {
+      run_idle(uut, refi_cycles + 100);
+      auto completions = completion_cycles(uut, ul, {dram_address(1, 1)});
+
+      THEN("The read waits for the refresh to finish") {
+        REQUIRE(std::size(completions) == 1);
+        REQUIRE(completions.at(0) >= refi_cycles + rfc_cycles);
+        REQUIRE(uut.channels[0].sim_stats.REFRESHES == 1);
+      }
+    }
+  }
+
+  GIVEN("A memory controller with same-bank refresh") {
+    static_assert(DRAM_BANKS == 8);
+    champsim::channel ul{};
+    MEMORY_CONTROLLER uut{ddr_builder(ul).bank_groups(4).tREFI(1000).tRFCsb(500).set_same_bank_refresh()};
+    uut.begin_phase();
+
+    // Each refresh targets one bank of each of the four bank groups, so the first begins after half of the refresh interval
+    WHEN("Reads arrive after the first refresh begins") {
+      run_idle(uut, refi_cycles / 2 + 100);
+      auto completions = completion_cycles(uut, ul, {dram_address(4, 1), dram_address(0, 1)});
+
+      THEN("Only the read to a refreshed bank waits for the refresh") {
+        REQUIRE(std::size(completions) == 2);
+        REQUIRE(completions.at(0) < refi_cycles / 2 + rfc_cycles);
+        REQUIRE(completions.at(1) >= refi_cycles / 2 + rfc_cycles);
+        REQUIRE(ul.returned.front().address == dram_address(4, 1));
+      }
+    }
+  }
+}
+
+SCENARIO("An idle rank is powered down") {
+  constexpr uint64_t xp_cycles = 160; // 50 ns at 3200 MT/s
+
+  auto read_after_idle = [](MEMORY_CONTROLLER& uut, champsim::channel& ul) {
+    uut.begin_phase();
+    run_idle(uut, 1000);
+    auto start = uut.current_cycle;
+    return completion_cycles(uut, ul, {dram_address(0, 1)}).at(0) - start;
+  };
+
+  GIVEN("Two memory controllers, with and without power-down") {
+    champsim::channel ul{};
+    MEMORY_CONTROLLER uut{ddr_builder(ul).power_down_threshold(100).tXP(50)};
+    champsim::channel always_on_ul{};
+    MEMORY_CONTROLLER always_on{ddr_builder(always_on_ul)};
+
+    WHEN("A read arrives after the ranks have been idle") {
+      auto latency = read_after_idle(uut, ul);
+      auto always_on_latency = read_after_idle(always_on, always_on_ul);
+
+      THEN("The read waits for the rank to exit power-down") {
+        REQUIRE(latency >= always_on_latency + xp_cycles);
+        REQUIRE(uut.channels[0].sim_stats.POWER_DOWN_CYCLES > 0);
+        REQUIRE(always_on.channels[0].sim_stats.POWER_DOWN_CYCLES == 0);
+      }
+    }
+  }
+}
@@ -456,6 +456,49 @@ class NormalizeConfigTest(unittest.TestCase):
                 cores, caches, ptws, pmem, vmem = config.parse.normalize_config({ k: '__test__' })
                 self.assertEqual(cores[0].get(k), '__test__')
 
+class PhysicalMemoryPresetTests(unittest.TestCase):
+
+    def setUp(self):
+        self.cores = [{
+                'name': 'test_cpu', 'L1I': 'test_L1I', 'L1D': 'test_L1D',
+                'ITLB': 'test_ITLB', 'DTLB': 'test_DTLB', 'PTW': 'test_PTW',
+                '_index': 0
+            }]
+        self.caches = {
+                'test_L1I': { 'name': 'test_L1I', 'lower_level': 'DRAM' },
+                'test_L1D': { 'name': 'test_L1D', 'lower_level': 'DRAM' },
+                'test_ITLB': { 'name': 'test_ITLB', 'lower_level': 'test_PTW' },
+                'test_DTLB': { 'name': 'test_DTLB', 'lower_level': 'test_PTW' }
+            }
+        self.ptws = {
+                'test_PTW': { 'name': 'test_PTW', 'lower_level': 'test_L1D' }
+            }
+
+    def parse_pmem(self, pmem):
+        result = config.parse.parse_normalized(self.cores, self.caches, self.ptws, pmem, {}, {}, PassthroughContext(), PassthroughContext(), PassthroughContext(), PassthroughContext(), False)
+        return result[0]['pmem']
+
+    def test_preset_fills_timings(self):
+        pmem = self.parse_pmem({ 'preset': 'DDR5-4800' })
+        self.assertEqual(pmem['io_freq'], 4800)
+        self.assertEqual(pmem['bank_groups'], 8)
+        self.assertEqual(pmem['tFAW'], config.parse.pmem_presets['DDR5-4800']['tFAW'])
+        self.assertEqual(pmem['refresh'], 'same_bank')
+
+    def test_given_values_override_preset(self):
+        pmem = self.parse_pmem({ 'preset': 'DDR5-4800', 'tCAS': 20, 'refresh': 'all_bank' })
+        self.assertEqual(pmem['tCAS'], 20)
+        self.assertEqual(pmem['refresh'], 'all_bank')
+
+    def test_no_preset_has_no_extended_timings(self):
+        pmem = self.parse_pmem({})
+        self.assertNotIn('tFAW', pmem)
+        self.assertNotIn('tREFI', pmem)
+
+    def test_unknown_preset_is_rejected(self):
+        with self.assertRaises(ValueError):
+            self.parse_pmem({ 'preset': 'DDR7' })
+
 class EnvironmentParseTests(unittest.TestCase):
 
     def setUp(self):
@@ -0,0 +1,87 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "compact_trace.h"
+#include "inf_stream.h"
+
+// Encode each record of the decompressed input into the compact trace
+template <typename T, typename S>
+void convert(S&& in, std::ostream& out_file)
+{
+  champsim::compact_trace_writer<T> out{out_file};
+  std::array<char, 1024 * sizeof(T)> buf;
+  do {
+    in.read(std::data(buf), std::size(buf));
+    for (std::size_t i = 0; i + sizeof(T) <= static_cast<std::size_t>(in.gcount()); i += sizeof(T)) {
+      T instr;
+      std::memcpy(&instr, std::data(buf) + i, sizeof(T));
+      out.write(instr);
+    }
+  } while (!in.eof());
+}
+
+template <typename T>
+void convert_file(const std::string& in_name, std::ostream& out)
+{
+  auto ends_with = [&in_name](std::string suffix) {
+    return std::size(in_name) >= std::size(suffix) && in_name.compare(std::size(in_name) - std::size(suffix), std::size(suffix), suffix) == 0;
+  };
+  if (ends_with("xz"))
+    convert<T>(champsim::inf_istream<champsim::decomp_tags::lzma_tag_t<>>{in_name}, out);
+  else if (ends_with("gz"))
+    convert<T>(champsim::inf_istream<champsim::decomp_tags::gzip_tag_t<>>{in_name}, out);
+  else if (ends_with("bz2"))
+    convert<T>(champsim::inf_istream<champsim::decomp_tags::bzip2_tag_t>{in_name}, out);
+  else if (ends_with("zst"))
+    convert<T>(champsim::inf_istream<champsim::decomp_tags::zstd_tag_t<>>{in_name}, out);
+  else
+    convert<T>(std::ifstream{in_name, std::ios::binary}, out);
+}
+
+int main(int argc, char** argv)
+{
+  bool cloudsuite = (argc == 4 && std::strcmp(argv[1], "-c") == 0);
+  if (argc != 3 && !cloudsuite) {
+    std::cerr << "Usage: " << argv[0] << " [-c] INPUT_TRACE OUTPUT_TRACE.cst\n";
+    std::cerr << "The input may be compressed with xz, gzip, bzip2, or zstd, according to its extension. Use -c for cloudsuite traces.\n";
+    return 1;
+  }
+
+  std::string in_name{argv[argc - 2]};
+  if (!std::ifstream{in_name, std::ios::binary}.is_open()) {
+    std::cerr << "Could not open the input trace " << in_name << "\n";
+    return 1;
+  }
+
+  std::ofstream out_file{argv[argc - 1], std::ios::binary};
+  if (!out_file.is_open()) {
+    std::cerr << "Could not open the output trace " << argv[argc - 1] << "\n";
+    return 1;
+  }
+
+  if (cloudsuite)
+    convert_file<cloudsuite_instr>(in_name, out_file);
+  else
+    convert_file<input_instr>(in_name, out_file);
+
+  return out_file.good() ? 0 : 1;
+}
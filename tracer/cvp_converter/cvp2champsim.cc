@@ -16,25 +16,33 @@
 
 #include <algorithm>
 #include <assert.h>
+#include <atomic>
+#include <condition_variable>
 #include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iostream>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
 
+#include "../../inc/compact_trace.h"
+#include "../../inc/indexed_trace.h"
+#include "../../inc/inf_stream.h"
 #include "../../inc/trace_instruction.h"
+#include "../../inc/util/spsc_queue.h"
 
-// defines for the paths for the various decompression programs and Apple/Linux differences
+// Apple/Linux differences
 
 #ifdef __APPLE__
-#define XZ_PATH "/opt/local/bin/xz"
-#define GZIP_PATH "/usr/bin/gzip"
-#define CAT_PATH "/bin/cat"
 #define UINT64 uint64_t
 #else
-#define XZ_PATH "/usr/bin/xz"
-#define GZIP_PATH "/bin/gzip"
-#define CAT_PATH "/bin/cat"
 #define UINT64 unsigned long long int
 #endif
 
@@ -43,6 +51,184 @@ bool verbose = false;
 // use non-cloudsuite ChampSim trace format
 using trace_instr_format = input_instr;
 
+// an indexed trace, written to a file through a std::ostream so that it can be written like any other output
+class indexed_ostream : public std::ostream
+{
+  struct writer_buf : public std::streambuf {
+    champsim::indexed_trace_writer* writer;
+    explicit writer_buf(champsim::indexed_trace_writer* w) : writer(w) {}
+    std::streamsize xsputn(const char* s, std::streamsize count) override
+    {
+      writer->write(s, count);
+      return count;
+    }
+    int_type overflow(int_type ch) override
+    {
+      if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+        char c = traits_type::to_char_type(ch);
+        writer->write(&c, 1);
+      }
+      return traits_type::not_eof(ch);
+    }
+  };
+
+  std::ofstream file;
+  champsim::indexed_trace_writer writer{file};
+  writer_buf buffer{&writer};
+
+public:
+  explicit indexed_ostream(const std::string& fname) : std::ostream(nullptr), file(fname, std::ios::binary) { this->rdbuf(&buffer); }
+  ~indexed_ostream() override { writer.finish(); }
+  bool is_open() const { return file.is_open(); }
+};
+
+// open the output file, compressing it according to its extension
+std::unique_ptr<std::ostream> open_output(const std::string& fname)
+{
+  auto ends_with = [&fname](std::string_view suffix) {
+    return std::size(fname) >= std::size(suffix) && fname.compare(std::size(fname) - std::size(suffix), std::size(suffix), suffix) == 0;
+  };
+
+  std::unique_ptr<std::ostream> result;
+  bool opened = false;
+  if (ends_with(".xzi")) {
+    auto out = std::make_unique<indexed_ostream>(fname);
+    opened = out->is_open();
+    result = std::move(out);
+  } else if (ends_with(".xz")) {
+    auto out = std::make_unique<champsim::def_ostream<champsim::decomp_tags::lzma_tag_t<>>>(std::ofstream{fname, std::ios::binary});
+    opened = out->get_underlying().is_open();
+    result = std::move(out);
+  } else if (ends_with(".gz")) {
+    auto out = std::make_unique<champsim::def_ostream<champsim::decomp_tags::gzip_tag_t<>>>(std::ofstream{fname, std::ios::binary});
+    opened = out->get_underlying().is_open();
+    result = std::move(out);
+  } else if (ends_with(".bz2")) {
+    auto out = std::make_unique<champsim::def_ostream<champsim::decomp_tags::bzip2_tag_t>>(std::ofstream{fname, std::ios::binary});
+    opened = out->get_underlying().is_open();
+    result = std::move(out);
+  } else if (ends_with(".zst")) {
+    auto out = std::make_unique<champsim::def_ostream<champsim::decomp_tags::zstd_tag_t<>>>(std::ofstream{fname, std::ios::binary});
+    opened = out->get_underlying().is_open();
+    result = std::move(out);
+  } else {
+    auto out = std::make_unique<std::ofstream>(fname, std::ios::binary);
+    opened = out->is_open();
+    result = std::move(out);
+  }
+
+  if (!opened) {
+    perror(fname.c_str());
+    exit(1);
+  }
+  return result;
+}
+
+// writes the converted instructions on a thread of its own, so that compressing them overlaps with parsing and converting the input
+class trace_writer
+{
+  static constexpr std::size_t batch_size = 4096;
+
+  std::unique_ptr<std::ostream> file;
+  std::ostream* out = &std::cout;
+  std::unique_ptr<champsim::compact_trace_writer<trace_instr_format>> compact;
+
+  champsim::spsc_queue<std::vector<trace_instr_format>> queue{16};
+  std::vector<trace_instr_format> batch;
+  std::atomic<bool> done{false};
+  std::thread thread;
+
+  // each thread sleeps on this while the other is behind, and is signalled when a batch is pushed or popped
+  std::mutex mutex;
+  std::condition_variable changed;
+
+  void notify()
+  {
+    { std::lock_guard lock{mutex}; } // order the notification after a thread that is about to wait
+    changed.notify_one();
+  }
+
+  void write_batch(const std::vector<trace_instr_format>& instrs)
+  {
+    if (compact) {
+      for (const auto& instr : instrs)
+        compact->write(instr);
+    } else {
+      out->write(reinterpret_cast<const char*>(std::data(instrs)), static_cast<std::streamsize>(sizeof(trace_instr_format) * std::size(instrs)));
+    }
+  }
+
+  void run()
+  {
+    std::vector<trace_instr_format> instrs;
+    for (;;) {
+      // load done before popping, so that no batch pushed before done was set is missed
+      bool finished = done.load(std::memory_order_acquire);
+      if (queue.pop(&instrs, 1) != &instrs) {
+        notify();
+        write_batch(instrs);
+      } else if (finished) {
+        return;
+      } else {
+        // the conversion is behind, sleep until it pushes more instructions
+        std::unique_lock lock{mutex};
+        changed.wait(lock, [this]() { return done.load(std::memory_order_acquire) || !queue.empty(); });
+      }
+    }
+  }
+
+  void push(std::vector<trace_instr_format>&& instrs)
+  {
+    auto end = std::make_move_iterator(&instrs + 1);
+    while (queue.push(std::make_move_iterator(&instrs), end) != end) {
+      // the writer is behind, sleep until it makes room
+      std::unique_lock lock{mutex};
+      changed.wait(lock, [this]() { return std::size(queue) < queue.capacity(); });
+    }
+    notify();
+  }
+
+public:
+  // write to the named file, or to standard output if the name is empty
+  trace_writer(const std::string& fname, bool is_compact)
+  {
+    if (!std::empty(fname)) {
+      file = open_output(fname);
+      out = file.get();
+    }
+    if (is_compact)
+      compact = std::make_unique<champsim::compact_trace_writer<trace_instr_format>>(*out);
+    batch.reserve(batch_size);
+    thread = std::thread{&trace_writer::run, this};
+  }
+
+  ~trace_writer()
+  {
+    if (!std::empty(batch))
+      push(std::move(batch));
+    done.store(true, std::memory_order_release);
+    notify();
+    thread.join();
+    compact.reset();
+    file.reset();
+    std::cout.flush();
+  }
+
+  void write(const trace_instr_format& instr)
+  {
+    batch.push_back(instr);
+    if (std::size(batch) == batch_size) {
+      push(std::move(batch));
+      batch.clear();
+      batch.reserve(batch_size);
+    }
+  }
+};
+
+std::unique_ptr<trace_writer> output;
+
+void write_instr(const trace_instr_format& ct) { output->write(ct); }
+
 // orginal instruction types from CVP-1 traces
 
 typedef enum {
@@ -95,6 +281,96 @@ const char* branch_names[] = {
 
 long long int counts[OPTYPE_MAX];
 
+// the raw bytes of a CVP-1 trace, decompressed in this process if the file is compressed
+
+class trace_source
+{
+  std::function<std::size_t(char*, std::size_t)> read_;
+  std::vector<char> buffer_ = std::vector<char>(std::size_t{1} << 20);
+  std::size_t pos_ = 0, end_ = 0;
+
+  template <typename S>
+  void read_from(std::shared_ptr<S> in)
+  {
+    read_ = [in](char* s, std::size_t count) {
+      in->read(s, static_cast<std::streamsize>(count));
+      return static_cast<std::size_t>(in->gcount());
+    };
+  }
+
+public:
+  explicit trace_source(const std::string& fname)
+  {
+    // read from standard input?
+    if (fname == "-") {
+      fprintf(stderr, "reading from standard input\n");
+      fflush(stderr);
+      read_ = [](char* s, std::size_t count) {
+        std::cin.read(s, static_cast<std::streamsize>(count));
+        return static_cast<std::size_t>(std::cin.gcount());
+      };
+      return;
+    }
+
+    // see what kind of file this is by reading the magic number
+    unsigned char s[6] = {};
+    {
+      std::ifstream magic_tester{fname, std::ios::binary};
+      if (!magic_tester) {
+        perror(fname.c_str());
+        exit(1);
+      }
+      magic_tester.read(reinterpret_cast<char*>(s), sizeof(s));
+    }
+
+    if (s[0] == 0xfd && s[1] == '7' && s[2] == 'z' && s[3] == 'X' && s[4] == 'Z' && s[5] == 0) {
+      fprintf(stderr, "opening xz file \"%s\"\n", fname.c_str());
+      read_from(std::make_shared<champsim::inf_istream<champsim::decomp_tags::lzma_tag_t<>>>(fname));
+    } else if (s[0] == 0x1f && s[1] == 0x8b) {
+      fprintf(stderr, "opening gz file \"%s\"\n", fname.c_str());
+      read_from(std::make_shared<champsim::inf_istream<champsim::decomp_tags::gzip_tag_t<>>>(fname));
+    } else if (s[0] == 'B' && s[1] == 'Z' && s[2] == 'h') {
+      fprintf(stderr, "opening bz2 file \"%s\"\n", fname.c_str());
+      read_from(std::make_shared<champsim::inf_istream<champsim::decomp_tags::bzip2_tag_t>>(fname));
+    } else if (s[0] == 0x28 && s[1] == 0xb5 && s[2] == 0x2f && s[3] == 0xfd) {
+      fprintf(stderr, "opening zst file \"%s\"\n", fname.c_str());
+      read_from(std::make_shared<champsim::inf_istream<champsim::decomp_tags::zstd_tag_t<>>>(fname));
+    } else {
+      // no magic number? maybe it's uncompressed?
+      fprintf(stderr, "opening file \"%s\"\n", fname.c_str());
+      read_from(std::make_shared<std::ifstream>(fname, std::ios::binary));
+    }
+    fflush(stderr);
+  }
+
+  // copy the next bytes of the trace, return false if the trace ends first
+  bool get(void* dest, std::size_t count)
+  {
+    auto out = static_cast<char*>(dest);
+    while (count > 0) {
+      if (pos_ == end_) {
+        pos_ = 0;
+        end_ = read_(std::data(buffer_), std::size(buffer_));
+        if (end_ == 0)
+          return false;
+      }
+      auto n = std::min(count, end_ - pos_);
+      std::copy_n(std::next(std::data(buffer_), static_cast<std::ptrdiff_t>(pos_)), n, out);
+      pos_ += n;
+      out += n;
+      count -= n;
+    }
+    return true;
+  }
+
+  // copy a field in the middle of a record, which must be present
+  void get_field(void* dest, std::size_t count)
+  {
+    [[maybe_unused]] bool good = get(dest, count);
+    assert(good);
+  }
+};
+
 // one record from the CVP-1 trace file format
 
 struct trace {
@@ -106,14 +382,11 @@ struct trace {
       taken, // branch was taken
       num_input_regs, num_output_regs, input_reg_names[256], output_reg_names[256];
 
-  // output register values could be up to 128 bits each
-  UINT64 output_reg_values[256][2];
-
   InstClass type; // instruction type
 
   // read a single record from the trace file, return true on success, false on EOF
 
-  bool read(FILE* f)
+  bool read(trace_source& f)
   {
 
     // initialize
@@ -127,17 +400,12 @@ struct trace {
 
     // get the PC
 
-    int n;
-    n = fread(&PC, 8, 1, f);
-    if (!n)
+    if (!f.get(&PC, 8))
       return false;
-    if (feof(f))
-      return false;
-    assert(n == 1);
 
     // get the instruction type
 
-    assert(fread(&type, 1, 1, f) == 1);
+    f.get_field(&type, 1);
 
     // base on the type, read in different stuff
 
@@ -146,8 +414,8 @@ struct trace {
     case storeInstClass:
       // load or store? get the effective address and access size
 
-      assert(fread(&EA, 8, 1, f) == 1);
-      assert(fread(&access_size, 1, 1, f) == 1);
+      f.get_field(&EA, 8);
+      f.get_field(&access_size, 1);
       break;
     case condBranchInstClass:
     case uncondDirectBranchInstClass:
@@ -155,9 +423,9 @@ struct trace {
 
       // branch? get "taken" and the target
 
-      assert(fread(&taken, 1, 1, f) == 1);
+      f.get_field(&taken, 1);
       if (taken) {
-        assert(fread(&target, 8, 1, f) == 1);
+        f.get_field(&target, 8);
       } else {
         // if not taken, default target is fallthru, i.e. PC+4
         target = PC + 4;
@@ -173,28 +441,28 @@ struct trace {
 
     // get the number of input registers and their names
 
-    assert(fread(&num_input_regs, 1, 1, f) == 1);
+    f.get_field(&num_input_regs, 1);
     for (int i = 0; i < num_input_regs; i++) {
-      assert(fread(&input_reg_names[i], 1, 1, f) == 1);
+      f.get_field(&input_reg_names[i], 1);
     }
 
     // get the number of output registers and their names
 
-    assert(fread(&num_output_regs, 1, 1, f) == 1);
+    f.get_field(&num_output_regs, 1);
     for (int i = 0; i < num_output_regs; i++) {
-      assert(fread(&output_reg_names[i], 1, 1, f) == 1);
+      f.get_field(&output_reg_names[i], 1);
     }
 
-    // read the output registers
+    // skip the output register values, which could be up to 128 bits each
 
-    memset(output_reg_values, 0, sizeof(output_reg_values));
+    UINT64 output_reg_value[2];
     for (int i = 0; i < num_output_regs; i++) {
       if (output_reg_names[i] <= 31 || output_reg_names[i] == 64) {
         // scalars or flags?
-        assert(fread(&output_reg_values[i][0], 8, 1, f) == 1);
+        f.get_field(output_reg_value, 8);
       } else if (output_reg_names[i] >= 32 && output_reg_names[i] < 64) {
         // SIMD values?
-        assert(fread(&output_reg_values[i][0], 16, 1, f) == 1);
+        f.get_field(output_reg_value, 16);
       } else
         assert(0);
     }
@@ -215,90 +483,107 @@ UINT64 bump_page = 0x1000;
 
 // this string will contain the trace file name, or "-" if we want to read from standard input
 
-char tracefilename[1000];
+std::string tracefilename = "-";
 
 namespace
 {
 constexpr char REG_AX = 56;
 }
 
-auto open_trace_file(void)
-{
-  // read from standard input?
-  if (!strcmp(tracefilename, "-")) {
-    fprintf(stderr, "reading from standard input\n");
-    fflush(stderr);
-    return stdin;
-  }
+// parses the records of a trace on a thread of its own, so that decompressing and parsing the input overlaps with the conversion
 
-  // see what kind of file this is by reading the magic number
-  auto magic_tester = fopen(tracefilename, "r");
-  if (!magic_tester) {
-    perror(tracefilename);
-    exit(1);
-  }
-
-  // read six bytes from the beginning of the file
-  unsigned char s[6];
-  int n = fread(s, 1, 6, magic_tester);
-  fclose(magic_tester);
-  assert(n == 6);
-
-  constexpr auto cmd_size = 5 + std::max({sizeof(XZ_PATH), sizeof(GZIP_PATH), sizeof(CAT_PATH)}) + sizeof(tracefilename);
-  char cmd[cmd_size];
-
-  // is this the magic number for XZ compression?
-  if (s[0] == 0xfd && s[1] == '7' && s[2] == 'z' && s[3] == 'X' && s[4] == 'Z' && s[5] == 0) {
+class parsed_trace
+{
+  static constexpr std::size_t batch_size = 1024;
 
-    // it is an XZ file or doing a good impression of one
+  champsim::spsc_queue<std::vector<trace>> queue_{16};
+  std::atomic<bool> done_{false};
+  std::atomic<bool> stop_{false};
+  std::vector<trace> batch_;
+  std::size_t batch_pos_ = 0;
 
-    fprintf(stderr, "opening xz file \"%s\"\n", tracefilename);
-    fflush(stderr);
+  // each thread sleeps on this while the other is behind, and is signalled when a batch is pushed or popped
+  std::mutex mutex_;
+  std::condition_variable changed_;
 
-    // start up an xz decompression and open a pipe to our standard input
-
-    sprintf(cmd, "%s -dc %s", XZ_PATH, tracefilename);
+  void notify()
+  {
+    { std::lock_guard lock{mutex_}; } // order the notification after a thread that is about to wait
+    changed_.notify_one();
   }
 
-  // check for the magic number for GZIP compression
-  else if (s[0] == 0x1f && s[1] == 0x8b) {
-    // it is a GZ file
-    fprintf(stderr, "opening gz file \"%s\"\n", tracefilename);
-    fflush(stderr);
-
-    // open a pipe to a gzip decompression process
+  std::thread thread_; // declared last, so that it starts after the members that it uses
 
-    sprintf(cmd, "%s -dc %s", GZIP_PATH, tracefilename);
-  } else {
-    // no magic number? maybe it's uncompressed?
-    fprintf(stderr, "opening file \"%s\"\n", tracefilename);
-    fflush(stderr);
+  void run(std::string fname)
+  {
+    trace_source f{fname};
+    bool good = true;
+    while (good && !stop_.load(std::memory_order_relaxed)) {
+      std::vector<trace> records(batch_size);
+      auto it = std::begin(records);
+      while (it != std::end(records) && (good = it->read(f)))
+        ++it;
+      records.erase(it, std::end(records));
+
+      auto end = std::make_move_iterator(&records + 1);
+      if (!std::empty(records)) {
+        while (queue_.push(std::make_move_iterator(&records), end) != end) {
+          // the conversion is behind, sleep until it makes room
+          std::unique_lock lock{mutex_};
+          changed_.wait(lock, [this]() { return stop_.load(std::memory_order_relaxed) || std::size(queue_) < queue_.capacity(); });
+          if (stop_.load(std::memory_order_relaxed))
+            break;
+        }
+        notify();
+      }
+    }
+    done_.store(true, std::memory_order_release);
+    notify();
+  }
 
-    // use Unix cat to open and read this file. we could just fopen the file
-    // but then we're pclosing it later so that could get weird
+public:
+  explicit parsed_trace(const std::string& fname) : thread_(&parsed_trace::run, this, fname) {}
 
-    sprintf(cmd, "%s %s", CAT_PATH, tracefilename);
+  ~parsed_trace()
+  {
+    stop_.store(true, std::memory_order_relaxed);
+    notify();
+    thread_.join();
   }
 
-  auto f = popen(cmd, "r");
-  if (f)
-    return f;
-
-  perror(cmd);
-  return f;
-}
+  // the next record of the trace, return true on success, false on EOF, when the record is cleared as trace::read clears it
+  bool read(trace& t)
+  {
+    while (batch_pos_ == std::size(batch_)) {
+      // load done before popping, so that no batch pushed before done was set is missed
+      bool finished = done_.load(std::memory_order_acquire);
+      if (queue_.pop(&batch_, 1) != &batch_) {
+        batch_pos_ = 0;
+        notify();
+      } else if (finished) {
+        t = trace{};
+        t.type = undefInstClass;
+        return false;
+      } else {
+        // the parser is behind, sleep until it pushes more records
+        std::unique_lock lock{mutex_};
+        changed_.wait(lock, [this]() { return done_.load(std::memory_order_acquire) || !queue_.empty(); });
+      }
+    }
+    t = batch_[batch_pos_++];
+    return true;
+  }
+};
 
 void preprocess_file(void)
 {
   trace t;
   fprintf(stderr, "preprocessing to find code and data pages...\n");
   fflush(stderr);
-  FILE* f = open_trace_file();
-  if (!f)
-    return;
+  parsed_trace records{tracefilename};
   int count = 0;
   for (;;) {
-    bool good = t.read(f);
+    bool good = records.read(t);
     if (!good)
       break;
     code_pages[t.PC >> 12] = true;
@@ -314,7 +599,6 @@ void preprocess_file(void)
       }
     }
   }
-  pclose(f);
   fprintf(stderr, "%ld code pages, %ld data pages\n", code_pages.size(), data_pages.size());
   fflush(stderr);
 }
@@ -352,30 +636,36 @@ int main(int argc, char** argv)
 {
   trace t;
 
-  // for fun we will keep a register file up to date
-
-  UINT64 registers[256][2];
-  memset(registers, 0, sizeof(registers));
-
-  // defaults to reading from standard input
+  // defaults to reading from standard input and writing to standard output, and to compressing with every processor
 
-  strcpy(tracefilename, "-");
+  std::string output_name;
+  bool compact = false;
+  champsim::decomp_tags::lzma_threads = 0;
 
   for (int i = 1; i < argc; i++) {
     if (!strcmp(argv[i], "-v"))
       verbose = true;
+    else if (!strcmp(argv[i], "-c"))
+      compact = true;
+    else if (!strcmp(argv[i], "-o") && i + 1 < argc)
+      output_name = argv[++i];
+    else if (!strcmp(argv[i], "-t") && i + 1 < argc)
+      champsim::decomp_tags::lzma_threads = static_cast<uint32_t>(atoi(argv[++i]));
     else
-      strcpy(tracefilename, argv[i]);
+      tracefilename = argv[i];
+  }
+
+  if (compact && std::size(output_name) >= 4 && output_name.compare(std::size(output_name) - 4, 4, ".xzi") == 0) {
+    fprintf(stderr, "a compact trace cannot be indexed\n");
+    return 1;
   }
 
   preprocess_file();
 
-  // open the trace file
+  // open the trace file, and the output
 
-  FILE* f = open_trace_file();
-
-  if (!f)
-    return 1;
+  parsed_trace records{tracefilename};
+  output = std::make_unique<trace_writer>(output_name, compact);
 
   // number of records read so far
   long long int n = 0;
@@ -399,7 +689,7 @@ int main(int argc, char** argv)
 
     // read a record from the trace file
 
-    bool good = t.read(f);
+    bool good = records.read(t);
     if (t.PC == oldt.PC) {
       fprintf(stderr, "hmm, that's weird\n");
     }
@@ -410,7 +700,7 @@ int main(int argc, char** argv)
 
     if (!good)
       break;
-    trace_instr_format ct;
+    trace_instr_format ct{};
     ct.ip = t.PC;
     ct.is_branch = false;
     // we are going to figure out the op type
@@ -518,7 +808,7 @@ int main(int argc, char** argv)
       default:
         assert(0);
       }
-      fwrite(&ct, sizeof(ct), 1, stdout); // write a branch trace
+      write_instr(ct); // write a branch trace
     } else {
       memset(ct.destination_registers, 0, sizeof(ct.destination_registers));
       memset(ct.source_registers, 0, sizeof(ct.source_registers));
@@ -572,17 +862,10 @@ int main(int argc, char** argv)
         case undefInstClass:
           assert(0);
         }
-        fwrite(&ct, sizeof(ct), 1, stdout); // write a non-branch trace
+        write_instr(ct); // write a non-branch trace
       }
     }
 
-    // for fun, update the register values
-
-    for (int i = 0; i < t.num_output_regs; i++) {
-      int x = t.output_reg_names[i];
-      registers[x][0] = t.output_reg_values[x][0];
-      registers[x][1] = t.output_reg_values[x][1];
-    }
     if (verbose) {
       static long long int n = 0;
       fprintf(stderr, "%lld %llx ", ++n, t.PC);
@@ -621,9 +904,8 @@ int main(int argc, char** argv)
       fprintf(stderr, "%s %lld %f%%\n", branch_names[i], counts[i], 100 * counts[i] / (double)n);
   }
 
-  // close the pipe, if any
+  // finish writing the output
 
-  if (f != stdin)
-    pclose(f);
+  output.reset();
   return 0;
 }
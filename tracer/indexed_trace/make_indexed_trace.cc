@@ -0,0 +1,79 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <array>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "indexed_trace.h"
+#include "inf_stream.h"
+
+// Copy the decompressed contents of the input into the indexed trace
+template <typename S>
+void convert(S&& in, champsim::indexed_trace_writer& out)
+{
+  std::array<char, 1 << 16> buf;
+  for (in.read(std::data(buf), std::size(buf)); in.gcount() > 0; in.read(std::data(buf), std::size(buf)))
+    out.write(std::data(buf), in.gcount());
+}
+
+int main(int argc, char** argv)
+{
+  if (argc < 3 || argc > 4) {
+    std::cerr << "Usage: " << argv[0] << " INPUT_TRACE OUTPUT_TRACE.xzi [BLOCK_SIZE]\n";
+    std::cerr << "The input may be compressed with xz, gzip, bzip2, or zstd, according to its extension.\n";
+    return 1;
+  }
+
+  std::string in_name{argv[1]};
+  std::size_t block_size = (argc == 4) ? std::strtoull(argv[3], nullptr, 10) : champsim::indexed_trace::default_block_size;
+  if (block_size == 0) {
+    std::cerr << "The block size must be positive\n";
+    return 1;
+  }
+
+  if (!std::ifstream{in_name, std::ios::binary}.is_open()) {
+    std::cerr << "Could not open the input trace " << in_name << "\n";
+    return 1;
+  }
+
+  std::ofstream out_file{argv[2], std::ios::binary};
+  if (!out_file.is_open()) {
+    std::cerr << "Could not open the output trace " << argv[2] << "\n";
+    return 1;
+  }
+
+  champsim::indexed_trace_writer out{out_file, block_size};
+
+  auto ends_with = [&in_name](std::string suffix) {
+    return std::size(in_name) >= std::size(suffix) && in_name.compare(std::size(in_name) - std::size(suffix), std::size(suffix), suffix) == 0;
+  };
+  if (ends_with("xz"))
+    convert(champsim::inf_istream<champsim::decomp_tags::lzma_tag_t<>>{in_name}, out);
+  else if (ends_with("gz"))
+    convert(champsim::inf_istream<champsim::decomp_tags::gzip_tag_t<>>{in_name}, out);
+  else if (ends_with("bz2"))
+    convert(champsim::inf_istream<champsim::decomp_tags::bzip2_tag_t>{in_name}, out);
+  else if (ends_with("zst"))
+    convert(champsim::inf_istream<champsim::decomp_tags::zstd_tag_t<>>{in_name}, out);
+  else
+    convert(std::ifstream{in_name, std::ios::binary}, out);
+
+  out.finish();
+  return out_file.good() ? 0 : 1;
+}
@@ -21,10 +21,12 @@
 
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <stdlib.h>
 #include <string.h>
 #include <string>
 
+#include "../../inc/compact_trace.h"
 #include "../../inc/trace_instruction.h"
 #include "pin.H"
 
@@ -37,6 +39,7 @@ using trace_instr_format_t = input_instr;
 UINT64 instrCount = 0;
 
 std::ofstream outfile;
+std::unique_ptr<champsim::compact_trace_writer<trace_instr_format_t>> compact_outfile;
 
 trace_instr_format_t curr_instr;
 
@@ -49,6 +52,8 @@ KNOB<UINT64> KnobSkipInstructions(KNOB_MODE_WRITEONCE, "pintool", "s", "0", "How
 
 KNOB<UINT64> KnobTraceInstructions(KNOB_MODE_WRITEONCE, "pintool", "t", "1000000", "How many instructions to trace");
 
+KNOB<BOOL> KnobCompact(KNOB_MODE_WRITEONCE, "pintool", "c", "0", "Write the trace in the compact format");
+
 /* ===================================================================== */
 // Utilities
 /* ===================================================================== */
@@ -62,6 +67,7 @@ INT32 Usage()
             << "Specify the output trace file with -o" << std::endl
             << "Specify the number of instructions to skip before tracing with -s" << std::endl
             << "Specify the number of instructions to trace with -t" << std::endl
+            << "Write the trace in the compact format with -c 1" << std::endl
             << std::endl;
 
   std::cerr << KNOB_BASE::StringKnobSummary() << std::endl;
@@ -87,6 +93,11 @@ BOOL ShouldWrite()
 
 void WriteCurrentInstruction()
 {
+  if (compact_outfile) {
+    compact_outfile->write(curr_instr);
+    return;
+  }
+
   typename decltype(outfile)::char_type buf[sizeof(trace_instr_format_t)];
   std::memcpy(buf, &curr_instr, sizeof(trace_instr_format_t));
   outfile.write(buf, sizeof(trace_instr_format_t));
@@ -161,7 +172,11 @@ VOID Instruction(INS ins, VOID* v)
  * @param[in]   v               value specified by the tool in the
  *                              PIN_AddFiniFunction function call
  */
-VOID Fini(INT32 code, VOID* v) { outfile.close(); }
+VOID Fini(INT32 code, VOID* v)
+{
+  compact_outfile.reset();
+  outfile.close();
+}
 
 /*!
  * The main procedure of the tool.
@@ -183,6 +198,9 @@ int main(int argc, char* argv[])
     exit(1);
   }
 
+  if (KnobCompact.Value())
+    compact_outfile.reset(new champsim::compact_trace_writer<trace_instr_format_t>(outfile));
+
   // Register function to be called to instrument instructions
   INS_AddInstrumentFunction(Instruction, 0);
 